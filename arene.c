@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arene.h"
+
+// Alignement des objets alloués dans une arène
+#define ALIGNEMENT_ARENE 16
+
+/**
+* Alloue un bloc et le place en tête de la chaine des blocs d'une arène
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int ajouter_bloc(arene a, size_t taille) {
+  struct bloc_arene_s *b = (struct bloc_arene_s*) malloc(
+                             sizeof(struct bloc_arene_s) + taille);
+  if(!b) return 0;
+  b->precedent = a->courant;
+  b->taille = taille;
+  b->utilise = 0;
+  a->courant = b;
+  a->nb_blocs++;
+  return 1;
+}
+
+arene init_arene(size_t taille_bloc) {
+  arene a = (arene) malloc(sizeof(struct arene_s));
+  if(!a) {
+    perror("Erreur d'allocation de la mémoire de l'arène.\n");
+    return NULL;
+  }
+  a->courant = NULL;
+  a->nb_blocs = 0;
+  a->total = 0;
+  if(!ajouter_bloc(a, taille_bloc ? taille_bloc : TAILLE_BLOC_ARENE)) {
+    perror("Erreur d'allocation de la mémoire de l'arène.\n");
+    free(a);
+    return NULL;
+  }
+  return a;
+}
+
+void* arene_allouer(arene a, size_t taille) {
+  taille = (taille + ALIGNEMENT_ARENE - 1) & ~(size_t) (ALIGNEMENT_ARENE - 1);
+  struct bloc_arene_s *b = a->courant;
+  if(b->taille - b->utilise < taille) {
+    // Les blocs doublent de taille : une arène de n octets n'a que
+    // O(log n) blocs
+    size_t nouvelle = b->taille * 2;
+    while(nouvelle < taille) nouvelle *= 2;
+    if(!ajouter_bloc(a, nouvelle)) return NULL;
+    b = a->courant;
+  }
+  void *objet = b->octets + b->utilise;
+  b->utilise += taille;
+  a->total += taille;
+  return objet;
+}
+
+char* arene_copier_chaine(arene a, const char *chaine, size_t longueur) {
+  char *copie = (char*) arene_allouer(a, longueur + 1);
+  if(!copie) return NULL;
+  memcpy(copie, chaine, longueur);
+  copie[longueur] = '\0';
+  return copie;
+}
+
+void free_arene(arene a) {
+  if(!a) return;
+  struct bloc_arene_s *b = a->courant;
+  while(b) {
+    struct bloc_arene_s *precedent = b->precedent;
+    free(b);
+    b = precedent;
+  }
+  free(a);
+}
@@ -0,0 +1,74 @@
+#ifndef _arene_h_
+#define _arene_h_
+
+#include <stddef.h>
+
+// Taille du premier bloc d'une arène par défaut, en octets
+#define TAILLE_BLOC_ARENE (64 * 1024)
+
+/**
+* Bloc d'une arène : les blocs sont chainés du plus récent au plus
+* ancien, chacun deux fois plus grand que le précédent.
+* precedent -> le bloc alloué avant celui-ci, NULL pour le premier
+* taille -> le nombre d'octets utilisables du bloc
+* utilise -> le nombre d'octets déjà alloués dans le bloc
+* octets -> la mémoire du bloc
+*/
+struct bloc_arene_s {
+  struct bloc_arene_s *precedent;
+  size_t taille;
+  size_t utilise;
+  _Alignas(16) unsigned char octets[];
+};
+
+/**
+* Arène d'allocation : les objets sont découpés à la suite les uns des
+* autres dans de grands blocs, sans libération individuelle. Tout ce qui
+* a été alloué dans une arène est libéré en une fois, quel que soit le
+* nombre d'objets (free_arene()). Une arène n'est pas protégée contre
+* les accès concurrents.
+* courant -> le bloc où se font les allocations
+* nb_blocs -> le nombre de blocs alloués
+* total -> le nombre d'octets alloués dans l'arène
+*/
+struct arene_s {
+  struct bloc_arene_s *courant;
+  int nb_blocs;
+  size_t total;
+};
+typedef struct arene_s* arene;
+
+/**
+* Crée une arène vide
+* @param taille_bloc : la taille du premier bloc, en octets
+* @return l'arène, NULL en cas d'erreur d'allocation
+*/
+arene init_arene(size_t taille_bloc);
+
+/**
+* Alloue un objet dans une arène. Un nouveau bloc est alloué si le bloc
+* courant est plein.
+* @param a : l'arène
+* @param taille : la taille de l'objet, en octets
+* @return l'objet (aligné sur 16 octets, non initialisé), NULL en cas
+*         d'erreur d'allocation
+*/
+void* arene_allouer(arene a, size_t taille);
+
+/**
+* Copie une chaine dans une arène
+* @param a : l'arène
+* @param chaine : la chaine à copier (pas forcément terminée par '\0')
+* @param longueur : la longueur de la chaine
+* @return la copie, terminée par '\0', NULL en cas d'erreur d'allocation
+*/
+char* arene_copier_chaine(arene a, const char *chaine, size_t longueur);
+
+/**
+* Libère une arène et tous les objets qui y ont été alloués
+* @param a : l'arène à désallouer
+*/
+void free_arene(arene a);
+
+
+#endif
@@ -0,0 +1,87 @@
+#include "balayage.h"
+#include "table_transitions.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BALAYAGE_X86
+#endif
+
+/**
+* Parcours case par case
+*/
+static long balayer_scalaire(const cellule *cases, long n, int sens,
+                             const unsigned char *symboles, int nb) {
+  for(long i = 0; i < n; i++) {
+    cellule c = cases[sens * i];
+    int j = 0;
+    while(j < nb && symboles[j] != c) j++;
+    if(j == nb) return i;
+  }
+  return n;
+}
+
+#ifdef BALAYAGE_X86
+
+/**
+* Parcours par blocs de 16 cases (SSE2) : chaque bloc est comparé à
+* chacun des symboles, et movemask donne un bit par case ; le premier
+* bit nul (le dernier en sens -1) est la première case d'un autre
+* symbole
+*/
+__attribute__((target("sse2")))
+static long balayer_sse2(const cellule *cases, long n, int sens,
+                         const unsigned char *symboles, int nb) {
+  __m128i cibles[MAX_SYMBOLES_RECHERCHE];
+  for(int j = 0; j < nb; j++) cibles[j] = _mm_set1_epi8((char) symboles[j]);
+  long i = 0;
+  for(; i + 16 <= n; i += 16) {
+    // En sens -1, le bloc est celui des cases [-i-15, -i]
+    const cellule *bloc = sens > 0 ? cases + i : cases - i - 15;
+    __m128i v = _mm_loadu_si128((const __m128i*) bloc);
+    __m128i egal = _mm_cmpeq_epi8(v, cibles[0]);
+    for(int j = 1; j < nb; j++)
+      egal = _mm_or_si128(egal, _mm_cmpeq_epi8(v, cibles[j]));
+    unsigned autres = ~(unsigned) _mm_movemask_epi8(egal) & 0xFFFFu;
+    if(autres)
+      return i + (sens > 0 ? __builtin_ctz(autres)
+                           : 15 - (31 - __builtin_clz(autres)));
+  }
+  return i + balayer_scalaire(cases + sens * i, n - i, sens, symboles, nb);
+}
+
+/**
+* Parcours par blocs de 32 cases (AVX2), même principe que SSE2
+*/
+__attribute__((target("avx2")))
+static long balayer_avx2(const cellule *cases, long n, int sens,
+                         const unsigned char *symboles, int nb) {
+  __m256i cibles[MAX_SYMBOLES_RECHERCHE];
+  for(int j = 0; j < nb; j++)
+    cibles[j] = _mm256_set1_epi8((char) symboles[j]);
+  long i = 0;
+  for(; i + 32 <= n; i += 32) {
+    const cellule *bloc = sens > 0 ? cases + i : cases - i - 31;
+    __m256i v = _mm256_loadu_si256((const __m256i*) bloc);
+    __m256i egal = _mm256_cmpeq_epi8(v, cibles[0]);
+    for(int j = 1; j < nb; j++)
+      egal = _mm256_or_si256(egal, _mm256_cmpeq_epi8(v, cibles[j]));
+    unsigned autres = ~(unsigned) _mm256_movemask_epi8(egal);
+    if(autres)
+      return i + (sens > 0 ? __builtin_ctz(autres)
+                           : 31 - (31 - __builtin_clz(autres)));
+  }
+  return i + balayer_sse2(cases + sens * i, n - i, sens, symboles, nb);
+}
+
+#endif
+
+long balayer(const cellule *cases, long n, int sens,
+             const unsigned char *symboles, int nb) {
+#ifdef BALAYAGE_X86
+  if(__builtin_cpu_supports("avx2"))
+    return balayer_avx2(cases, n, sens, symboles, nb);
+  if(__builtin_cpu_supports("sse2"))
+    return balayer_sse2(cases, n, sens, symboles, nb);
+#endif
+  return balayer_scalaire(cases, n, sens, symboles, nb);
+}
@@ -0,0 +1,28 @@
+#ifndef _balayage_h_
+#define _balayage_h_
+
+#include "ruban.h"
+
+/**
+* Compte les cases consécutives d'un ruban qui contiennent l'un des 
+* symboles donnés, à partir d'une case et dans une direction donnée, 
+* i.e. la distance jusqu'à la première case d'un autre symbole. Le 
+* parcours est vectorisé (comparaison de 16 ou 32 cases à la fois, AVX2
+* ou SSE2 selon le processeur, détecté à l'exécution), avec un parcours
+* case par case sur les autres architectures.
+* @param cases : la première case
+* @param n : le nombre maximal de cases à parcourir
+* @param sens : la direction du parcours, +1 (cases, cases+1, ...) ou -1
+*               (cases, cases-1, ...)
+* @param symboles : les symboles recherchés
+* @param nb : le nombre de symboles recherchés, au plus 
+*             MAX_SYMBOLES_RECHERCHE
+* @return le nombre de cases parcourues avant la première case d'un 
+*         autre symbole, n si toutes les cases contiennent l'un des 
+*         symboles
+*/
+long balayer(const cellule *cases, long n, int sens, 
+             const unsigned char *symboles, int nb);
+
+
+#endif
@@ -0,0 +1,371 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "machineturing.h"
+#include "macro.h"
+#include "natif.h"
+#include "threade.h"
+#include "bits.h"
+#include "rle.h"
+
+/**
+* Banc d'essai du simulateur : des charges fixes (machines générées avec
+* une graine fixe, mots d'entrée fixes) exécutées chacune dans un
+* processus fils, pour que la mémoire maximale mesurée soit celle de la
+* charge. Chaque charge est répétée et la meilleure durée est gardée.
+* Les résultats sont écrits sur la sortie standard, un objet JSON par
+* ligne.
+* Usage : ./bench_mt [-r REPETITIONS] [-m MOTEUR,MOTEUR,...]
+*/
+
+// Nombre de répétitions par défaut de chaque charge
+#define REPETITIONS_DEFAUT 3
+// Moteurs mesurés par défaut sur les charges d'exécution
+#define MOTEURS_DEFAUT "table,threade,macro,natif,bits,rle"
+// Nombre d'états de la machine générée pour l'analyse (5 transitions
+// par état)
+#define ETATS_ANALYSE 100000
+// Nombre d'états de la machine {a,b,c,d} générée pour la conversion
+#define ETATS_CONVERSION 40000
+// Longueur du palindrome donné à binary_palindrome (~n²/2 étapes)
+#define LONGUEUR_PALINDROME 8000
+// Longueur du nombre 11...1 donné à ajout_1_a_nb_binaire
+#define LONGUEUR_AJOUT 4000000
+// Nombre d'étapes du champion du castor affairé à 5 états
+#define ETAPES_CASTOR 47176870
+
+/**
+* Charge d'exécution : une machine du dépôt exécutée sur un mot
+* nom -> le nom de la charge
+* machine / alphabets / symbole_blanc -> la machine et ses paramètres
+* mot -> le mot d'entrée
+* max_etapes -> la limite d'étapes, 0 pour ne pas limiter
+*/
+struct charge_s {
+  const char *nom;
+  const char *machine;
+  const char *alphabets;
+  char symbole_blanc;
+  char *mot;
+  long max_etapes;
+};
+
+/**
+* Générateur pseudo-aléatoire (xorshift64) à graine fixe, pour que les
+* machines générées soient les mêmes d'une exécution à l'autre
+*/
+static uint64_t aleatoire(uint64_t *graine) {
+  *graine ^= *graine << 13;
+  *graine ^= *graine >> 7;
+  *graine ^= *graine << 17;
+  return *graine;
+}
+
+/**
+* Écrit une machine aléatoire de nb_etats états sur l'alphabet abcd : 
+* une transition par état et par symbole (symbole blanc compris), vers
+* un état et avec un symbole écrit et un mouvement tirés au hasard
+* @param blanc : le symbole blanc de la machine
+* @return la taille du fichier écrit, -1 en cas d'erreur
+*/
+static long generer_machine(const char *chemin, int nb_etats, char blanc) {
+  FILE *f = fopen(chemin, "w");
+  if(!f) {
+    perror("Echec de la création de la machine générée");
+    return -1;
+  }
+  const char symboles[] = { 'a', 'b', 'c', 'd', blanc };
+  const char mouvements[] = "<>-";
+  uint64_t graine = 0x9e3779b97f4a7c15ULL;
+  fprintf(f, "init: q0\naccept: qF\n\n");
+  for(int e = 0; e < nb_etats; e++) {
+    for(int s = 0; s < 5; s++) {
+      uint64_t x = aleatoire(&graine);
+      int cible = x % (nb_etats + 1);
+      char nouvel_etat[16];
+      if(cible == nb_etats) strcpy(nouvel_etat, "qF");
+      else sprintf(nouvel_etat, "q%d", cible);
+      fprintf(f, "q%d,%c,%s,%c,%c\n", e, symboles[s], nouvel_etat,
+              symboles[(x >> 24) % 5], mouvements[(x >> 32) % 3]);
+    }
+  }
+  long taille = ftell(f);
+  if(fclose(f) != 0) return -1;
+  return taille;
+}
+
+static long taille_fichier(const char *chemin) {
+  struct stat st;
+  return stat(chemin, &st) == 0 ? (long) st.st_size : -1;
+}
+
+/**
+* Mémoire maximale du processus, en kilo-octets
+*/
+static long rss_max_ko() {
+  struct rusage u;
+  getrusage(RUSAGE_SELF, &u);
+  return u.ru_maxrss;
+}
+
+/**
+* Mesure l'analyse d'un grand fichier de machine
+* @return 0 en cas de succès, 1 en cas d'erreur
+*/
+static int mesurer_analyse(const char *chemin, int repetitions) {
+  long octets = generer_machine(chemin, ETATS_ANALYSE, '_');
+  if(octets < 0) return 1;
+  double meilleure = -1;
+  long nb_regles = 0;
+  for(int i = 0; i < repetitions; i++) {
+    char alphabets[] = "abcd:abcd";
+    double debut = horloge_secondes();
+    MT mt = init_machine_turing((char*) chemin, alphabets, '_');
+    double duree = horloge_secondes() - debut;
+    if(!mt) return 1;
+    nb_regles = mt->table->nb_regles;
+    free_mt(mt);
+    if(meilleure < 0 || duree < meilleure) meilleure = duree;
+  }
+  printf("{\"bench\":\"analyse\",\"etats\":%d,\"transitions\":%ld,"
+         "\"octets\":%ld,\"secondes\":%.6f,\"mo_par_s\":%.2f,"
+         "\"rss_max_ko\":%ld}\n", ETATS_ANALYSE, nb_regles, octets,
+         meilleure, octets / meilleure / 1e6, rss_max_ko());
+  return 0;
+}
+
+/**
+* Mesure la conversion (-C) d'une grande machine {a,b,c,d} vers {0,1}
+* (symbole blanc ' ', comme pour -C)
+* @return 0 en cas de succès, 1 en cas d'erreur
+*/
+static int mesurer_conversion(const char *entree, const char *sortie,
+                              int repetitions) {
+  long octets = generer_machine(entree, ETATS_CONVERSION, ' ');
+  if(octets < 0) return 1;
+  double meilleure = -1;
+  for(int i = 0; i < repetitions; i++) {
+    char alphabets[] = "abcd:abcd";
+    double debut = horloge_secondes();
+    MT mt = machine_latin_vers_binaire((char*) entree, (char*) sortie,
+                                       alphabets);
+    double duree = horloge_secondes() - debut;
+    if(!mt) return 1;
+    free_mt(mt);
+    if(meilleure < 0 || duree < meilleure) meilleure = duree;
+  }
+  printf("{\"bench\":\"conversion\",\"etats\":%d,\"octets_entree\":%ld,"
+         "\"octets_sortie\":%ld,\"secondes\":%.6f,\"mo_par_s\":%.2f,"
+         "\"rss_max_ko\":%ld}\n", ETATS_CONVERSION, octets,
+         taille_fichier(sortie), meilleure, octets / meilleure / 1e6,
+         rss_max_ko());
+  return 0;
+}
+
+/**
+* Exécute une configuration avec un moteur ; le code natif ou threadé
+* est préparé avant la mesure
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+static int executer_moteur(const char *moteur, configuration c, limites l,
+                           natif n, programme p) {
+  if(!strcmp(moteur, "table")) return executer(c, l);
+  if(!strcmp(moteur, "threade")) return executer_threade(p, c, l);
+  if(!strcmp(moteur, "macro")) return executer_macro(c, 4, l);
+  if(!strcmp(moteur, "natif")) return executer_natif(n, c, l);
+  if(!strcmp(moteur, "bits")) return executer_bits(c, l, 0, NULL);
+  if(!strcmp(moteur, "rle")) return executer_rle(c, l, 0, NULL);
+  fprintf(stderr, "\n[ERR]: Moteur d'exécution '%s' inconnu\n\n", moteur);
+  return -1;
+}
+
+/**
+* Mesure l'exécution d'une charge avec un moteur
+* @return 0 en cas de succès, 1 en cas d'erreur
+*/
+static int mesurer_execution(struct charge_s *ch, const char *moteur,
+                             int repetitions) {
+  char *alphabets = strdup(ch->alphabets);
+  MT mt = alphabets ? init_machine_turing((char*) ch->machine, alphabets,
+                                          ch->symbole_blanc) : NULL;
+  configuration c = mt ? init_configuration(mt, ch->mot) : NULL;
+  if(!c) return 1;
+  natif n = !strcmp(moteur, "natif") ? charger_natif(mt) : NULL;
+  programme p = !strcmp(moteur, "threade") ? compiler_programme(mt->table)
+                                             : NULL;
+  struct limites_s l = { ch->max_etapes, 0, 0 };
+  double meilleure = -1;
+  int res = -1;
+  if((n || strcmp(moteur, "natif")) && (p || strcmp(moteur, "threade"))) {
+    for(int i = 0; i < repetitions; i++) {
+      if(i && !reinitialiser_configuration(c, ch->mot)) {
+        res = -1;
+        break;
+      }
+      double debut = horloge_secondes();
+      res = executer_moteur(moteur, c, &l, n, p);
+      double duree = horloge_secondes() - debut;
+      if(res < 0) break;
+      if(meilleure < 0 || duree < meilleure) meilleure = duree;
+    }
+  }
+  if(res >= 0) {
+    if(meilleure <= 0) meilleure = 1e-9;
+    printf("{\"bench\":\"%s\",\"moteur\":\"%s\",\"longueur_mot\":%ld,"
+           "\"resultat\":\"%s\",\"etapes\":%ld,\"secondes\":%.6f,"
+           "\"etapes_par_s\":%.0f,\"ns_par_etape\":%.3f,\"rss_max_ko\":%ld}"
+           "\n", ch->nom, moteur, (long) strlen(ch->mot),
+           libelle_resultat(res), c->nb_etapes, meilleure,
+           c->nb_etapes / meilleure, meilleure * 1e9 / c->nb_etapes,
+           rss_max_ko());
+  } else {
+    printf("{\"bench\":\"%s\",\"moteur\":\"%s\",\"erreur\":true}\n",
+           ch->nom, moteur);
+  }
+  if(n) free_natif(n);
+  if(p) free_programme(p);
+  free_configuration(c);
+  free_mt(mt);
+  free(alphabets);
+  return res < 0;
+}
+
+/**
+* Exécute une mesure dans un processus fils
+* @return 0 si la mesure a réussi, 1 sinon
+*/
+static int dans_un_fils(int (*mesure)(void*), void *arg) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if(pid < 0) {
+    perror("Echec de fork");
+    return 1;
+  }
+  if(pid == 0) {
+    int ret = mesure(arg);
+    fflush(stdout);
+    _exit(ret);
+  }
+  int statut;
+  if(waitpid(pid, &statut, 0) < 0) return 1;
+  return !WIFEXITED(statut) || WEXITSTATUS(statut) != 0;
+}
+
+/**
+* Paramètres d'une mesure exécutée dans un processus fils
+*/
+struct mesure_s {
+  struct charge_s *charge;
+  const char *moteur;
+  const char *entree;
+  const char *sortie;
+  int repetitions;
+};
+
+static int fils_analyse(void *arg) {
+  struct mesure_s *m = (struct mesure_s*) arg;
+  return mesurer_analyse(m->entree, m->repetitions);
+}
+
+static int fils_conversion(void *arg) {
+  struct mesure_s *m = (struct mesure_s*) arg;
+  return mesurer_conversion(m->entree, m->sortie, m->repetitions);
+}
+
+static int fils_execution(void *arg) {
+  struct mesure_s *m = (struct mesure_s*) arg;
+  return mesurer_execution(m->charge, m->moteur, m->repetitions);
+}
+
+/**
+* Construit le mot d'entrée d'une charge
+* @param palindrome : 1 pour un palindrome de 0 et de 1, 0 pour 11...1
+*/
+static char* construire_mot(long longueur, int palindrome) {
+  char *mot = (char*) malloc(longueur + 1);
+  if(!mot) return NULL;
+  for(long i = 0; i < longueur; i++) {
+    long j = i < longueur - 1 - i ? i : longueur - 1 - i;
+    mot[i] = palindrome ? "0110100110010110"[j % 16] : '1';
+  }
+  mot[longueur] = '\0';
+  return mot;
+}
+
+int main(int argc, char *argv[]) {
+  int repetitions = REPETITIONS_DEFAUT, opt;
+  char moteurs_defaut[] = MOTEURS_DEFAUT;
+  char *moteurs = moteurs_defaut;
+  while((opt = getopt(argc, argv, "r:m:")) != -1) {
+    switch(opt) {
+      case 'r':
+        repetitions = atoi(optarg);
+        if(repetitions > 0) break;
+        fprintf(stderr, "\n[ERR]: '%s' n'est pas un entier strictement "
+                "positif\n\n", optarg);
+        return 1;
+      case 'm':
+        moteurs = optarg;
+        break;
+      default:
+        fprintf(stderr, "Usage : ./bench_mt [-r REPETITIONS] "
+                "[-m MOTEUR,MOTEUR,...]\n");
+        return 1;
+    }
+  }
+
+  // Fichiers générés, dans un répertoire temporaire
+  char repertoire[] = "/tmp/bench_mt_XXXXXX";
+  if(!mkdtemp(repertoire)) {
+    perror("Echec de la création du répertoire temporaire");
+    return 1;
+  }
+  char entree[64], sortie[64];
+  snprintf(entree, sizeof(entree), "%s/machine_abcd", repertoire);
+  snprintf(sortie, sizeof(sortie), "%s/machine_bin", repertoire);
+
+  char *palindrome = construire_mot(LONGUEUR_PALINDROME, 1);
+  char *uns = construire_mot(LONGUEUR_AJOUT, 0);
+  char vide[] = "";
+  struct charge_s charges[] = {
+    { "binary_palindrome", "codes_machines_turing/binary_palindrome",
+      "01:01", '_', palindrome, 0 },
+    { "ajout_1_a_nb_binaire", "codes_machines_turing/ajout_1_a_nb_binaire",
+      "01:01", '_', uns, 0 },
+    { "castor_affaire_5", "codes_machines_turing/castor_affaire_5",
+      "1:01", '0', vide, ETAPES_CASTOR }
+  };
+  int nb_charges = sizeof(charges) / sizeof(charges[0]);
+  if(!palindrome || !uns) {
+    perror("Erreur d'allocation des mots d'entrée.\n");
+    return 1;
+  }
+
+  int erreurs = 0;
+  struct mesure_s m = { NULL, NULL, entree, sortie, repetitions };
+  erreurs += dans_un_fils(fils_analyse, &m);
+  for(int i = 0; i < nb_charges; i++) {
+    m.charge = &charges[i];
+    char *copie = strdup(moteurs), *suite = NULL;
+    for(char *moteur = strtok_r(copie, ",", &suite); moteur;
+        moteur = strtok_r(NULL, ",", &suite)) {
+      m.moteur = moteur;
+      erreurs += dans_un_fils(fils_execution, &m);
+    }
+    free(copie);
+  }
+  erreurs += dans_un_fils(fils_conversion, &m);
+
+  remove(entree);
+  remove(sortie);
+  rmdir(repertoire);
+  free(palindrome);
+  free(uns);
+  if(erreurs) fprintf(stderr, "\n[ERR]: %d mesures ont échoué\n\n", erreurs);
+  return erreurs != 0;
+}
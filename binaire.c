@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "binaire.h"
+
+#define ORDRE_OCTETS 0x01020304u
+#define ALIGNEMENT 8
+
+/**
+* Écrit une section à la suite du fichier, complétée par des zéros 
+* jusqu'à l'alignement suivant
+* @param f : le fichier
+* @param e : l'entête, dont la position et la taille de la section sont 
+*            renseignées
+* @param s : la section (enum section_binaire)
+* @param donnees : le contenu de la section
+* @param taille : la taille du contenu
+* @param position : la position courante dans le fichier, mise à jour
+* @return 1 en cas de succès, 0 en cas d'erreur d'écriture
+*/
+static int ecrire_section(FILE *f, struct entete_binaire_s *e, int s, 
+                          const void *donnees, size_t taille, 
+                          uint64_t *position) {
+  static const char zeros[ALIGNEMENT] = { 0 };
+  e->debuts_sections[s] = *position;
+  e->tailles_sections[s] = taille;
+  size_t bourrage = (ALIGNEMENT - taille % ALIGNEMENT) % ALIGNEMENT;
+  if((taille && fwrite(donnees, 1, taille, f) != taille) 
+     || (bourrage && fwrite(zeros, 1, bourrage, f) != bourrage))
+    return 0;
+  *position += taille + bourrage;
+  return 1;
+}
+
+int ecrire_machine_binaire(MT mt, const char *chemin) {
+  table_transitions t = mt->table;
+  struct entete_binaire_s e;
+  memset(&e, 0, sizeof(e));
+  memcpy(e.magie, MAGIE_BINAIRE, sizeof(e.magie));
+  e.version = VERSION_BINAIRE;
+  e.ordre_octets = ORDRE_OCTETS;
+  e.taille_regle = sizeof(struct regle_s);
+  e.symbole_blanc = (unsigned char) mt->symbole_blanc;
+  e.nb_etats = t->nb_etats;
+  e.etat_in = t->etat_in;
+  e.etat_fin = t->etat_fin;
+  e.nb_symboles = t->nb_symboles;
+  e.nb_regles = t->nb_regles;
+  e.dense = t->dense;
+  e.nb_conflits = t->nb_conflits;
+  memcpy(e.code_symbole, t->code_symbole, sizeof(e.code_symbole));
+  memcpy(e.symboles, t->symboles, sizeof(e.symboles));
+
+  // Les noms des états sont rangés dans l'ordre des identifiants
+  const char *dernier = table_nom_etat(t, t->nb_etats - 1);
+  size_t taille_noms = dernier - t->noms + strlen(dernier) + 1;
+  size_t nb_cles = t->dense ? 0 : t->debuts[t->nb_etats];
+
+  FILE *f = fopen(chemin, "wb");
+  if(!f) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", chemin);
+    perror("\n\n");
+    return 0;
+  }
+  // L'entête est réécrite à la fin, une fois les sections placées
+  uint64_t position = sizeof(e);
+  int ok = fwrite(&e, sizeof(e), 1, f) == 1
+    && ecrire_section(f, &e, SECTION_ALPHABET_ENTREE, mt->alphabet_entree,
+                      strlen(mt->alphabet_entree) + 1, &position)
+    && ecrire_section(f, &e, SECTION_ALPHABET_TRAVAIL, mt->alphabet_travail,
+                      strlen(mt->alphabet_travail) + 1, &position)
+    && ecrire_section(f, &e, SECTION_NOMS, t->noms, taille_noms, &position)
+    && ecrire_section(f, &e, SECTION_OFFSETS_NOMS, t->offsets_noms, 
+                      sizeof(uint32_t) * t->nb_etats, &position)
+    && ecrire_section(f, &e, SECTION_REGLES, t->regles, 
+                      sizeof(struct regle_s) * t->nb_regles, &position)
+    && ecrire_section(f, &e, SECTION_CASES, t->cases, t->dense ? 
+                      sizeof(int32_t) * t->nb_etats * t->nb_symboles : 0,
+                      &position)
+    && ecrire_section(f, &e, SECTION_DEBUTS, t->debuts, t->dense ? 0 : 
+                      sizeof(uint32_t) * (t->nb_etats + 1), &position)
+    && ecrire_section(f, &e, SECTION_CLES, t->cles, nb_cles, &position)
+    && ecrire_section(f, &e, SECTION_CIBLES, t->cibles, 
+                      sizeof(int32_t) * nb_cles, &position);
+  e.taille_fichier = position;
+  ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&e, sizeof(e), 1, f) == 1;
+  ok = fclose(f) == 0 && ok;
+  if(!ok) {
+    perror("Erreur d'écriture de la machine binaire.\n");
+    unlink(chemin);
+  }
+  return ok;
+}
+
+int est_machine_binaire(const char *chemin) {
+  char magie[sizeof(MAGIE_BINAIRE) - 1];
+  FILE *f = fopen(chemin, "rb");
+  if(!f) return 0;
+  int ok = fread(magie, 1, sizeof(magie), f) == sizeof(magie) 
+           && !memcmp(magie, MAGIE_BINAIRE, sizeof(magie));
+  fclose(f);
+  return ok;
+}
+
+/**
+* Vérifie l'entête d'un fichier binaire projeté en mémoire
+* @param e : l'entête
+* @param taille : la taille du fichier
+* @return 1 si l'entête est valide, 0 sinon
+*/
+static int verifier_entete(const struct entete_binaire_s *e, size_t taille) {
+  if(taille < sizeof(*e) || memcmp(e->magie, MAGIE_BINAIRE, 8) 
+     || e->version != VERSION_BINAIRE || e->ordre_octets != ORDRE_OCTETS
+     || e->taille_regle != sizeof(struct regle_s) 
+     || e->taille_fichier != taille || e->nb_etats <= 0 
+     || e->etat_in < 0 || e->etat_in >= e->nb_etats 
+     || e->etat_fin < 0 || e->etat_fin >= e->nb_etats
+     || e->nb_symboles <= 0 || e->nb_symboles > 256 || e->nb_regles < 0)
+    return 0;
+  for(int s = 0; s < NB_SECTIONS; s++) 
+    if(e->debuts_sections[s] % ALIGNEMENT 
+       || e->debuts_sections[s] > taille 
+       || e->tailles_sections[s] > taille - e->debuts_sections[s])
+      return 0;
+  // Tailles attendues des sections
+  uint64_t n = e->nb_etats;
+  return e->tailles_sections[SECTION_ALPHABET_ENTREE] > 0
+    && e->tailles_sections[SECTION_ALPHABET_TRAVAIL] > 0
+    && e->tailles_sections[SECTION_NOMS] > 0
+    && e->tailles_sections[SECTION_OFFSETS_NOMS] == sizeof(uint32_t) * n
+    && e->tailles_sections[SECTION_REGLES] 
+       == sizeof(struct regle_s) * e->nb_regles
+    && e->tailles_sections[SECTION_CASES] 
+       == (e->dense ? sizeof(int32_t) * n * e->nb_symboles : 0)
+    && e->tailles_sections[SECTION_DEBUTS] 
+       == (e->dense ? 0 : sizeof(uint32_t) * (n + 1))
+    && e->tailles_sections[SECTION_CIBLES] 
+       == sizeof(int32_t) * e->tailles_sections[SECTION_CLES];
+}
+
+/**
+* Vérifie le contenu des sections d'un fichier binaire dont l'entête est
+* valide, en un seul passage : les alphabets et les noms sont terminés
+* par '\0', et chaque code de symbole, identifiant d'état et indice de 
+* règle ou de section désigne un élément existant. Les moteurs 
+* n'effectuent ensuite plus aucune vérification.
+* @param e : l'entête
+* @param base : le début du fichier projeté en mémoire
+* @return 1 si le contenu est valide, 0 sinon
+*/
+static int verifier_contenu(const struct entete_binaire_s *e, 
+                            const char *base) {
+  const uint64_t *debut = e->debuts_sections, *taille = e->tailles_sections;
+  for(int s = SECTION_ALPHABET_ENTREE; s <= SECTION_NOMS; s++)
+    if(base[debut[s] + taille[s] - 1] != '\0') return 0;
+  for(int c = 0; c < 256; c++)
+    if(e->code_symbole[c] < -1 || e->code_symbole[c] >= e->nb_symboles)
+      return 0;
+  for(int c = 0; c < e->nb_symboles; c++)
+    if(e->code_symbole[e->symboles[c]] != c) return 0;
+  if(e->symbole_blanc > 255 || e->code_symbole[e->symbole_blanc] < 0)
+    return 0;
+
+  const uint32_t *offsets = (const uint32_t*) (base 
+                              + debut[SECTION_OFFSETS_NOMS]);
+  for(int i = 0; i < e->nb_etats; i++) 
+    if(offsets[i] >= taille[SECTION_NOMS]) return 0;
+
+  const struct regle_s *regles = (const struct regle_s*) (base 
+                                   + debut[SECTION_REGLES]);
+  for(int i = 0; i < e->nb_regles; i++) {
+    const struct regle_s *r = &regles[i];
+    if(r->nouvel_etat < 0 || r->nouvel_etat >= e->nb_etats 
+       || r->rang < 0 || r->rang >= e->nb_regles 
+       || r->nb_alternatives < 0 || r->nb_alternatives > e->nb_regles - i
+       || e->code_symbole[r->symbole_ecrit] < 0
+       || !((r->mouvement == '>' && r->deplacement == 1) 
+            || (r->mouvement == '<' && r->deplacement == -1) 
+            || (r->mouvement == '-' && r->deplacement == 0)))
+      return 0;
+  }
+
+  // Les tables ne désignent que la première règle d'un groupe
+  if(e->dense) {
+    const int32_t *cases = (const int32_t*) (base + debut[SECTION_CASES]);
+    for(uint64_t i = 0; i < taille[SECTION_CASES] / sizeof(int32_t); i++)
+      if(cases[i] != -1 && (cases[i] < 0 || cases[i] >= e->nb_regles 
+                            || !regles[cases[i]].nb_alternatives))
+        return 0;
+    return 1;
+  }
+  const uint32_t *debuts = (const uint32_t*) (base + debut[SECTION_DEBUTS]);
+  const unsigned char *cles = (const unsigned char*) (base 
+                                + debut[SECTION_CLES]);
+  const int32_t *cibles = (const int32_t*) (base + debut[SECTION_CIBLES]);
+  if(debuts[0] != 0 || debuts[e->nb_etats] != taille[SECTION_CLES]) 
+    return 0;
+  for(int etat = 0; etat < e->nb_etats; etat++) {
+    if(debuts[etat + 1] < debuts[etat]) return 0;
+    for(uint32_t k = debuts[etat]; k < debuts[etat + 1]; k++)
+      if(cles[k] >= e->nb_symboles 
+         || (k > debuts[etat] && cles[k] <= cles[k - 1])
+         || cibles[k] < 0 || cibles[k] >= e->nb_regles 
+         || !regles[cibles[k]].nb_alternatives)
+        return 0;
+  }
+  return 1;
+}
+
+MT charger_machine_binaire(const char *chemin, const char *alphabets, 
+                           char symbole_blanc) {
+  int fd = open(chemin, O_RDONLY);
+  if(fd < 0) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", chemin);
+    perror("\n\n");
+    return NULL;
+  }
+  struct stat st;
+  void *projection = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && st.st_size > 0) 
+    projection = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(projection == MAP_FAILED) {
+    fprintf(stderr, "\n[ERR]: Echec de la projection du fichier %s", 
+            chemin);
+    perror("\n\n");
+    return NULL;
+  }
+
+  const struct entete_binaire_s *e = 
+    (const struct entete_binaire_s*) projection;
+  char *base = (char*) projection;
+  if(!verifier_entete(e, st.st_size) || !verifier_contenu(e, base)) {
+    fprintf(stderr, "\n[ERR]: Le fichier %s n'est pas une machine binaire "
+            "valide pour cette version (%d) du simulateur\n\n", chemin, 
+            VERSION_BINAIRE);
+    munmap(projection, st.st_size);
+    return NULL;
+  }
+
+  // Les alphabets et le symbole blanc sont ceux de la compilation
+  char *entree = base + e->debuts_sections[SECTION_ALPHABET_ENTREE];
+  char *travail = base + e->debuts_sections[SECTION_ALPHABET_TRAVAIL];
+  size_t n_entree = strlen(entree);
+  if(strncmp(alphabets, entree, n_entree) || alphabets[n_entree] != ':' 
+     || strcmp(alphabets + n_entree + 1, travail) 
+     || (unsigned char) symbole_blanc != e->symbole_blanc) {
+    fprintf(stderr, "\n[ERR]: La machine binaire %s a été compilée pour "
+            "les alphabets '%s:%s' et le symbole blanc '%c'\n\n", chemin,
+            entree, travail, (char) e->symbole_blanc);
+    munmap(projection, st.st_size);
+    return NULL;
+  }
+
+  MT mt = (MT) calloc(1, sizeof(struct MT_s));
+  table_transitions t = (table_transitions) calloc(1, 
+                                              sizeof(struct table_s));
+  if(!mt || !t) {
+    perror("Erreur d'allocation de la machine binaire.\n");
+    free(mt);
+    free(t);
+    munmap(projection, st.st_size);
+    return NULL;
+  }
+  t->nb_etats = e->nb_etats;
+  t->noms = base + e->debuts_sections[SECTION_NOMS];
+  t->offsets_noms = (uint32_t*) (base 
+                      + e->debuts_sections[SECTION_OFFSETS_NOMS]);
+  t->etat_in = e->etat_in;
+  t->etat_fin = e->etat_fin;
+  t->nb_symboles = e->nb_symboles;
+  memcpy(t->code_symbole, e->code_symbole, sizeof(t->code_symbole));
+  memcpy(t->symboles, e->symboles, sizeof(t->symboles));
+  t->nb_regles = e->nb_regles;
+  t->regles = (struct regle_s*) (base + e->debuts_sections[SECTION_REGLES]);
+  t->dense = e->dense;
+  t->cases = t->dense ? (int32_t*) (base 
+                          + e->debuts_sections[SECTION_CASES]) : NULL;
+  t->debuts = t->dense ? NULL : (uint32_t*) (base 
+                          + e->debuts_sections[SECTION_DEBUTS]);
+  t->cles = t->dense ? NULL : (unsigned char*) (base 
+                          + e->debuts_sections[SECTION_CLES]);
+  t->cibles = t->dense ? NULL : (int32_t*) (base 
+                          + e->debuts_sections[SECTION_CIBLES]);
+  t->nb_conflits = e->nb_conflits;
+  // Les états de recherche ne sont pas stockés : ils sont détectés au
+  // chargement
+  if(!table_preparer_recherches(t)) {
+    perror("Erreur d'allocation de la machine binaire.\n");
+    free(mt);
+    free(t);
+    munmap(projection, st.st_size);
+    return NULL;
+  }
+
+  mt->alphabet_entree = entree;
+  mt->alphabet_travail = travail;
+  mt->symbole_blanc = symbole_blanc;
+  mt->etat_in = (char*) table_nom_etat(t, t->etat_in);
+  mt->etat_fin = (char*) table_nom_etat(t, t->etat_fin);
+  mt->transitions = NULL;
+  mt->transitions_fin = NULL;
+  mt->table = t;
+  mt->projection = projection;
+  mt->taille_projection = st.st_size;
+  return mt;
+}
@@ -0,0 +1,115 @@
+#ifndef _binaire_h_
+#define _binaire_h_
+
+#include <stdint.h>
+
+#include "machineturing.h"
+
+/**
+* Format binaire précompilé d'une machine de Turing : la table des 
+* transitions compilée (noms des états internalisés, règles, table 
+* dense ou creuse), les alphabets et le symbole blanc, tels qu'ils sont
+* en mémoire. Le fichier est projeté en mémoire (mmap) en lecture seule
+* et la machine s'exécute directement depuis la projection, sans 
+* analyse du texte ni copie des tables ; plusieurs processus partagent
+* ainsi les mêmes pages du cache.
+* Le fichier commence par une entête (struct entete_binaire_s) suivie 
+* des sections, chacune alignée sur 8 octets.
+*/
+
+// Début de tout fichier binaire
+#define MAGIE_BINAIRE "MTBIN\r\n\032"
+// Version du format, à incrémenter à chaque changement de structure
+#define VERSION_BINAIRE 1
+
+/**
+* Sections du fichier binaire
+*/
+enum section_binaire {
+  SECTION_ALPHABET_ENTREE,
+  SECTION_ALPHABET_TRAVAIL,
+  SECTION_NOMS,
+  SECTION_OFFSETS_NOMS,
+  SECTION_REGLES,
+  SECTION_CASES,
+  SECTION_DEBUTS,
+  SECTION_CLES,
+  SECTION_CIBLES,
+  NB_SECTIONS
+};
+
+/**
+* Entête du fichier binaire.
+* magie -> MAGIE_BINAIRE
+* version -> VERSION_BINAIRE
+* ordre_octets -> 0x01020304 écrit dans l'ordre des octets de la machine
+*                 qui a écrit le fichier
+* taille_regle -> sizeof(struct regle_s) de la machine qui a écrit le 
+*                 fichier
+* taille_fichier -> la taille totale du fichier
+* nb_etats ... nb_conflits -> les champs de même nom de la table
+* symbole_blanc -> le symbole blanc
+* debuts_sections / tailles_sections -> la position et la taille (en 
+*                                       octets) de chaque section
+* code_symbole / symboles -> les champs de même nom de la table
+*/
+struct entete_binaire_s {
+  char magie[8];
+  uint32_t version;
+  uint32_t ordre_octets;
+  uint32_t taille_regle;
+  uint32_t symbole_blanc;
+  uint64_t taille_fichier;
+  int32_t nb_etats;
+  int32_t etat_in;
+  int32_t etat_fin;
+  int32_t nb_symboles;
+  int32_t nb_regles;
+  int32_t dense;
+  int32_t nb_conflits;
+  int32_t reserve;
+  uint64_t debuts_sections[NB_SECTIONS];
+  uint64_t tailles_sections[NB_SECTIONS];
+  int16_t code_symbole[256];
+  unsigned char symboles[256];
+};
+
+/**
+* Écrit une machine compilée au format binaire
+* @param mt : la machine
+* @param chemin : le fichier à créer
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int ecrire_machine_binaire(MT mt, const char *chemin);
+
+/**
+* Indique si un fichier est au format binaire (commence par 
+* MAGIE_BINAIRE)
+* @param chemin : le fichier
+* @return 1 si le fichier est au format binaire, 0 sinon
+*/
+int est_machine_binaire(const char *chemin);
+
+/**
+* Charge une machine au format binaire en projetant le fichier en 
+* mémoire. Les tables de la machine pointent dans la projection : seules
+* les structures de la machine et de la table sont allouées. L'entête 
+* est vérifiée (magie, version, ordre des octets, tailles, bornes des 
+* sections), puis le contenu une seule fois au chargement : chaînes 
+* terminées par '\0', cohérence des codes de symboles et du blanc, 
+* offsets des noms, états, rangs, symboles et mouvements des règles, 
+* indices des tables de saut. Les moteurs se fient ensuite à la table 
+* sans autre contrôle ; le sens des règles (qu'elles décrivent bien la 
+* machine compilée) et les compteurs annexes ne sont pas vérifiés.
+* @param chemin : le fichier
+* @param alphabets : les alphabets attendus, au format
+*                    alphabet_entree:alphabet_travail
+* @param symbole_blanc : le symbole blanc attendu
+* @return la machine, NULL en cas d'erreur ou si les alphabets ou le 
+*         symbole blanc diffèrent de ceux du fichier
+*/
+MT charger_machine_binaire(const char *chemin, const char *alphabets, 
+                           char symbole_blanc);
+
+
+#endif
@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+// Nombre minimal de mots alloués pour un ruban compacté
+#define NB_MOTS_MIN 16
+
+/**
+* Action du moteur bits dans un état donné pour un code de symbole lu
+* nouvel_etat -> le nouvel état
+* ecrit -> le code du symbole à écrire
+* deplacement -> le déplacement de la tête (+1, -1 ou 0)
+* arret -> 1 si la machine s'arrête (état final ou absence de
+*          transition), 0 sinon
+*/
+struct action_bits_s {
+  int32_t nouvel_etat;
+  uint8_t ecrit;
+  int8_t deplacement;
+  uint8_t arret;
+};
+
+/**
+* Structure de données du moteur bits.
+* table -> la table des transitions de la machine
+* code -> symbole -> code du symbole sur le ruban compacté, -1 si le
+*         symbole est inconnu
+* symboles -> code -> symbole
+* actions -> les actions, MAX_SYMBOLES_BITS par état
+* ruban -> le ruban compacté
+*/
+struct moteur_bits_s {
+  table_transitions table;
+  int code[256];
+  unsigned char symboles[MAX_SYMBOLES_BITS];
+  struct action_bits_s *actions;
+  struct ruban_bits_s ruban;
+};
+typedef struct moteur_bits_s* moteur_bits;
+
+/**
+* Renvoie le nombre de cases d'un mot du ruban compacté (puissance de 2)
+*/
+static inline long cases_par_mot(ruban_bits r) {
+  return 64 / r->largeur;
+}
+
+/**
+* Agrandit le ruban compacté pour qu'il contienne un mot donné, en
+* doublant sa taille du côté où il doit être agrandi
+* @param r : le ruban à agrandir
+* @param mot : l'indice du mot qui doit être alloué, mis à jour si le
+*              ruban est agrandi à gauche
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int etendre_ruban_bits(ruban_bits r, long *mot) {
+  if(*mot >= 0 && *mot < r->nb_mots) return 1;
+  long ajout = r->nb_mots;
+  if(*mot < 0 && -*mot > ajout) ajout = -*mot;
+  if(*mot >= r->nb_mots && *mot - r->nb_mots + 1 > ajout)
+    ajout = *mot - r->nb_mots + 1;
+  uint64_t *mots = (uint64_t*) calloc(r->nb_mots + ajout, sizeof(uint64_t));
+  if(!mots) return 0;
+  long decalage = *mot < 0 ? ajout : 0;
+  memcpy(mots + decalage, r->mots, r->nb_mots * sizeof(uint64_t));
+  free(r->mots);
+  r->mots = mots;
+  r->nb_mots += ajout;
+  r->origine += decalage * cases_par_mot(r);
+  *mot += decalage;
+  return 1;
+}
+
+/**
+* Renvoie le code du symbole d'une position du ruban compacté,
+* supposée allouée
+*/
+static inline int lire_bits(ruban_bits r, long position) {
+  long i = position + r->origine;
+  int decalage = (int) (i % cases_par_mot(r)) * r->largeur;
+  return (int) (r->mots[i / cases_par_mot(r)] >> decalage)
+         & ((1 << r->largeur) - 1);
+}
+
+/**
+* Compte les cases d'un ruban compacté qui contiennent un code donné,
+* non nul, par popcount : sur un ruban de 2 bits par case, un mot est
+* comparé à toutes ses cases à la fois (x = mot ^ code répété), une case
+* égale au code donnant deux bits nuls dans x
+* @param r : le ruban compacté
+* @param code : le code à compter (1 à 3)
+* @return le nombre de cases contenant code
+*/
+static long compter_bits(ruban_bits r, int code) {
+  long total = 0;
+  if(r->largeur == 1) {
+    for(long i = 0; i < r->nb_mots; i++)
+      total += __builtin_popcountll(r->mots[i]);
+    return total;
+  }
+  const uint64_t bits_bas = 0x5555555555555555ULL;
+  uint64_t repete = bits_bas * (uint64_t) code;
+  for(long i = 0; i < r->nb_mots; i++) {
+    uint64_t x = r->mots[i] ^ repete;
+    total += __builtin_popcountll(~(x | (x >> 1)) & bits_bas);
+  }
+  return total;
+}
+
+static void free_moteur_bits(moteur_bits m) {
+  if(!m) return;
+  free(m->actions);
+  free(m->ruban.mots);
+  free(m);
+}
+
+/**
+* Crée le moteur bits d'une configuration : codes des symboles, table
+* des actions et ruban compacté contenant le ruban de la configuration
+* @return le moteur, NULL en cas d'erreur
+*/
+static moteur_bits init_moteur_bits(configuration c) {
+  table_transitions t = c->mt->table;
+  ruban r = c->ruban_courant;
+  if(t->nb_symboles > MAX_SYMBOLES_BITS) {
+    fprintf(stderr, "\n[ERR]: Le moteur bits est limité aux machines "
+            "d'au plus %d symboles (symbole blanc compris), la machine "
+            "en a %d\n\n", MAX_SYMBOLES_BITS, (int) t->nb_symboles);
+    return NULL;
+  }
+  moteur_bits m = (moteur_bits) calloc(1, sizeof(struct moteur_bits_s));
+  if(!m) {
+    perror("Erreur d'allocation de la mémoire du moteur bits.\n");
+    return NULL;
+  }
+  m->table = t;
+
+  // Le symbole blanc a le code 0, les autres symboles suivent dans
+  // l'ordre de la table
+  for(int s = 0; s < 256; s++) m->code[s] = -1;
+  int nb = 0;
+  m->code[r->symbole_blanc] = nb;
+  m->symboles[nb++] = r->symbole_blanc;
+  for(int i = 0; i < t->nb_symboles; i++) {
+    if(m->code[t->symboles[i]] >= 0) continue;
+    m->code[t->symboles[i]] = nb;
+    m->symboles[nb++] = t->symboles[i];
+  }
+
+  m->actions = (struct action_bits_s*) malloc(sizeof(struct action_bits_s)
+                       * (size_t) t->nb_etats * MAX_SYMBOLES_BITS);
+  m->ruban.largeur = nb <= 2 ? 1 : 2;
+  long cpm = cases_par_mot(&m->ruban);
+  // Le ruban compacté couvre les positions visitées du ruban de départ
+  long debut = r->min >= 0 ? 0 : (-r->min + cpm - 1) / cpm;
+  m->ruban.nb_mots = debut + r->max / cpm + 1;
+  if(m->ruban.nb_mots < NB_MOTS_MIN) m->ruban.nb_mots = NB_MOTS_MIN;
+  m->ruban.mots = (uint64_t*) calloc(m->ruban.nb_mots, sizeof(uint64_t));
+  if(!m->actions || !m->ruban.mots) {
+    perror("Erreur d'allocation de la mémoire du moteur bits.\n");
+    free_moteur_bits(m);
+    return NULL;
+  }
+  m->ruban.origine = debut * cpm;
+  m->ruban.min = r->min;
+  m->ruban.max = r->max;
+
+  for(int e = 0; e < t->nb_etats; e++) {
+    for(int code = 0; code < MAX_SYMBOLES_BITS; code++) {
+      struct action_bits_s *a = &m->actions[e * MAX_SYMBOLES_BITS + code];
+      // L'état final arrête la machine avant toute lecture
+      int32_t i = code < nb && e != t->etat_fin
+                  ? table_chercher(t, e, m->symboles[code]) : -1;
+      a->arret = i < 0;
+      a->nouvel_etat = e;
+      a->ecrit = (uint8_t) code;
+      a->deplacement = 0;
+      if(i < 0) continue;
+      regle rg = &t->regles[i];
+      a->nouvel_etat = rg->nouvel_etat;
+      a->ecrit = (uint8_t) m->code[rg->symbole_ecrit];
+      a->deplacement = rg->deplacement;
+    }
+  }
+
+  for(long p = r->min; p <= r->max; p++) {
+    int code = m->code[*ruban_case(r, p)];
+    if(code < 0) {
+      fprintf(stderr, "\n[ERR]: Symbole '%c' du ruban inconnu du moteur "
+              "bits\n\n", *ruban_case(r, p));
+      free_moteur_bits(m);
+      return NULL;
+    }
+    long i = p + m->ruban.origine;
+    m->ruban.mots[i / cpm] |= (uint64_t) code << ((i % cpm)
+                                                  * m->ruban.largeur);
+  }
+  return m;
+}
+
+/**
+* Recopie le ruban compacté dans le ruban d'une configuration
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int recopier_ruban(moteur_bits m, ruban r) {
+  if(!ruban_etendre(r, m->ruban.min) || !ruban_etendre(r, m->ruban.max))
+    return 0;
+  for(long p = m->ruban.min; p <= m->ruban.max; p++)
+    *ruban_case(r, p) = m->symboles[lire_bits(&m->ruban, p)];
+  r->min = m->ruban.min;
+  r->max = m->ruban.max;
+  return 1;
+}
+
+/**
+* Exécute la machine jusqu'à son arrêt ou jusqu'à une étape donnée
+* (tranche_moteur)
+* @param c : la configuration (état, position de la tête et nombre
+*            d'étapes), mise à jour
+* @param fin_tranche : l'étape à laquelle interrompre l'exécution
+* @param contexte : le moteur
+* @return 1 si la machine s'est arrêtée, 0 si fin_tranche est atteinte,
+*         -1 en cas d'erreur d'allocation
+*/
+static int executer_tranche(configuration c, long fin_tranche, 
+                            void *contexte) {
+  moteur_bits m = (moteur_bits) contexte;
+  ruban_bits r = &m->ruban;
+  const struct action_bits_s *actions = m->actions;
+  const int largeur = r->largeur;
+  const uint64_t masque = (1ULL << largeur) - 1;
+  long tete = c->tete_lecture, n = c->nb_etapes;
+  long min = r->min, max = r->max;
+  int etat = c->etat_courant, res = 0;
+
+  // Le mot de la tête est gardé dans mot, le décalage de la case de la
+  // tête dans ce mot dans decalage
+  long i = tete + r->origine;
+  long indice = i / cases_par_mot(r);
+  int decalage = (int) (i % cases_par_mot(r)) * largeur;
+  uint64_t mot = r->mots[indice];
+
+  while(n < fin_tranche) {
+    const struct action_bits_s *a =
+      &actions[etat * MAX_SYMBOLES_BITS + ((mot >> decalage) & masque)];
+    if(a->arret) {
+      res = 1;
+      break;
+    }
+    mot = (mot & ~(masque << decalage)) | ((uint64_t) a->ecrit << decalage);
+    etat = a->nouvel_etat;
+    n++;
+    if(a->deplacement > 0) {
+      if(++tete > max) max = tete;
+      decalage += largeur;
+      if(decalage == 64) {
+        // La tête passe au mot suivant
+        r->mots[indice++] = mot;
+        if(!etendre_ruban_bits(r, &indice)) {
+          res = -1;
+          break;
+        }
+        mot = r->mots[indice];
+        decalage = 0;
+      }
+    } else if(a->deplacement < 0) {
+      if(--tete < min) min = tete;
+      if(decalage == 0) {
+        // La tête passe au mot précédent
+        r->mots[indice--] = mot;
+        if(!etendre_ruban_bits(r, &indice)) {
+          res = -1;
+          break;
+        }
+        mot = r->mots[indice];
+        decalage = 64;
+      }
+      decalage -= largeur;
+    }
+  }
+
+  if(res >= 0) r->mots[indice] = mot;
+  r->min = min;
+  r->max = max;
+  c->etat_courant = etat;
+  c->tete_lecture = tete;
+  c->nb_etapes = n;
+  return res;
+}
+
+/**
+* Résultat de l'exécution (même calcul que resultat_configuration(), 
+* le symbole sous la tête étant lu sur le ruban compacté ;
+* resultat_moteur)
+* @param limite_atteinte : 1 si l'exécution a été interrompue par une
+*                          limite, 0 si la machine s'est arrêtée
+* @param contexte : le moteur
+*/
+static int resultat_bits(configuration c, int limite_atteinte, 
+                         void *contexte) {
+  moteur_bits m = (moteur_bits) contexte;
+  if(c->etat_courant == m->table->etat_fin) return RESULTAT_ACCEPTE;
+  // La machine n'est limitée que si elle pouvait encore avancer
+  if(limite_atteinte && !m->actions[c->etat_courant * MAX_SYMBOLES_BITS 
+                        + lire_bits(&m->ruban, c->tete_lecture)].arret)
+    return RESULTAT_TIMEOUT;
+  return RESULTAT_REFUSE;
+}
+
+int executer_bits(configuration c, limites l, int recopier,
+                  FILE *statistiques) {
+  moteur_bits m = init_moteur_bits(c);
+  if(!m) return -1;
+  int res = executer_tranches(c, l, executer_tranche, resultat_bits, m);
+  if(res < 0) {
+    perror("Erreur d'allocation de la mémoire du ruban compacté.\n");
+    free_moteur_bits(m);
+    return -1;
+  }
+
+  if(statistiques && m->table->nb_symboles > 1) {
+    // On compte les '1', ou à défaut le premier symbole non blanc
+    int code = m->code['1'] > 0 ? m->code['1'] : 1;
+    fprintf(statistiques, "[BITS]: %ld cases visitées, %d bit(s) par "
+            "case, %ld octets ; %ld case(s) '%c'\n",
+            m->ruban.max - m->ruban.min + 1, m->ruban.largeur,
+            m->ruban.nb_mots * (long) sizeof(uint64_t),
+            compter_bits(&m->ruban, code), m->symboles[code]);
+  }
+  if(recopier && !recopier_ruban(m, c->ruban_courant)) res = -1;
+  free_moteur_bits(m);
+  return res;
+}
@@ -0,0 +1,64 @@
+#ifndef _bits_h_
+#define _bits_h_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "machineturing.h"
+
+/**
+* Nombre maximal de symboles (symbole blanc compris) d'une machine
+* exécutée par le moteur bits
+*/
+#define MAX_SYMBOLES_BITS 4
+
+/**
+* Ruban compacté du moteur bits : chaque case est codée sur largeur
+* bits (1 pour 2 symboles, 2 pour 3 ou 4 symboles) dans des mots de 64
+* bits, le symbole blanc ayant le code 0 : un mot nul est un mot de
+* cases blanches. Comme le ruban de ruban.h, il est agrandi en doublant
+* sa taille du côté où la tête de lecture en sort.
+* mots -> les mots du ruban
+* nb_mots -> le nombre de mots alloués
+* origine -> l'indice (en cases, multiple du nombre de cases par mot) de
+*            la position 0 dans mots
+* min / max -> les positions extrêmes visitées par la tête de lecture
+* largeur -> le nombre de bits d'une case
+*/
+struct ruban_bits_s {
+  uint64_t *mots;
+  long nb_mots;
+  long origine;
+  long min;
+  long max;
+  int largeur;
+};
+typedef struct ruban_bits_s* ruban_bits;
+
+/**
+* Exécute une machine d'au plus MAX_SYMBOLES_BITS symboles avec le
+* moteur bits : le ruban est compacté (struct ruban_bits_s) et le mot
+* qui contient la case de la tête est gardé dans un registre, les
+* lectures, écritures et déplacements se faisant par masques et
+* décalages ; le mot n'est relu ou réécrit en mémoire que lorsque la
+* tête change de mot. Le nombre d'étapes et le résultat sont les mêmes
+* qu'avec executer().
+* @param c : la configuration de départ, mise à jour (état, position de
+*            la tête, nombre d'étapes et, si recopier, ruban)
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite par ce moteur), NULL pour ne pas
+*            limiter
+* @param recopier : 1 pour recopier le ruban compacté dans
+*                   c->ruban_courant à la fin de l'exécution, 0 pour ne
+*                   pas le faire (c->ruban_courant garde alors le ruban
+*                   de départ)
+* @param statistiques : flux où afficher la taille du ruban compacté et
+*                       le nombre de '1' (compté par popcount), NULL
+*                       pour ne rien afficher
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int executer_bits(configuration c, limites l, int recopier,
+                  FILE *statistiques);
+
+
+#endif
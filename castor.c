@@ -0,0 +1,390 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "ruban.h"
+#include "machineturing.h"
+#include "castor.h"
+
+#define CAPACITE_FILE_INITIALE 256
+
+/**
+* Machine de Turing à 2 symboles en cours d'énumération. La transition
+* (etat e, symbole s) est à l'indice 2*e+s.
+* ecrit -> le symbole écrit par chaque transition
+* deplacement -> le déplacement de chaque transition (+1 ou -1)
+* suivant -> le nouvel état de chaque transition, -1 si la transition 
+*            n'est pas définie (arrêt)
+* nb_definies -> le nombre de transitions définies
+* nb_etats -> le nombre d'états déjà utilisés
+*/
+struct castor_s {
+  signed char ecrit[2 * MAX_ETATS_CASTOR];
+  signed char deplacement[2 * MAX_ETATS_CASTOR];
+  signed char suivant[2 * MAX_ETATS_CASTOR];
+  signed char nb_definies;
+  signed char nb_etats;
+};
+typedef struct castor_s castor;
+
+/**
+* File de tâches d'un thread. Le thread propriétaire empile et dépile
+* à la fin de la file, les autres threads volent au début.
+*/
+struct file_taches_s {
+  pthread_mutex_t verrou;
+  castor *taches;
+  long debut;
+  long fin;
+  long capacite;
+};
+
+/**
+* Statistiques d'un thread
+*/
+struct statistiques_s {
+  long machines;
+  long arrets;
+  long holdouts;
+  long etapes;
+};
+
+/**
+* Données partagées de l'énumération.
+* n -> le nombre d'états des machines
+* max_etapes -> la limite d'étapes de chaque machine
+* nb_threads -> le nombre de threads effectivement créés
+* depart -> verrou tenu par le thread principal pendant la création des
+*           threads : les threads ne commencent qu'une fois nb_threads 
+*           connu
+* files -> la file de tâches de chaque thread
+* en_attente -> le nombre de machines créées et pas encore traitées
+* verrou_sortie -> protège la sortie et les champions
+* champion_etapes / champion_uns -> les meilleurs scores trouvés
+* sortie -> le fichier des résultats
+*/
+struct enumeration_s {
+  int n;
+  long max_etapes;
+  int nb_threads;
+  pthread_mutex_t depart;
+  struct file_taches_s *files;
+  long en_attente;
+  pthread_mutex_t verrou_sortie;
+  long champion_etapes;
+  long champion_uns;
+  FILE *sortie;
+};
+typedef struct enumeration_s* enumeration;
+
+/**
+* Paramètres d'un thread
+*/
+struct travailleur_s {
+  enumeration e;
+  int id;
+  struct statistiques_s stats;
+};
+
+static int empiler(struct file_taches_s *f, castor *m) {
+  pthread_mutex_lock(&f->verrou);
+  if(f->fin == f->capacite) {
+    if(f->debut > 0) {
+      memmove(f->taches, f->taches + f->debut, 
+              sizeof(castor) * (f->fin - f->debut));
+      f->fin -= f->debut;
+      f->debut = 0;
+    } else {
+      castor *taches = (castor*) realloc(f->taches, 
+                                         sizeof(castor) * f->capacite * 2);
+      if(!taches) {
+        pthread_mutex_unlock(&f->verrou);
+        return 0;
+      }
+      f->taches = taches;
+      f->capacite *= 2;
+    }
+  }
+  f->taches[f->fin++] = *m;
+  pthread_mutex_unlock(&f->verrou);
+  return 1;
+}
+
+static int depiler(struct file_taches_s *f, castor *m) {
+  int ok = 0;
+  pthread_mutex_lock(&f->verrou);
+  if(f->fin > f->debut) {
+    *m = f->taches[--f->fin];
+    ok = 1;
+  }
+  pthread_mutex_unlock(&f->verrou);
+  return ok;
+}
+
+static int voler(struct file_taches_s *f, castor *m) {
+  int ok = 0;
+  pthread_mutex_lock(&f->verrou);
+  if(f->fin > f->debut) {
+    *m = f->taches[f->debut++];
+    ok = 1;
+  }
+  pthread_mutex_unlock(&f->verrou);
+  return ok;
+}
+
+/**
+* Obtient la prochaine machine à traiter : dans la file du thread, 
+* sinon volée dans la file d'un autre thread
+* @return 1 si une machine a été obtenue, 0 si l'énumération est finie
+*/
+static int obtenir_tache(enumeration e, int id, castor *m) {
+  for(;;) {
+    if(depiler(&e->files[id], m)) return 1;
+    for(int i = 1; i < e->nb_threads; i++) 
+      if(voler(&e->files[(id + i) % e->nb_threads], m)) return 1;
+    if(__atomic_load_n(&e->en_attente, __ATOMIC_ACQUIRE) == 0) return 0;
+    sched_yield();
+  }
+}
+
+/**
+* Écrit une machine au format '1RB1LC_1RC1RB_...'
+*/
+static void ecrire_castor(FILE *f, castor *m, int n) {
+  for(int e = 0; e < n; e++) {
+    if(e) fputc('_', f);
+    for(int s = 0; s < 2; s++) {
+      int t = 2 * e + s;
+      if(m->suivant[t] < 0) fputs("---", f);
+      else fprintf(f, "%d%c%c", m->ecrit[t], 
+                   m->deplacement[t] > 0 ? 'R' : 'L', 'A' + m->suivant[t]);
+    }
+  }
+}
+
+/**
+* Exécute une machine depuis un ruban blanc
+* @param m : la machine
+* @param r : le ruban de travail du thread
+* @param limite : le nombre maximal d'étapes
+* @param etapes : le nombre d'étapes effectuées
+* @param tete : la position finale de la tête de lecture
+* @return l'indice de la transition non définie atteinte, -1 si la 
+*         limite d'étapes est atteinte
+*/
+static int simuler_castor(castor *m, ruban r, long limite, long *etapes,
+                          long *tete) {
+  long n = 0;
+  int etat = 0, t = -1;
+  *tete = 0;
+  ruban_reinitialiser(r, "");
+  while(n < limite) {
+    cellule *c = ruban_case(r, *tete);
+    t = 2 * etat + *c;
+    if(m->suivant[t] < 0) break;
+    *c = m->ecrit[t];
+    etat = m->suivant[t];
+    if(!ruban_deplacer(r, tete, m->deplacement[t])) break;
+    n++;
+  }
+  *etapes = n;
+  return n < limite ? t : -1;
+}
+
+/**
+* Compte les 1 d'un ruban
+*/
+static long compter_uns(ruban r) {
+  long uns = 0;
+  for(long p = r->min; p <= r->max; p++) uns += *ruban_case(r, p);
+  return uns;
+}
+
+/**
+* Met à jour les champions avec une machine qui s'arrête
+*/
+static void verifier_champion(enumeration e, castor *m, long etapes, 
+                              long uns) {
+  if(etapes <= __atomic_load_n(&e->champion_etapes, __ATOMIC_RELAXED) 
+     && uns <= __atomic_load_n(&e->champion_uns, __ATOMIC_RELAXED))
+    return;
+  pthread_mutex_lock(&e->verrou_sortie);
+  int etapes_battu = etapes > e->champion_etapes;
+  int uns_battu = uns > e->champion_uns;
+  if(etapes_battu)
+    __atomic_store_n(&e->champion_etapes, etapes, __ATOMIC_RELAXED);
+  if(uns_battu) __atomic_store_n(&e->champion_uns, uns, __ATOMIC_RELAXED);
+  if(etapes_battu || uns_battu) {
+    fprintf(e->sortie, "CHAMPION\tetapes=%ld\tuns=%ld\t", etapes, uns);
+    ecrire_castor(e->sortie, m, e->n);
+    fprintf(e->sortie, "\t%s%s\n", etapes_battu ? "(etapes)" : "", 
+            uns_battu ? "(uns)" : "");
+    fflush(e->sortie);
+  }
+  pthread_mutex_unlock(&e->verrou_sortie);
+}
+
+/**
+* Crée les machines filles d'une machine arrivée sur une transition non
+* définie : toutes les façons de définir cette transition, vers un état
+* déjà utilisé ou vers le premier état non utilisé
+*/
+static void developper(enumeration e, int id, castor *m, int t) {
+  int nb_cibles = m->nb_etats < e->n ? m->nb_etats + 1 : e->n;
+  for(int ecrit = 0; ecrit < 2; ecrit++) {
+    for(int d = -1; d <= 1; d += 2) {
+      for(int cible = 0; cible < nb_cibles; cible++) {
+        // La première transition est fixée à 1RB
+        if(m->nb_definies == 0 && e->n > 1 
+           && (ecrit != 1 || d != 1 || cible != 1)) continue;
+        castor fille = *m;
+        fille.ecrit[t] = ecrit;
+        fille.deplacement[t] = d;
+        fille.suivant[t] = cible;
+        fille.nb_definies++;
+        if(cible == fille.nb_etats) fille.nb_etats++;
+        __atomic_add_fetch(&e->en_attente, 1, __ATOMIC_RELEASE);
+        if(!empiler(&e->files[id], &fille)) {
+          perror("Erreur d'allocation de la file de tâches.\n");
+          __atomic_sub_fetch(&e->en_attente, 1, __ATOMIC_RELEASE);
+        }
+      }
+    }
+  }
+}
+
+static void* travailleur(void *arg) {
+  struct travailleur_s *tr = (struct travailleur_s*) arg;
+  enumeration e = tr->e;
+  ruban r = init_ruban("", 0);
+  castor m;
+  long etapes, tete;
+  // Attend que le thread principal ait créé tous les threads
+  pthread_mutex_lock(&e->depart);
+  pthread_mutex_unlock(&e->depart);
+  if(!r) return NULL;
+
+  while(obtenir_tache(e, tr->id, &m)) {
+    tr->stats.machines++;
+    int t = simuler_castor(&m, r, e->max_etapes, &etapes, &tete);
+    tr->stats.etapes += etapes;
+    if(t >= 0) {
+      // La machine s'arrête : la transition d'arrêt (1RZ) compte comme 
+      // une étape et écrit un 1
+      tr->stats.arrets++;
+      long uns = compter_uns(r) + (*ruban_case(r, tete) == 0);
+      verifier_champion(e, &m, etapes + 1, uns);
+      // Tant qu'il reste une autre transition non définie, on peut 
+      // définir celle-ci sans empêcher la machine de s'arrêter
+      if(m.nb_definies < 2 * e->n - 1) developper(e, tr->id, &m, t);
+    } else {
+      tr->stats.holdouts++;
+      pthread_mutex_lock(&e->verrou_sortie);
+      fputs("HOLDOUT\t", e->sortie);
+      ecrire_castor(e->sortie, &m, e->n);
+      fputc('\n', e->sortie);
+      pthread_mutex_unlock(&e->verrou_sortie);
+    }
+    __atomic_sub_fetch(&e->en_attente, 1, __ATOMIC_RELEASE);
+  }
+  free_ruban(r);
+  return NULL;
+}
+
+int enumerer_castors(int n, long max_etapes, int nb_threads, FILE *sortie) {
+  if(n < 1 || n > MAX_ETATS_CASTOR) {
+    fprintf(stderr, "\n[ERR]: Le nombre d'états doit être compris entre "
+            "1 et %d\n\n", MAX_ETATS_CASTOR);
+    return 1;
+  }
+  struct enumeration_s e;
+  e.n = n;
+  e.max_etapes = max_etapes;
+  e.nb_threads = nb_threads;
+  e.en_attente = 1;
+  e.champion_etapes = 0;
+  e.champion_uns = -1;
+  e.sortie = sortie;
+  pthread_mutex_init(&e.verrou_sortie, NULL);
+  e.files = (struct file_taches_s*) calloc(nb_threads, 
+                                           sizeof(struct file_taches_s));
+  struct travailleur_s *trs = (struct travailleur_s*) calloc(nb_threads, 
+                                           sizeof(struct travailleur_s));
+  pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * nb_threads);
+  int erreur = !e.files || !trs || !threads;
+  for(int i = 0; !erreur && i < nb_threads; i++) {
+    pthread_mutex_init(&e.files[i].verrou, NULL);
+    e.files[i].capacite = CAPACITE_FILE_INITIALE;
+    e.files[i].taches = (castor*) malloc(sizeof(castor) 
+                                         * CAPACITE_FILE_INITIALE);
+    if(!e.files[i].taches) erreur = 1;
+  }
+  if(erreur) {
+    perror("Erreur d'allocation de la mémoire de l'énumération.\n");
+    if(e.files) 
+      for(int i = 0; i < nb_threads; i++) free(e.files[i].taches);
+    free(e.files);
+    free(trs);
+    free(threads);
+    return 1;
+  }
+
+  // La machine racine n'a aucune transition définie
+  castor racine;
+  memset(&racine, 0, sizeof(castor));
+  memset(racine.suivant, -1, sizeof(racine.suivant));
+  racine.nb_etats = 1;
+  empiler(&e.files[0], &racine);
+
+  // Les tâches ne sont réparties qu'entre les threads qui ont pu être 
+  // créés ; la machine racine est dans la file du premier
+  double debut = horloge_secondes();
+  int lances = 0;
+  pthread_mutex_init(&e.depart, NULL);
+  pthread_mutex_lock(&e.depart);
+  for(; lances < nb_threads; lances++) {
+    trs[lances].e = &e;
+    trs[lances].id = lances;
+    if(pthread_create(&threads[lances], NULL, travailleur, &trs[lances]))
+      break;
+  }
+  e.nb_threads = lances;
+  pthread_mutex_unlock(&e.depart);
+  if(!lances) 
+    fprintf(stderr, "\n[ERR]: Echec de la création des threads de "
+            "l'énumération\n\n");
+  struct statistiques_s total = { 0, 0, 0, 0 };
+  for(int i = 0; i < lances; i++) {
+    pthread_join(threads[i], NULL);
+    total.machines += trs[i].stats.machines;
+    total.arrets += trs[i].stats.arrets;
+    total.holdouts += trs[i].stats.holdouts;
+    total.etapes += trs[i].stats.etapes;
+  }
+  double duree = horloge_secondes() - debut;
+  if(duree <= 0) duree = 1e-9;
+  fflush(sortie);
+
+  if(lances)
+    fprintf(stderr, "\n[CASTOR]: %d états, limite de %ld étapes : %ld "
+            "machines (%ld s'arrêtent, %ld holdouts) sur %d threads en "
+            "%.3f s\n"
+            "[CASTOR]: champions : %ld étapes, %ld uns\n"
+            "[CASTOR]: %.0f machines/min, %.0f étapes/s\n",
+            n, max_etapes, total.machines, total.arrets, total.holdouts, 
+            lances, duree, e.champion_etapes, e.champion_uns, 
+            total.machines / duree * 60, total.etapes / duree);
+
+  for(int i = 0; i < nb_threads; i++) {
+    pthread_mutex_destroy(&e.files[i].verrou);
+    free(e.files[i].taches);
+  }
+  pthread_mutex_destroy(&e.verrou_sortie);
+  pthread_mutex_destroy(&e.depart);
+  free(e.files);
+  free(trs);
+  free(threads);
+  return !lances;
+}
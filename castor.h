@@ -0,0 +1,35 @@
+#ifndef _castor_h_
+#define _castor_h_
+
+#include <stdio.h>
+
+/**
+* Nombre maximal d'états des machines énumérées
+*/
+#define MAX_ETATS_CASTOR 8
+
+/**
+* Énumère l'espace des machines de Turing à n états et 2 symboles
+* (0 étant le symbole blanc) en forme normale arborescente, pour la 
+* recherche du castor affairé. Les machines sont construites en 
+* mémoire : chaque machine est exécutée jusqu'à ce qu'elle lise une 
+* transition non définie, qui est alors soit l'arrêt de la machine, 
+* soit définie de toutes les façons possibles (machines filles). 
+* Les états sont numérotés dans l'ordre de leur première utilisation et
+* la première transition est fixée à 1RB. Les machines sont réparties 
+* sur plusieurs threads par vol de tâches.
+* Sont écrites au fur et à mesure sur la sortie : les machines qui 
+* atteignent la limite d'étapes ('HOLDOUT') et chaque nouveau champion 
+* du nombre d'étapes ou du nombre de 1 ('CHAMPION'), au format 
+* '1RB1LC_1RC1RB_...' ('---' pour une transition d'arrêt). 
+* Un résumé est affiché sur la sortie d'erreur.
+* @param n : le nombre d'états, entre 1 et MAX_ETATS_CASTOR
+* @param max_etapes : le nombre maximal d'étapes de chaque machine
+* @param nb_threads : le nombre de threads
+* @param sortie : le fichier où écrire les résultats
+* @return 0 en cas de succès, 1 en cas d'erreur
+*/
+int enumerer_castors(int n, long max_etapes, int nb_threads, FILE *sortie);
+
+
+#endif
@@ -0,0 +1,450 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dictionnaire.h"
+#include "chargeur.h"
+
+// Taille minimale d'un morceau analysé par un thread
+#define TAILLE_MIN_MORCEAU (1L << 20)
+// Nombre maximal de morceaux (et de threads)
+#define MAX_MORCEAUX 64
+
+/**
+* Vue sur une partie du fichier projeté (non terminée par '\0')
+*/
+struct vue_s {
+  const char *debut;
+  size_t longueur;
+};
+
+/**
+* Erreurs de syntaxe de la description d'une machine
+*/
+enum erreur_chargement {
+  ERREUR_AUCUNE,
+  ERREUR_MOT_CLE,
+  ERREUR_ETAT_SPECIAL,
+  ERREUR_FORMAT,
+  ERREUR_MOUVEMENT,
+  ERREUR_ETAT,
+  ERREUR_SYMBOLE,
+  ERREUR_ALLOCATION
+};
+
+/**
+* Transition lue dans un morceau, avec les identifiants des états dans
+* le dictionnaire du morceau
+*/
+struct transition_lue_s {
+  int32_t etat;
+  int32_t nouvel_etat;
+  char symbole_lu;
+  char symbole_ecrit;
+  char mouvement;
+};
+
+/**
+* Morceau du fichier et résultat de son analyse.
+* debut / fin -> les limites du morceau dans la projection
+* mt -> la machine (alphabets et symbole blanc)
+* noms -> les noms des états du morceau (vues sur le fichier)
+* transitions / nb_transitions / capacite -> les transitions lues
+* nb_lignes -> le nombre de lignes du morceau
+* etat_in / etat_fin -> la dernière déclaration de l'état initial / 
+*                       final du morceau (longueur 0 si absente)
+* erreur -> la première erreur du morceau (enum erreur_chargement)
+* ligne_erreur -> la ligne de l'erreur, relative au morceau
+* ligne / champ -> la ligne et le champ erronés
+* attendu -> le mot clé ou l'alphabet attendu
+*/
+struct morceau_s {
+  const char *debut;
+  const char *fin;
+  MT mt;
+  dictionnaire noms;
+  struct transition_lue_s *transitions;
+  long nb_transitions;
+  long capacite;
+  long nb_lignes;
+  struct vue_s etat_in;
+  struct vue_s etat_fin;
+  int erreur;
+  long ligne_erreur;
+  struct vue_s ligne;
+  struct vue_s champ;
+  const char *attendu;
+};
+typedef struct morceau_s* morceau;
+
+/**
+* Supprime les espaces au début et à la fin d'une vue
+*/
+static struct vue_s trim_vue(const char *debut, const char *fin) {
+  while(debut < fin && isspace((unsigned char) *debut)) debut++;
+  while(fin > debut && isspace((unsigned char) fin[-1])) fin--;
+  struct vue_s v = { debut, fin - debut };
+  return v;
+}
+
+/**
+* Renvoie le prochain champ non vide d'une ligne, les champs étant 
+* séparés par un délimiteur (les champs vides sont ignorés)
+* @param p : la position courante dans la ligne, mise à jour
+* @param fin : la fin de la ligne
+* @param delim : le délimiteur
+* @param champ : le champ lu
+* @return 1 si un champ a été lu, 0 s'il n'y en a plus
+*/
+static int champ_suivant(const char **p, const char *fin, char delim, 
+                         struct vue_s *champ) {
+  const char *q = *p;
+  while(q < fin && *q == delim) q++;
+  if(q == fin) return 0;
+  const char *debut = q;
+  while(q < fin && *q != delim) q++;
+  champ->debut = debut;
+  champ->longueur = q - debut;
+  *p = q;
+  return 1;
+}
+
+/**
+* Enregistre la première erreur d'un morceau
+*/
+static int erreur(morceau m, int type, long ligne, struct vue_s texte, 
+                  struct vue_s champ, const char *attendu) {
+  m->erreur = type;
+  m->ligne_erreur = ligne;
+  m->ligne = texte;
+  m->champ = champ;
+  m->attendu = attendu;
+  return 0;
+}
+
+/**
+* Analyse la déclaration d'un état spécial ('init: etat' ou 
+* 'accept: etat')
+* @param m : le morceau
+* @param ligne : la ligne (sans espaces au début et à la fin)
+* @param n : le numéro de la ligne dans le morceau
+* @param constante : le mot clé attendu
+* @param etat : l'état déclaré
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int lire_etat_special(morceau m, struct vue_s ligne, long n,
+                             const char *constante, struct vue_s *etat) {
+  const char *p = ligne.debut, *fin = ligne.debut + ligne.longueur;
+  struct vue_s champ = { ligne.debut, 0 };
+  champ_suivant(&p, fin, ':', &champ);
+  struct vue_s mot = trim_vue(champ.debut, champ.debut + champ.longueur);
+  if(mot.longueur != strlen(constante) 
+     || memcmp(mot.debut, constante, mot.longueur))
+    return erreur(m, ERREUR_MOT_CLE, n, ligne, mot, constante);
+  if(!champ_suivant(&p, fin, ':', &champ) 
+     || (*etat = trim_vue(champ.debut, champ.debut + champ.longueur))
+        .longueur == 0)
+    return erreur(m, ERREUR_ETAT_SPECIAL, n, ligne, champ, constante);
+  return 1;
+}
+
+/**
+* Analyse une transition ('etat,symbole_lu,nouvel_etat,symbole_ecrit,
+* mouvement') et l'ajoute aux transitions du morceau
+* @param m : le morceau
+* @param ligne : la ligne (sans espaces au début et à la fin)
+* @param n : le numéro de la ligne dans le morceau
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int lire_transition(morceau m, struct vue_s ligne, long n) {
+  // Alphabet de chaque champ : NULL pour un état, "" pour le mouvement
+  const char *alphabets[5] = { NULL, m->mt->alphabet_entree, NULL, 
+                               m->mt->alphabet_travail, "" };
+  const char *p = ligne.debut, *fin = ligne.debut + ligne.longueur;
+  char sb = m->mt->symbole_blanc;
+  struct vue_s champs[5];
+
+  for(int i = 0; i < 5; i++) {
+    struct vue_s brut = { NULL, 0 };
+    if(!champ_suivant(&p, fin, ',', &brut)) 
+      return erreur(m, ERREUR_FORMAT, n, ligne, brut, NULL);
+    // Si le champ est le symbole blanc, il est gardé tel quel : c'est
+    // nécessaire lorsque le symbole blanc est un espace
+    if(brut.longueur == 1 && brut.debut[0] == sb) {
+      champs[i] = brut;
+      continue;
+    }
+    struct vue_s c = trim_vue(brut.debut, brut.debut + brut.longueur);
+    const char *alpha = alphabets[i];
+    if(alpha == NULL) {
+      // Un état est une chaine de caractères non vide
+      if(c.longueur == 0) 
+        return erreur(m, ERREUR_ETAT, n, ligne, c, NULL);
+    } else if(*alpha == '\0') {
+      if(c.longueur != 1 || (c.debut[0] != DROITE 
+         && c.debut[0] != GAUCHE && c.debut[0] != AUCUN))
+        return erreur(m, ERREUR_MOUVEMENT, n, ligne, c, NULL);
+    } else if(c.longueur != 1 || 
+              (strchr(alpha, c.debut[0]) == NULL && c.debut[0] != sb)) {
+      return erreur(m, ERREUR_SYMBOLE, n, ligne, c, alpha);
+    }
+    champs[i] = c;
+  }
+
+  if(m->nb_transitions == m->capacite) {
+    long capacite = m->capacite ? m->capacite * 2 : 1024;
+    struct transition_lue_s *t = (struct transition_lue_s*) 
+      realloc(m->transitions, sizeof(struct transition_lue_s) * capacite);
+    if(!t) return erreur(m, ERREUR_ALLOCATION, n, ligne, ligne, NULL);
+    m->transitions = t;
+    m->capacite = capacite;
+  }
+  struct transition_lue_s *t = &m->transitions[m->nb_transitions];
+  t->etat = dictionnaire_ajouter(m->noms, champs[0].debut, 
+                                 champs[0].longueur);
+  t->nouvel_etat = dictionnaire_ajouter(m->noms, champs[2].debut, 
+                                        champs[2].longueur);
+  if(t->etat < 0 || t->nouvel_etat < 0) 
+    return erreur(m, ERREUR_ALLOCATION, n, ligne, ligne, NULL);
+  t->symbole_lu = champs[1].debut[0];
+  t->symbole_ecrit = champs[3].debut[0];
+  t->mouvement = champs[4].debut[0];
+  m->nb_transitions++;
+  return 1;
+}
+
+/**
+* Analyse les lignes d'un morceau, jusqu'à la fin du morceau ou jusqu'à
+* la première erreur
+*/
+static void* analyser_morceau(void *arg) {
+  morceau m = (morceau) arg;
+  const char *p = m->debut;
+  long n = 0;
+  while(p < m->fin) {
+    const char *fin_ligne = memchr(p, '\n', m->fin - p);
+    if(!fin_ligne) fin_ligne = m->fin;
+    n++;
+    struct vue_s ligne = trim_vue(p, fin_ligne);
+    p = fin_ligne + 1;
+    if(ligne.longueur == 0) continue;
+
+    // Les déclarations des états spéciaux (initial ou final) commencent
+    // respectivement par 'init' et 'accept', les autres lignes sont des
+    // transitions
+    int ok;
+    if(ligne.longueur >= 4 && !memcmp(ligne.debut, "init", 4))
+      ok = lire_etat_special(m, ligne, n, "init", &m->etat_in);
+    else if(ligne.longueur >= 6 && !memcmp(ligne.debut, "accept", 6))
+      ok = lire_etat_special(m, ligne, n, "accept", &m->etat_fin);
+    else 
+      ok = lire_transition(m, ligne, n);
+    if(!ok) break;
+  }
+  m->nb_lignes = n;
+  return NULL;
+}
+
+/**
+* Affiche l'erreur d'un morceau
+* @param m : le morceau
+* @param premiere_ligne : le numéro dans le fichier de la ligne qui 
+*                         précède le morceau
+*/
+static void afficher_erreur(morceau m, long premiere_ligne) {
+  long ligne = premiere_ligne + m->ligne_erreur;
+  int nl = (int) m->ligne.longueur, nc = (int) m->champ.longueur;
+  switch(m->erreur) {
+    case ERREUR_MOT_CLE:
+      fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine, ligne "
+              "%ld : '%s' est attendu, '%.*s' trouvé\n\n", ligne, 
+              m->attendu, nc, m->champ.debut);
+      return;
+    case ERREUR_ETAT_SPECIAL:
+      fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine, ligne "
+              "%ld : un état est attendu après %s\n\n", ligne, m->attendu);
+      return;
+    case ERREUR_ALLOCATION:
+      perror("Erreur d'allocation lors de la lecture de la machine.\n");
+      return;
+  }
+  fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine :\n"
+          "Ligne %ld : %.*s\n"
+          "Une transition doit être du format " 
+          "etat,symbole_lu,nouvel_etat,symbole_ecrit,mouvement\n",
+          ligne, nl, m->ligne.debut);
+  if(m->erreur == ERREUR_MOUVEMENT) 
+    fprintf(stderr, "Le mouvement '%.*s' n'est pas valide. "
+            "Les mouvements possibles sont : '<' , '>' et '-'\n\n", 
+            nc, m->champ.debut);
+  else if(m->erreur == ERREUR_ETAT) 
+    fprintf(stderr, "L'état '%.*s' n'est pas valide. "
+            "Un état doit être une chaîne caractères non vide.\n\n", 
+            nc, m->champ.debut);
+  else if(m->erreur == ERREUR_SYMBOLE)
+    fprintf(stderr, "Le symbole '%.*s' n'est pas valide. "
+            "Il doit être un caractère dans l'alphabet d'entrée/de "
+            "travail '%s'\n\n", nc, m->champ.debut, m->attendu);
+  else 
+    fprintf(stderr, "\n");
+}
+
+/**
+* Ajoute les transitions d'un morceau à la machine : les noms des états 
+* du morceau sont internalisés dans mt->noms
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int fusionner_morceau(MT mt, morceau m) {
+  int *globaux = (int*) malloc(sizeof(int) * (m->noms->nb + 1));
+  if(!globaux) return 0;
+  for(int i = 0; i < m->noms->nb; i++) {
+    globaux[i] = dictionnaire_ajouter(mt->noms, m->noms->chaines[i], 
+                                      m->noms->longueurs[i]);
+    if(globaux[i] < 0) {
+      free(globaux);
+      return 0;
+    }
+  }
+  char **noms = mt->noms->chaines;
+  for(long i = 0; i < m->nb_transitions; i++) {
+    struct transition_lue_s *t = &m->transitions[i];
+    transition tr = creer_transition(mt->arene, 
+                      noms[globaux[t->etat]], t->symbole_lu, 
+                      t->symbole_ecrit, t->mouvement, 
+                      noms[globaux[t->nouvel_etat]]);
+    if(!tr) {
+      free(globaux);
+      return 0;
+    }
+    tr->id_etat = globaux[t->etat];
+    tr->id_nouvel_etat = globaux[t->nouvel_etat];
+    ajouter_transition(mt, tr);
+  }
+  free(globaux);
+  return 1;
+}
+
+/**
+* Internalise un état spécial dans mt->noms
+* @return le nom internalisé, NULL en cas d'erreur
+*/
+static char* interner_etat(MT mt, struct vue_s etat) {
+  int id = dictionnaire_ajouter(mt->noms, etat.debut, etat.longueur);
+  return id < 0 ? NULL : mt->noms->chaines[id];
+}
+
+int charger_transitions(MT mt, const char *path) {
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if(fd < 0 || fstat(fd, &st) != 0) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", path);
+    perror("\n\n");
+    if(fd >= 0) close(fd);
+    return 0;
+  }
+  size_t taille = st.st_size;
+  const char *contenu = "";
+  void *projection = NULL;
+  if(taille > 0) {
+    projection = mmap(NULL, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(projection == MAP_FAILED) {
+      fprintf(stderr, "\n[ERR]: Echec de la projection du fichier %s", 
+              path);
+      perror("\n\n");
+      close(fd);
+      return 0;
+    }
+    contenu = (const char*) projection;
+    madvise(projection, taille, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  // Découpage en morceaux commençant chacun au début d'une ligne
+  long nb_morceaux = sysconf(_SC_NPROCESSORS_ONLN);
+  if(nb_morceaux > (long) (taille / TAILLE_MIN_MORCEAU)) 
+    nb_morceaux = taille / TAILLE_MIN_MORCEAU;
+  if(nb_morceaux > MAX_MORCEAUX) nb_morceaux = MAX_MORCEAUX;
+  if(nb_morceaux < 1) nb_morceaux = 1;
+  struct morceau_s morceaux[MAX_MORCEAUX];
+  pthread_t threads[MAX_MORCEAUX];
+  memset(morceaux, 0, sizeof(morceaux));
+  const char *debut = contenu, *fin_fichier = contenu + taille;
+  int ok = 1;
+  for(long i = 0; i < nb_morceaux; i++) {
+    const char *fin = i == nb_morceaux - 1 ? fin_fichier 
+                      : contenu + taille / nb_morceaux * (i + 1);
+    if(fin < debut) fin = debut;
+    const char *nl = memchr(fin, '\n', fin_fichier - fin);
+    if(i < nb_morceaux - 1) fin = nl ? nl + 1 : fin_fichier;
+    morceaux[i].debut = debut;
+    morceaux[i].fin = fin;
+    morceaux[i].mt = mt;
+    morceaux[i].noms = init_dictionnaire_vues();
+    if(!morceaux[i].noms) ok = 0;
+    debut = fin;
+  }
+
+  // Analyse en parallèle des morceaux
+  int lances = 0;
+  if(ok) {
+    for(; lances < nb_morceaux - 1; lances++) 
+      if(pthread_create(&threads[lances], NULL, analyser_morceau, 
+                        &morceaux[lances + 1]))
+        break;
+    analyser_morceau(&morceaux[0]);
+    // Les morceaux dont le thread n'a pas pu être créé sont analysés ici
+    for(long i = lances + 1; i < nb_morceaux; i++) 
+      analyser_morceau(&morceaux[i]);
+    for(int i = 0; i < lances; i++) pthread_join(threads[i], NULL);
+  }
+
+  // Fusion des morceaux dans l'ordre du fichier
+  long premiere_ligne = 0;
+  struct vue_s etat_in = { NULL, 0 }, etat_fin = { NULL, 0 };
+  for(long i = 0; ok && i < nb_morceaux; i++) {
+    morceau m = &morceaux[i];
+    if(m->erreur) {
+      afficher_erreur(m, premiere_ligne);
+      ok = 0;
+      break;
+    }
+    if(!fusionner_morceau(mt, m)) {
+      perror("Erreur d'allocation lors de la lecture de la machine.\n");
+      ok = 0;
+      break;
+    }
+    if(m->etat_in.longueur) etat_in = m->etat_in;
+    if(m->etat_fin.longueur) etat_fin = m->etat_fin;
+    premiere_ligne += m->nb_lignes;
+  }
+
+  // Si l'état initial ou l'état final n'ont pas été configuré dans le 
+  // code de la machine, on renvoie une erreur. Ces états sont 
+  // obligatoires
+  if(ok && (!etat_in.longueur || !etat_fin.longueur)) {
+    fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine : "
+            "Les états initiaux et/ou finaux sont manquants\n");
+    ok = 0;
+  }
+  if(ok) {
+    mt->etat_in = interner_etat(mt, etat_in);
+    mt->etat_fin = interner_etat(mt, etat_fin);
+    if(!mt->etat_in || !mt->etat_fin) {
+      perror("Erreur d'allocation lors de la lecture de la machine.\n");
+      ok = 0;
+    }
+  }
+
+  for(long i = 0; i < nb_morceaux; i++) {
+    free_dictionnaire(morceaux[i].noms);
+    free(morceaux[i].transitions);
+  }
+  if(projection) munmap(projection, taille);
+  return ok;
+}
@@ -0,0 +1,26 @@
+#ifndef _chargeur_h_
+#define _chargeur_h_
+
+#include "machineturing.h"
+
+/**
+* Lit la description textuelle d'une machine de Turing (voir 
+* init_machine_turing()) : renseigne son état initial, son état final 
+* et ses transitions, dans l'ordre du fichier.
+* Le fichier est projeté en mémoire (mmap) et découpé en morceaux 
+* alignés sur les débuts de ligne, analysés en parallèle : les champs 
+* sont des vues sur le fichier (aucune copie par ligne ni par champ) et
+* les noms d'états de chaque morceau sont internalisés dans un 
+* dictionnaire local, fusionnés ensuite dans mt->noms. Les noms des 
+* états des transitions pointent dans mt->noms.
+* En cas d'erreur, l'erreur affichée est la première du fichier, avec
+* son numéro de ligne.
+* @param mt : la machine, dont les alphabets et le symbole blanc sont 
+*             renseignés et mt->noms alloué
+* @param path : chemin vers le fichier de description
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int charger_transitions(MT mt, const char *path);
+
+
+#endif
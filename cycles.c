@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "hachage.h"
+#include "cycles.h"
+
+/**
+* Hachage du contenu d'une case : les cases blanches ne contribuent 
+* pas au hachage du ruban, qui est le XOR des hachages de ses cases
+*/
+static inline uint64_t hachage_case(long position, cellule symbole, 
+                                    cellule blanc) {
+  if(symbole == blanc) return 0;
+  return hachage_melanger(((uint64_t) position << 8) ^ symbole);
+}
+
+/**
+* Calcule le hachage du ruban d'une configuration en le parcourant
+*/
+static uint64_t hachage_ruban(configuration c) {
+  ruban r = c->ruban_courant;
+  uint64_t h = 0;
+  for(long p = r->min; p <= r->max; p++) 
+    h ^= hachage_case(p, *ruban_case(r, p), r->symbole_blanc);
+  return h;
+}
+
+/**
+* Hachage d'une configuration, à partir du hachage de son ruban
+*/
+static inline uint64_t hachage_configuration(configuration c, uint64_t h) {
+  return h ^ hachage_melanger(hachage_melanger(c->etat_courant) 
+                              ^ (uint64_t) c->tete_lecture);
+}
+
+/**
+* Exécute une étape de calcul en mettant à jour le hachage du ruban
+* @param c : la configuration, mise à jour
+* @param h : le hachage du ruban, mis à jour
+* @return 0 si la machine est arrêtée, 1 sinon
+*/
+static int etape_hachee(configuration c, uint64_t *h) {
+  table_transitions table = c->mt->table;
+  ruban r = c->ruban_courant;
+  if(c->etat_courant == table->etat_fin) return 0;
+  cellule *s = ruban_case(r, c->tete_lecture);
+  int32_t i = table_chercher(table, c->etat_courant, *s);
+  if(i < 0) return 0;
+  regle rg = &table->regles[i];
+  *h ^= hachage_case(c->tete_lecture, *s, r->symbole_blanc) 
+        ^ hachage_case(c->tete_lecture, rg->symbole_ecrit, r->symbole_blanc);
+  *s = rg->symbole_ecrit;
+  c->etat_courant = rg->nouvel_etat;
+  c->nb_etapes++;
+  return ruban_deplacer(r, &c->tete_lecture, rg->deplacement);
+}
+
+/**
+* Recherche le début d'un cycle de période connue : une configuration 
+* partie du début de l'exécution et une autre partie 'periode' étapes
+* plus loin avancent ensemble jusqu'à se rencontrer
+* @param initiale : la configuration de début de l'exécution (modifiée)
+* @param periode : la période du cycle
+* @return l'étape de début du cycle, -1 en cas d'erreur
+*/
+static long debut_cycle(configuration initiale, long periode) {
+  configuration avance = copier_configuration(initiale);
+  if(!avance) return -1;
+  uint64_t h = hachage_ruban(initiale), h_avance = h;
+  for(long i = 0; i < periode; i++) etape_hachee(avance, &h_avance);
+  while(hachage_configuration(initiale, h) 
+          != hachage_configuration(avance, h_avance)
+        || !configurations_egales(initiale, avance)) {
+    etape_hachee(initiale, &h);
+    etape_hachee(avance, &h_avance);
+  }
+  free_configuration(avance);
+  return initiale->nb_etapes;
+}
+
+int executer_cycles(configuration c, limites l) {
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  double debut = horloge_secondes();
+  configuration initiale = copier_configuration(c);
+  configuration tortue = copier_configuration(c);
+  if(!initiale || !tortue) {
+    perror("Erreur d'allocation de la mémoire de la détection des cycles.\n");
+    free_configuration(initiale);
+    free_configuration(tortue);
+    return -1;
+  }
+
+  // Algorithme de Brent : la configuration courante est comparée à la 
+  // configuration 'tortue', sauvegardée à chaque fois que le nombre 
+  // d'étapes depuis la sauvegarde atteint une puissance de 2
+  uint64_t h = hachage_ruban(c);
+  uint64_t h_tortue = hachage_configuration(c, h);
+  long puissance = 1, lambda = 0;
+  int res;
+  for(;;) {
+    if(c->nb_etapes >= limite || (c->nb_etapes % TRANCHE_HORLOGE == 0 
+                                  && delai_depasse(l, debut))) {
+      res = resultat_configuration(c, 1);
+      break;
+    }
+    if(!etape_hachee(c, &h)) {
+      res = resultat_configuration(c, 0);
+      break;
+    }
+    lambda++;
+    uint64_t hc = hachage_configuration(c, h);
+    if(hc == h_tortue && configurations_egales(c, tortue)) {
+      res = RESULTAT_BOUCLE;
+      c->periode_cycle = lambda;
+      c->debut_cycle = debut_cycle(initiale, lambda);
+      if(c->debut_cycle < 0) {
+        perror("Erreur d'allocation de la mémoire de la détection des "
+               "cycles.\n");
+        res = -1;
+      }
+      break;
+    }
+    if(lambda == puissance) {
+      free_configuration(tortue);
+      if(!(tortue = copier_configuration(c))) {
+        perror("Erreur d'allocation de la mémoire de la détection des "
+               "cycles.\n");
+        res = -1;
+        break;
+      }
+      h_tortue = hc;
+      puissance *= 2;
+      lambda = 0;
+    }
+  }
+
+  free_configuration(initiale);
+  free_configuration(tortue);
+  return res;
+}
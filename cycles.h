@@ -0,0 +1,24 @@
+#ifndef _cycles_h_
+#define _cycles_h_
+
+#include "machineturing.h"
+
+/**
+* Exécute une machine de Turing en détectant les cycles de 
+* configurations (état, position de la tête et contenu du ruban). 
+* Chaque configuration est résumée par un hachage mis à jour à chaque
+* case écrite, sans reparcourir le ruban ; les configurations sont 
+* comparées selon l'algorithme de Brent (comparaison avec la 
+* configuration sauvegardée à chaque puissance de 2), et toute égalité
+* des hachages est vérifiée sur les configurations complètes. 
+* Si un cycle est trouvé, son début et sa période sont stockés dans 
+* c->debut_cycle et c->periode_cycle.
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée)
+* @return le résultat de l'exécution (enum resultat), RESULTAT_BOUCLE 
+*         si la machine ne s'arrêtera jamais, -1 en cas d'erreur
+*/
+int executer_cycles(configuration c, limites l);
+
+
+#endif
@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <readline/readline.h>
+#include <readline/history.h>
+
+#include "debogueur.h"
+#include "journal.h"
+
+/**
+* Affiche l'aide des commandes du débogueur
+*/
+static void afficher_aide() {
+  printf("Commandes :\n"
+         "  s [N]  avance de N étapes (1 par défaut)\n"
+         "  r [N]  recule de N étapes (1 par défaut)\n"
+         "  a N    va à l'étape N\n"
+         "  c      continue jusqu'à l'arrêt de la machine\n"
+         "  p      affiche la configuration\n"
+         "  j      affiche l'état du journal\n"
+         "  q      quitte\n"
+         "Une ligne vide répète la dernière commande.\n");
+}
+
+/**
+* Lit l'argument entier d'une commande
+* @param texte : le texte qui suit la commande
+* @param defaut : la valeur si l'argument est absent, -1 s'il est
+*                 obligatoire
+* @return l'argument, -1 s'il est absent (et obligatoire) ou invalide
+*/
+static long lire_argument(const char *texte, long defaut) {
+  while(*texte == ' ' || *texte == '\t') texte++;
+  if(!*texte) return defaut;
+  char *fin;
+  long n = strtol(texte, &fin, 10);
+  while(*fin == ' ' || *fin == '\t') fin++;
+  return *fin || n < 0 ? -1 : n;
+}
+
+/**
+* Affiche l'état du journal : étapes annulables et points de reprise
+*/
+static void afficher_journal(journal j, configuration c) {
+  printf("Étape %ld ; %ld étapes annulables avec le journal (capacité "
+         "%ld) ; %d points de reprise :", c->nb_etapes, j->nb,
+         j->capacite, j->nb_points);
+  for(int i = 0; i < j->nb_points; i++)
+    printf(" %ld", j->points[i]->nb_etapes);
+  printf("\n");
+}
+
+int deboguer(configuration c, trace t, limites l, long capacite,
+             long intervalle) {
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  journal j = init_journal(c, capacite, intervalle);
+  char *derniere = j ? strdup("s") : NULL;
+  if(!derniere) {
+    free_journal(j);
+    return -1;
+  }
+
+  afficher_machine_turing(c, t);
+  printf("Débogueur : 'h' pour l'aide\n");
+  char *ligne;
+  int erreur = 0;
+  while((ligne = readline("(mt) ")) != NULL) {
+    // Une ligne vide répète la dernière commande
+    if(*ligne) {
+      add_history(ligne);
+      free(derniere);
+      derniere = ligne;
+    } else {
+      free(ligne);
+    }
+    char commande = derniere[0];
+    long n = lire_argument(derniere + 1, commande == 'a' ? -1 : 1);
+    if(commande == 'q') break;
+    if(n < 0 && strchr("sra", commande)) {
+      printf("Argument invalide : '%s'\n", derniere + 1);
+      continue;
+    }
+    long depart = c->nb_etapes;
+    int res = 1;
+    j->derniere_reprise = -1;
+    switch(commande) {
+      case 's':
+        // L'avance s'arrête à la limite d'étapes
+        if(n > limite - c->nb_etapes) n = limite - c->nb_etapes;
+        res = journal_aller(j, c, c->nb_etapes + n);
+        break;
+      case 'r':
+        res = journal_aller(j, c, n > c->nb_etapes ? 0 : c->nb_etapes - n);
+        break;
+      case 'a':
+        res = journal_aller(j, c, n > limite ? limite : n);
+        break;
+      case 'c':
+        while(c->nb_etapes < limite && journal_avancer(j, c));
+        break;
+      case 'p':
+        afficher_ruban_machine(c, t);
+        continue;
+      case 'j':
+        afficher_journal(j, c);
+        continue;
+      default:
+        afficher_aide();
+        continue;
+    }
+    if(res < 0) {
+      perror("Erreur d'allocation lors du déplacement.\n");
+      erreur = 1;
+      break;
+    }
+    if(j->derniere_reprise >= 0)
+      printf("[JOURNAL]: reprise à l'étape %ld, %ld étapes rejouées\n",
+             j->derniere_reprise, c->nb_etapes - j->derniere_reprise);
+    else if(c->nb_etapes < depart)
+      printf("[JOURNAL]: %ld étapes annulées\n", depart - c->nb_etapes);
+    afficher_ruban_machine(c, t);
+    if(res == 0 || (commande == 'c' && c->nb_etapes < limite))
+      printf("La machine est arrêtée à l'étape %ld\n", c->nb_etapes);
+  }
+  free(derniere);
+  free_journal(j);
+  if(erreur) return -1;
+  return resultat_configuration(c, 1);
+}
@@ -0,0 +1,36 @@
+#ifndef _debogueur_h_
+#define _debogueur_h_
+
+#include "machineturing.h"
+
+/**
+* Exécute une machine pas à pas sous le contrôle de commandes lues sur
+* l'entrée standard (readline). Les étapes sont inscrites dans un
+* journal d'annulation (cf. journal.h) : la machine peut reculer ou
+* aller à une étape quelconque sans être réexécutée depuis le début.
+* Commandes (une ligne vide répète la dernière commande) :
+* s [N] -> avance de N étapes (1 par défaut)
+* r [N] -> recule de N étapes (1 par défaut)
+* a N -> va à l'étape N
+* c -> continue jusqu'à l'arrêt de la machine ou la limite d'étapes
+* p -> affiche la configuration
+* j -> affiche l'état du journal
+* q -> quitte le débogueur
+* h -> affiche l'aide
+* La configuration est affichée après chaque déplacement.
+* @param c : la configuration de départ, mise à jour
+* @param t : la trace utilisée pour afficher les configurations
+* @param l : les limites de l'exécution (seul le nombre maximal d'étapes
+*            est pris en compte), NULL pour ne pas limiter
+* @param capacite : le nombre d'entrées du journal
+* @param intervalle : le nombre d'étapes entre deux points de reprise,
+*                     0 pour ne garder que la configuration de départ
+* @return le résultat de l'exécution à la sortie du débogueur (enum
+*         resultat ; TIMEOUT si la machine pouvait encore avancer), -1
+*         en cas d'erreur
+*/
+int deboguer(configuration c, trace t, limites l, long capacite,
+             long intervalle);
+
+
+#endif
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hachage.h"
+#include "dictionnaire.h"
+
+#define TAILLE_INITIALE 16
+// Taille du premier bloc de l'arène propre d'un dictionnaire
+#define TAILLE_BLOC_CHAINES 4096
+
+
+/**
+* Crée un dictionnaire vide, qui copie ou non les chaines ajoutées
+* @param vues : 1 pour ne pas copier les chaines, 0 sinon
+* @param a : l'arène où copier les chaines, NULL pour en créer une 
+*            (ignorée pour un dictionnaire de vues)
+*/
+static dictionnaire creer_dictionnaire(int vues, arene a) {
+  dictionnaire d = (dictionnaire) malloc(sizeof(struct dictionnaire_s));
+  if(d == NULL) {
+    perror("Erreur d'allocation de la mémoire du dictionnaire.\n");
+    return NULL;
+  }
+  d->vues = vues;
+  d->arene = vues ? NULL : a;
+  d->arene_propre = !vues && !a;
+  d->nb = 0;
+  d->capacite = TAILLE_INITIALE;
+  d->chaines = (char**) malloc(sizeof(char*) * d->capacite);
+  d->longueurs = (size_t*) malloc(sizeof(size_t) * d->capacite);
+  d->taille_index = TAILLE_INITIALE * 2;
+  d->index = (struct case_index_s*) calloc(d->taille_index, 
+                                           sizeof(struct case_index_s));
+  if(d->arene_propre) d->arene = init_arene(TAILLE_BLOC_CHAINES);
+  if(!d->chaines || !d->longueurs || !d->index || (!vues && !d->arene)) {
+    perror("Erreur d'allocation de la mémoire du dictionnaire.\n");
+    free_dictionnaire(d);
+    return NULL;
+  }
+  return d;
+}
+
+dictionnaire init_dictionnaire() {
+  return creer_dictionnaire(0, NULL);
+}
+
+dictionnaire init_dictionnaire_arene(arene a) {
+  return creer_dictionnaire(0, a);
+}
+
+dictionnaire init_dictionnaire_vues() {
+  return creer_dictionnaire(1, NULL);
+}
+
+/**
+* Recherche la case de la table de hachage correspondant à une chaine : 
+* la case qui la contient, ou la case vide où l'insérer.
+*/
+static int case_index(dictionnaire d, const char *chaine, size_t longueur,
+                      uint32_t h) {
+  int masque = d->taille_index - 1;
+  int i = (int) (h & masque);
+  while(d->index[i].id) {
+    int id = d->index[i].id - 1;
+    if(d->index[i].hachage == h && d->longueurs[id] == longueur && 
+       !memcmp(d->chaines[id], chaine, longueur))
+      return i;
+    i = (i + 1) & masque;
+  }
+  return i;
+}
+
+/**
+* Double la taille de la table de hachage et y réinsère les chaines
+*/
+static int agrandir_index(dictionnaire d) {
+  struct case_index_s *ancien = d->index;
+  int ancienne_taille = d->taille_index;
+  d->taille_index *= 2;
+  d->index = (struct case_index_s*) calloc(d->taille_index, 
+                                           sizeof(struct case_index_s));
+  if(!d->index) {
+    d->index = ancien;
+    d->taille_index = ancienne_taille;
+    return 0;
+  }
+  // Les chaines étant distinctes, chacune va dans la première case vide
+  // à partir de la position donnée par son hachage
+  int masque = d->taille_index - 1;
+  for(int i = 0; i < ancienne_taille; i++) {
+    if(ancien[i].id) {
+      int j = (int) (ancien[i].hachage & masque);
+      while(d->index[j].id) j = (j + 1) & masque;
+      d->index[j] = ancien[i];
+    }
+  }
+  free(ancien);
+  return 1;
+}
+
+int dictionnaire_chercher(dictionnaire d, const char *chaine, 
+                          size_t longueur) {
+  uint32_t h = (uint32_t) hachage_melanger(
+                 hachage_fnv1a(FNV1A_BASE, chaine, longueur));
+  return d->index[case_index(d, chaine, longueur, h)].id - 1;
+}
+
+int dictionnaire_ajouter(dictionnaire d, const char *chaine, 
+                         size_t longueur) {
+  uint32_t h = (uint32_t) hachage_melanger(
+                 hachage_fnv1a(FNV1A_BASE, chaine, longueur));
+  int i = case_index(d, chaine, longueur, h);
+  if(d->index[i].id) return d->index[i].id - 1;
+
+  // Agrandissement des tableaux des chaines si nécessaire
+  if(d->nb == d->capacite) {
+    int capacite = d->capacite * 2;
+    char **chaines = (char**) realloc(d->chaines, sizeof(char*) * capacite);
+    if(!chaines) return -1;
+    d->chaines = chaines;
+    size_t *longueurs = (size_t*) realloc(d->longueurs, 
+                                          sizeof(size_t) * capacite);
+    if(!longueurs) return -1;
+    d->longueurs = longueurs;
+    d->capacite = capacite;
+  }
+
+  char *copie = (char*) chaine;
+  if(!d->vues && !(copie = arene_copier_chaine(d->arene, chaine, longueur)))
+    return -1;
+
+  int id = d->nb++;
+  d->chaines[id] = copie;
+  d->longueurs[id] = longueur;
+  d->index[i].id = id + 1;
+  d->index[i].hachage = h;
+
+  // On garde un taux de remplissage de la table inférieur à 1/2
+  if(d->nb * 2 > d->taille_index && !agrandir_index(d)) return -1;
+  return id;
+}
+
+void free_dictionnaire(dictionnaire d) {
+  if(!d) return;
+  // Les chaines copiées sont libérées avec l'arène
+  if(d->arene_propre) free_arene(d->arene);
+  free(d->chaines);
+  free(d->longueurs);
+  free(d->index);
+  free(d);
+}
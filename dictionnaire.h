@@ -0,0 +1,99 @@
+#ifndef _dictionnaire_h_
+#define _dictionnaire_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arene.h"
+
+/**
+* Structure de données permettant d'internaliser des chaines de 
+* caractères : chaque chaine distincte ajoutée reçoit un identifiant 
+* entier dense (0, 1, 2, ...) dans l'ordre de première insertion.
+* nb -> le nombre de chaines distinctes stockées
+* capacite -> la taille allouée des tableaux chaines et longueurs
+* chaines -> identifiant -> copie de la chaine (terminée par '\0'), ou
+*            la chaine ajoutée elle-même pour un dictionnaire de vues
+* longueurs -> identifiant -> longueur de la chaine
+* taille_index -> la taille de la table de hachage (puissance de 2)
+* index -> table de hachage à adressage ouvert : chaque case contient 
+*          identifiant + 1 (0 pour une case vide) et les 32 bits bas du 
+*          hachage de la chaine, comparés avant la chaine elle-même et 
+*          réutilisés lors de l'agrandissement de la table
+* vues -> 1 si les chaines ne sont pas copiées, 0 sinon
+* arene -> l'arène où sont copiées les chaines, NULL pour un dictionnaire
+*          de vues
+* arene_propre -> 1 si l'arène a été créée par le dictionnaire (et est
+*                 libérée avec lui), 0 si elle est partagée
+*/
+struct case_index_s {
+  int32_t id;
+  uint32_t hachage;
+};
+
+struct dictionnaire_s {
+  int vues;
+  arene arene;
+  int arene_propre;
+  int nb;
+  int capacite;
+  char **chaines;
+  size_t *longueurs;
+  int taille_index;
+  struct case_index_s *index;
+};
+typedef struct dictionnaire_s* dictionnaire;
+
+/**
+* Crée un dictionnaire vide, qui copie les chaines ajoutées dans sa 
+* propre arène
+* @return le dictionnaire créé, NULL en cas d'erreur
+*/
+dictionnaire init_dictionnaire();
+
+/**
+* Crée un dictionnaire vide qui copie les chaines ajoutées dans une 
+* arène partagée : les chaines restent valides jusqu'à la libération de
+* l'arène, même après celle du dictionnaire
+* @param a : l'arène où copier les chaines
+* @return le dictionnaire créé, NULL en cas d'erreur
+*/
+dictionnaire init_dictionnaire_arene(arene a);
+
+/**
+* Crée un dictionnaire vide qui ne copie pas les chaines ajoutées : 
+* elles doivent rester valides (et inchangées) tant que le dictionnaire
+* est utilisé, et ne sont pas terminées par '\0'
+* @return le dictionnaire créé, NULL en cas d'erreur
+*/
+dictionnaire init_dictionnaire_vues();
+
+/**
+* Ajoute une chaine au dictionnaire si elle n'y est pas déjà
+* @param d : le dictionnaire
+* @param chaine : la chaine à ajouter (pas forcément terminée par '\0')
+* @param longueur : la longueur de la chaine
+* @return l'identifiant de la chaine, -1 en cas d'erreur
+*/
+int dictionnaire_ajouter(dictionnaire d, const char *chaine, 
+                         size_t longueur);
+
+/**
+* Recherche une chaine dans le dictionnaire
+* @param d : le dictionnaire
+* @param chaine : la chaine à rechercher (pas forcément terminée par '\0')
+* @param longueur : la longueur de la chaine
+* @return l'identifiant de la chaine, -1 si elle est absente
+*/
+int dictionnaire_chercher(dictionnaire d, const char *chaine, 
+                          size_t longueur);
+
+/**
+* Libère l'espace mémoire alloué pour un dictionnaire et ses chaines (en
+* libérant son arène s'il l'a créée)
+* @param d : le dictionnaire à désallouer
+*/
+void free_dictionnaire(dictionnaire d);
+
+
+#endif
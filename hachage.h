@@ -0,0 +1,48 @@
+#ifndef _hachage_h_
+#define _hachage_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+* Fonctions de hachage utilisées par les tables d'index du simulateur.
+* Elles sont définies dans l'en-tête (static inline) car elles sont
+* appelées dans les boucles critiques.
+*/
+
+#define FNV1A_BASE 0xcbf29ce484222325ULL
+#define FNV1A_PREMIER 0x100000001b3ULL
+
+/**
+* Calcule le hachage FNV-1a (64 bits) d'une suite d'octets, en
+* poursuivant un hachage déjà commencé
+* @param h : hachage de départ (FNV1A_BASE pour un nouveau hachage)
+* @param donnees : les octets à hacher
+* @param taille : le nombre d'octets
+* @return le hachage obtenu
+*/
+static inline uint64_t hachage_fnv1a(uint64_t h, const void *donnees,
+                                     size_t taille) {
+  const unsigned char *p = (const unsigned char*) donnees;
+  for(size_t i = 0; i < taille; i++) {
+    h ^= p[i];
+    h *= FNV1A_PREMIER;
+  }
+  return h;
+}
+
+/**
+* Mélange les bits d'un entier 64 bits (finaliseur de splitmix64).
+* Sert à hacher des clés numériques.
+* @param x : la valeur à mélanger
+* @return la valeur mélangée
+*/
+static inline uint64_t hachage_melanger(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+
+#endif
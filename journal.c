@@ -0,0 +1,137 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "journal.h"
+
+/**
+* Assemble l'entrée du journal d'une étape
+* @param etat : l'état avant l'étape
+* @param deplacement : le déplacement de la tête (-1, 0 ou +1)
+* @param symbole : le symbole de la case avant l'étape
+*/
+static inline uint32_t coder_entree(int etat, int deplacement,
+                                    cellule symbole) {
+  return (uint32_t) etat << 10 | (uint32_t) (deplacement + 1) << 8
+         | symbole;
+}
+
+/**
+* Ajoute la configuration courante aux points de reprise si elle est
+* au-delà du dernier point. Lorsque tous les points sont pris, le plus
+* ancien après l'état initial est retiré.
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int ajouter_point(journal j, configuration c) {
+  if(c->nb_etapes <= j->points[j->nb_points - 1]->nb_etapes) return 1;
+  configuration copie = copier_configuration(c);
+  if(!copie) return 0;
+  if(j->nb_points == MAX_POINTS_REPRISE) {
+    free_configuration(j->points[1]);
+    for(int i = 1; i < j->nb_points - 1; i++) j->points[i] = j->points[i+1];
+    j->nb_points--;
+  }
+  j->points[j->nb_points++] = copie;
+  return 1;
+}
+
+/**
+* Remet une configuration dans l'état d'un point de reprise
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int restaurer_point(configuration c, configuration point) {
+  ruban r = copier_ruban(point->ruban_courant);
+  if(!r) return 0;
+  free_ruban(c->ruban_courant);
+  c->ruban_courant = r;
+  c->etat_courant = point->etat_courant;
+  c->tete_lecture = point->tete_lecture;
+  c->nb_etapes = point->nb_etapes;
+  return 1;
+}
+
+journal init_journal(configuration c, long capacite, long intervalle) {
+  if(c->mt->table->nb_etats > MAX_ETATS_JOURNAL) {
+    fprintf(stderr, "\n[ERR]: Le journal est limité aux machines d'au "
+            "plus %d états\n\n", MAX_ETATS_JOURNAL);
+    return NULL;
+  }
+  journal j = (journal) calloc(1, sizeof(struct journal_s));
+  if(!j || !(j->entrees = (uint32_t*) malloc(sizeof(uint32_t) * capacite))
+     || !(j->points[0] = copier_configuration(c))) {
+    perror("Erreur d'allocation de la mémoire du journal.\n");
+    free_journal(j);
+    return NULL;
+  }
+  j->capacite = capacite;
+  j->intervalle = intervalle;
+  j->nb_points = 1;
+  j->derniere_reprise = -1;
+  return j;
+}
+
+int journal_avancer(journal j, configuration c) {
+  table_transitions table = c->mt->table;
+  ruban r = c->ruban_courant;
+  if(c->etat_courant == table->etat_fin) return 0;
+  cellule lu = *ruban_case(r, c->tete_lecture);
+  int32_t i = table_chercher(table, c->etat_courant, lu);
+  if(i < 0) return 0;
+  regle rg = &table->regles[i];
+  // Le ruban peut être réalloué par le déplacement : la case est écrite
+  // ensuite
+  long tete = c->tete_lecture;
+  if(!ruban_deplacer(r, &tete, rg->deplacement)) return 0;
+  *ruban_case(r, c->tete_lecture) = rg->symbole_ecrit;
+  j->entrees[c->nb_etapes % j->capacite] =
+    coder_entree(c->etat_courant, rg->deplacement, lu);
+  c->etat_courant = rg->nouvel_etat;
+  c->tete_lecture = tete;
+  c->nb_etapes++;
+  if(j->nb < j->capacite) j->nb++;
+  // Un point de reprise qui ne peut pas être pris n'empêche pas
+  // l'exécution : le point précédent sera utilisé
+  if(j->intervalle && c->nb_etapes % j->intervalle == 0
+     && !ajouter_point(j, c))
+    perror("Erreur d'allocation d'un point de reprise.\n");
+  return 1;
+}
+
+long journal_reculer(journal j, configuration c, long n) {
+  ruban r = c->ruban_courant;
+  long k = 0;
+  for(; k < n && j->nb > 0; k++, j->nb--) {
+    uint32_t e = j->entrees[(c->nb_etapes - 1) % j->capacite];
+    c->tete_lecture -= (long) ((e >> 8) & 3) - 1;
+    *ruban_case(r, c->tete_lecture) = (cellule) (e & 0xff);
+    c->etat_courant = (int) (e >> 10);
+    c->nb_etapes--;
+  }
+  return k;
+}
+
+int journal_aller(journal j, configuration c, long etape) {
+  j->derniere_reprise = -1;
+  if(etape < c->nb_etapes && c->nb_etapes - etape <= j->nb) {
+    journal_reculer(j, c, c->nb_etapes - etape);
+    return 1;
+  }
+  // Dernier point de reprise avant l'étape : il est utilisé s'il faut
+  // reculer au-delà du journal, ou avancer au-delà du point
+  int p = j->nb_points - 1;
+  while(p > 0 && j->points[p]->nb_etapes > etape) p--;
+  if(etape < c->nb_etapes || j->points[p]->nb_etapes > c->nb_etapes) {
+    if(!restaurer_point(c, j->points[p])) return -1;
+    j->nb = 0;
+    j->derniere_reprise = c->nb_etapes;
+  }
+  while(c->nb_etapes < etape)
+    if(!journal_avancer(j, c)) return 0;
+  return 1;
+}
+
+void free_journal(journal j) {
+  if(!j) return;
+  free(j->entrees);
+  for(int i = 0; i < j->nb_points; i++) free_configuration(j->points[i]);
+  free(j);
+}
@@ -0,0 +1,104 @@
+#ifndef _journal_h_
+#define _journal_h_
+
+#include <stdint.h>
+
+#include "machineturing.h"
+
+// Nombre d'entrées par défaut du journal (4 octets par entrée)
+#define CAPACITE_JOURNAL_DEFAUT (1L << 20)
+// Nombre maximal de points de reprise gardés, état initial compris
+#define MAX_POINTS_REPRISE 64
+// Nombre maximal d'états d'une machine journalisée (identifiant d'état
+// sur 22 bits dans une entrée)
+#define MAX_ETATS_JOURNAL (1 << 22)
+
+/**
+* Journal d'annulation d'une exécution : pour chaque étape, une entrée
+* de 4 octets contenant l'identifiant de l'état avant l'étape (22 bits),
+* le déplacement de la tête + 1 (2 bits) et le symbole écrasé par
+* l'étape (8 bits), dans un tampon circulaire. Une étape est annulée en
+* remettant le symbole, la tête et l'état ; seules les 'capacite'
+* dernières étapes peuvent l'être. Au-delà, l'exécution repart d'un
+* point de reprise (copie complète d'une configuration) : l'état
+* initial, puis une configuration toutes les 'intervalle' étapes si
+* demandé. Les positions extrêmes visitées du ruban ne sont pas
+* restaurées par une annulation.
+* capacite -> le nombre d'entrées du tampon
+* entrees -> le tampon ; l'entrée de l'étape k (passage de la
+*            configuration k-1 à k) est à l'indice (k-1) % capacite
+* nb -> le nombre d'étapes annulables, celles qui précèdent l'étape
+*       courante
+* intervalle -> le nombre d'étapes entre deux points de reprise, 0 pour
+*               ne garder que l'état initial
+* nb_points -> le nombre de points de reprise
+* points -> les points de reprise, par étape croissante ; points[0] est
+*           l'état initial et n'est jamais retiré
+* derniere_reprise -> l'étape du point de reprise utilisé par le dernier
+*                     journal_aller(), -1 si le journal a suffi
+*/
+struct journal_s {
+  long capacite;
+  uint32_t *entrees;
+  long nb;
+  long intervalle;
+  int nb_points;
+  configuration points[MAX_POINTS_REPRISE];
+  long derniere_reprise;
+};
+typedef struct journal_s* journal;
+
+/**
+* Crée le journal d'une exécution, dont la configuration de départ
+* devient le premier point de reprise
+* @param c : la configuration de départ
+* @param capacite : le nombre d'étapes annulables sans point de reprise
+* @param intervalle : le nombre d'étapes entre deux points de reprise,
+*                     0 pour ne garder que la configuration de départ
+* @return le journal, NULL en cas d'erreur
+*/
+journal init_journal(configuration c, long capacite, long intervalle);
+
+/**
+* Exécute une étape en l'inscrivant dans le journal (et en prenant un
+* point de reprise si l'étape atteinte en est un)
+* @param j : le journal
+* @param c : la configuration, mise à jour
+* @return 1 si une étape a été exécutée, 0 si la machine est dans l'état
+*         final, n'a pas de transition ou si le ruban ne peut pas être
+*         agrandi
+*/
+int journal_avancer(journal j, configuration c);
+
+/**
+* Annule les dernières étapes inscrites dans le journal
+* @param j : le journal
+* @param c : la configuration, mise à jour
+* @param n : le nombre d'étapes à annuler
+* @return le nombre d'étapes annulées (au plus j->nb)
+*/
+long journal_reculer(journal j, configuration c, long n);
+
+/**
+* Amène une configuration à une étape donnée : en arrière, les étapes
+* sont annulées avec le journal si elles y sont encore, sinon
+* l'exécution repart du dernier point de reprise qui précède l'étape ;
+* en avant, les étapes sont exécutées avec journal_avancer(). Le coût
+* est proportionnel à la distance parcourue.
+* @param j : le journal
+* @param c : la configuration, mise à jour
+* @param etape : l'étape à atteindre
+* @return 1 si l'étape est atteinte, 0 si la machine s'arrête avant,
+*         -1 en cas d'erreur d'allocation
+*/
+int journal_aller(journal j, configuration c, long etape);
+
+/**
+* Libère l'espace mémoire alloué pour un journal et ses points de
+* reprise
+* @param j : le journal à désallouer
+*/
+void free_journal(journal j);
+
+
+#endif
@@ -0,0 +1,214 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "lot.h"
+
+// Nombre de mots réservés à la fois par un thread
+#define TAILLE_PAQUET 64
+
+/**
+* Structure de données partagée par les threads du mode lot.
+* mt -> la machine exécutée
+* limites -> les limites de l'exécution de chaque mot
+* moteur / contexte -> le moteur d'exécution de chaque mot et ses données
+* mots -> les mots du bloc courant
+* nb_mots -> le nombre de mots du bloc courant
+* suivant -> l'indice du prochain mot à exécuter (accès atomique)
+* resultats -> le résultat de chaque mot du bloc
+* etapes -> le nombre d'étapes de chaque mot du bloc
+* cycles -> le début et la période du cycle de chaque mot du bloc
+* depart -> verrou tenu par le thread principal pendant la création des
+*           threads : les barrières ne sont initialisées qu'ensuite,
+*           pour le nombre de threads effectivement créés
+* debut -> barrière de début de traitement d'un bloc
+* fin -> barrière de fin de traitement d'un bloc
+* termine -> 1 lorsqu'il n'y a plus de bloc à traiter
+*/
+struct lot_s {
+  MT mt;
+  limites limites;
+  moteur_lot moteur;
+  void *contexte;
+  char **mots;
+  long nb_mots;
+  long suivant;
+  int *resultats;
+  long *etapes;
+  long (*cycles)[2];
+  pthread_mutex_t depart;
+  pthread_barrier_t debut;
+  pthread_barrier_t fin;
+  int termine;
+};
+typedef struct lot_s* lot;
+
+/**
+* Exécute les mots du bloc courant réservés par paquets, jusqu'à ce que
+* tous les mots du bloc soient réservés
+*/
+static void executer_bloc(lot l, configuration *c) {
+  long i, fin;
+  while((i = __atomic_fetch_add(&l->suivant, TAILLE_PAQUET, 
+                                __ATOMIC_RELAXED)) < l->nb_mots) {
+    fin = i + TAILLE_PAQUET < l->nb_mots ? i + TAILLE_PAQUET : l->nb_mots;
+    for(; i < fin; i++) {
+      // La configuration (et son ruban) est réutilisée d'un mot à l'autre
+      if(*c == NULL) *c = init_configuration(l->mt, l->mots[i]);
+      else if(!reinitialiser_configuration(*c, l->mots[i])) {
+        free_configuration(*c);
+        *c = NULL;
+      }
+      if(*c == NULL) {
+        l->resultats[i] = -1;
+        l->etapes[i] = 0;
+        continue;
+      }
+      l->resultats[i] = l->moteur ? l->moteur(*c, l->limites, l->contexte)
+                                  : executer(*c, l->limites);
+      l->etapes[i] = (*c)->nb_etapes;
+      l->cycles[i][0] = (*c)->debut_cycle;
+      l->cycles[i][1] = (*c)->periode_cycle;
+    }
+  }
+}
+
+/**
+* Fonction exécutée par chaque thread : traite les blocs de mots 
+* jusqu'à la fin du fichier
+*/
+static void* travailleur(void *arg) {
+  lot l = (lot) arg;
+  configuration c = NULL;
+  // Attend que le thread principal ait initialisé les barrières
+  pthread_mutex_lock(&l->depart);
+  pthread_mutex_unlock(&l->depart);
+  for(;;) {
+    pthread_barrier_wait(&l->debut);
+    if(l->termine) break;
+    executer_bloc(l, &c);
+    pthread_barrier_wait(&l->fin);
+  }
+  free_configuration(c);
+  return NULL;
+}
+
+/**
+* Lit le prochain bloc de mots du fichier. Le tampon de chaque ligne 
+* est réutilisé d'un bloc à l'autre.
+* @return le nombre de mots lus
+*/
+static long lire_bloc(FILE *entree, char **mots, size_t *tailles) {
+  long n = 0;
+  ssize_t lu;
+  while(n < TAILLE_BLOC_LOT 
+        && (lu = getline(&mots[n], &tailles[n], entree)) != -1) {
+    // Suppression de la fin de ligne
+    while(lu > 0 && (mots[n][lu-1] == '\n' || mots[n][lu-1] == '\r'))
+      mots[n][--lu] = '\0';
+    n++;
+  }
+  return n;
+}
+
+int executer_lot(MT mt, FILE *entree, FILE *sortie, int nb_threads, 
+                 limites lim, moteur_lot moteur, void *contexte) {
+  struct lot_s l;
+  l.mt = mt;
+  l.limites = lim;
+  l.moteur = moteur;
+  l.contexte = contexte;
+  l.termine = 0;
+  l.mots = (char**) calloc(TAILLE_BLOC_LOT, sizeof(char*));
+  size_t *tailles = (size_t*) calloc(TAILLE_BLOC_LOT, sizeof(size_t));
+  l.resultats = (int*) malloc(sizeof(int) * TAILLE_BLOC_LOT);
+  l.etapes = (long*) malloc(sizeof(long) * TAILLE_BLOC_LOT);
+  l.cycles = (long(*)[2]) malloc(sizeof(long[2]) * TAILLE_BLOC_LOT);
+  pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * nb_threads);
+  if(!l.mots || !tailles || !l.resultats || !l.etapes || !l.cycles 
+     || !threads) {
+    perror("Erreur d'allocation de la mémoire du mode lot.\n");
+    free(l.mots); free(tailles); free(l.resultats); free(l.etapes);
+    free(l.cycles); free(threads);
+    return 1;
+  }
+
+  // Les threads et le thread principal se synchronisent au début et à 
+  // la fin du traitement de chaque bloc. Le lot continue avec les 
+  // threads qui ont pu être créés.
+  int lances = 0;
+  pthread_mutex_init(&l.depart, NULL);
+  pthread_mutex_lock(&l.depart);
+  for(; lances < nb_threads; lances++) 
+    if(pthread_create(&threads[lances], NULL, travailleur, &l)) break;
+  if(!lances) {
+    fprintf(stderr, "\n[ERR]: Echec de la création des threads du mode "
+            "lot\n\n");
+    pthread_mutex_unlock(&l.depart);
+    pthread_mutex_destroy(&l.depart);
+    free(l.mots); free(tailles); free(l.resultats); free(l.etapes);
+    free(l.cycles); free(threads);
+    return 1;
+  }
+  pthread_barrier_init(&l.debut, NULL, lances + 1);
+  pthread_barrier_init(&l.fin, NULL, lances + 1);
+  pthread_mutex_unlock(&l.depart);
+
+  long nb_mots = 0, nb_etapes = 0, compteurs[RESULTAT_BOUCLE + 1] = {0};
+  int erreur = 0;
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  while((l.nb_mots = lire_bloc(entree, l.mots, tailles)) > 0) {
+    l.suivant = 0;
+    pthread_barrier_wait(&l.debut);
+    pthread_barrier_wait(&l.fin);
+    // Écriture des résultats du bloc dans l'ordre du fichier
+    for(long i = 0; i < l.nb_mots; i++) {
+      if(l.resultats[i] < 0) {
+        erreur = 1;
+        fprintf(sortie, "%s\tERREUR\t0\n", l.mots[i]);
+        continue;
+      }
+      compteurs[l.resultats[i]]++;
+      nb_etapes += l.etapes[i];
+      fprintf(sortie, "%s\t%s\t%ld", l.mots[i], 
+              libelle_resultat(l.resultats[i]), l.etapes[i]);
+      if(l.resultats[i] == RESULTAT_BOUCLE) 
+        fprintf(sortie, "\t%ld\t%ld", l.cycles[i][0], l.cycles[i][1]);
+      fputc('\n', sortie);
+    }
+    nb_mots += l.nb_mots;
+  }
+
+  l.termine = 1;
+  pthread_barrier_wait(&l.debut);
+  for(int i = 0; i < lances; i++) pthread_join(threads[i], NULL);
+  fflush(sortie);
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double duree = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  if(duree <= 0) duree = 1e-9;
+  fprintf(stderr, "\n[LOT]: %ld mots (%ld acceptés, %ld refusés, "
+          "%ld timeouts, %ld boucles) sur %d threads en %.3f s\n"
+          "[LOT]: %.0f mots/s, %.0f étapes/s (%ld étapes au total)\n", 
+          nb_mots, compteurs[RESULTAT_ACCEPTE], compteurs[RESULTAT_REFUSE],
+          compteurs[RESULTAT_TIMEOUT], compteurs[RESULTAT_BOUCLE], 
+          lances, duree, 
+          nb_mots / duree, nb_etapes / duree, nb_etapes);
+
+  pthread_barrier_destroy(&l.debut);
+  pthread_barrier_destroy(&l.fin);
+  pthread_mutex_destroy(&l.depart);
+  for(long i = 0; i < TAILLE_BLOC_LOT; i++) free(l.mots[i]);
+  free(l.mots);
+  free(tailles);
+  free(l.resultats);
+  free(l.etapes);
+  free(l.cycles);
+  free(threads);
+  return erreur;
+}
@@ -0,0 +1,47 @@
+#ifndef _lot_h_
+#define _lot_h_
+
+#include <stdio.h>
+
+#include "machineturing.h"
+
+/**
+* Nombre de mots lus et exécutés à la fois par le mode lot
+*/
+#define TAILLE_BLOC_LOT 65536
+
+/**
+* Moteur d'exécution d'un mot du mode lot, appelé par plusieurs threads
+* à la fois
+* @param c : la configuration de départ du mot, mise à jour
+* @param l : les limites de l'exécution
+* @param contexte : les données du moteur (code compilé de la machine,
+*                   ...), partagées en lecture seule par les threads
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+typedef int (*moteur_lot)(configuration c, limites l, void *contexte);
+
+/**
+* Exécute une machine de Turing sur chaque mot d'un fichier (un mot par
+* ligne). La machine, compilée une seule fois, est partagée en lecture 
+* seule par plusieurs threads ; chaque thread exécute les mots sur sa 
+* propre configuration. Pour chaque mot, une ligne 
+* 'mot<TAB>RESULTAT<TAB>nombre_d_etapes' est écrite sur la sortie, 
+* dans l'ordre du fichier ; pour le résultat BOUCLE, le début et la 
+* période du cycle sont ajoutés dans deux colonnes supplémentaires. Le nombre de mots traités et le débit 
+* (mots/s, étapes/s) sont affichés sur la sortie d'erreur.
+* @param mt : la machine de Turing à exécuter
+* @param entree : le fichier contenant les mots
+* @param sortie : le fichier où écrire les résultats
+* @param nb_threads : le nombre de threads d'exécution
+* @param l : les limites de l'exécution de chaque mot
+* @param moteur : le moteur d'exécution de chaque mot, NULL pour 
+*                 executer()
+* @param contexte : les données passées au moteur
+* @return 0 en cas de succès, 1 en cas d'erreur
+*/
+int executer_lot(MT mt, FILE *entree, FILE *sortie, int nb_threads, 
+                 limites l, moteur_lot moteur, void *contexte);
+
+
+#endif
@@ -4,257 +4,90 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/mman.h>
 
+#include "hachage.h"
 #include "machineturing.h"
+#include "cycles.h"
+#include "binaire.h"
+#include "chargeur.h"
+#include "balayage.h"
+#include "multiruban.h"
+#include "profilage.h"
 
-/**
-* Renvoie une copie d'une chaine de caractère
-*/
-char* clone_string(char *string) {
-  char *res = (char*) malloc(sizeof(char) * strlen(string) + 1);
-  strcpy(res, string);
-  return res;
-}
+#define TRANCHE_TRACE 1024
 
-/**
-* Supprime les espaces au débuts et à la fin d'un chaine de caractère
-* @param string : la chaine à trimer
-* @return la chaine sans ses espaces en début et fin de chaine
-*/
-char* trim_string(char *string)
-{
-  // On ignore les espaces au debut de la chaine s'il y en a
-  while(isspace((unsigned char)*string)) string++;
-  if(*string == 0) return string;
-  // On ignore les espaces a la fin de la chaine s'il y en a
-  char *fin_str = string + strlen(string);
-  while(fin_str > string && isspace(*--fin_str));
-  *(fin_str+1) = '\0';
-
-  // Retourne une copie de la chaine de caractères
-  return clone_string(string);
-}
-
-transition creer_transition(char *etat, char sym_lu, char sym_ecrit, 
-  char mvt, char *nouv_etat) {
-  // Allocation mémoire de la transition résultat
-  transition res = (transition) malloc(sizeof(struct transition_s));
+transition creer_transition(arene a, char *etat, char sym_lu, 
+  char sym_ecrit, char mvt, char *nouv_etat) {
+  // Allocation de la transition résultat dans l'arène de la machine
+  transition res = (transition) arene_allouer(a, sizeof(struct transition_s));
+  if(!res) return NULL;
 
   res->etat = etat;
   res->symbole_lu = sym_lu;
   res->symbole_ecrit = sym_ecrit;
   res->mouvement = mvt;
   res->nouvel_etat = nouv_etat;
+  res->id_etat = -1;
+  res->id_nouvel_etat = -1;
   res->suivant = NULL;
 
   return res;
 }
 
-int transition_existe(MT mt, transition tr) {
-  transition t = mt->transitions;
-  while(t) {
-     if(!strcmp(t->etat, tr->etat) && t->symbole_lu == tr->symbole_lu 
-        && t->symbole_ecrit == tr->symbole_ecrit 
-        && t->mouvement == tr->mouvement 
-        && !strcmp(t->nouvel_etat, tr->nouvel_etat))
-        return 1;
-      
-      t=t->suivant;
-  }
-  return 0;
-}
-
-void ajouter_transition(MT mt, transition nouveau, int distinct) {
-  // On ajoute que si la liste peut contenir des doublons ou si
-  // le nouvel élément n'appartient pas à la liste
-  if(!distinct || !transition_existe(mt, nouveau)) {
-    // Si la liste des transitions est vide, le nouvel élément devient la 
-    // tête de liste
-    if(mt->transitions == NULL) {
-      mt->transitions = nouveau;
-      mt->transitions_fin = nouveau;
-    }
-    // Sinon, on ajoute le nouvel élément à la fin de la liste
-    else {
-      mt->transitions_fin->suivant = nouveau;
-      mt->transitions_fin = nouveau;
-    }
-  } else if(nouveau) free(nouveau);
+void ajouter_transition(MT mt, transition nouveau) {
+  // Si la liste des transitions est vide, le nouvel élément devient la 
+  // tête de liste
+  if(mt->transitions == NULL) {
+    mt->transitions = nouveau;
+    mt->transitions_fin = nouveau;
+  }
+  // Sinon, on ajoute le nouvel élément à la fin de la liste
+  else {
+    mt->transitions_fin->suivant = nouveau;
+    mt->transitions_fin = nouveau;
+  }
 }
 
-void afficher_transitions(transition transitions) {
+void afficher_transitions(transition transitions, const uint64_t *passages) {
   printf("> TRANSITIONS DE LA MACHINE :\n");
-  printf("Etat  |  Symbole lu  |  Symbole ecrit  |  Mouvement  |  Nouvel etat\n");
-  while(transitions != NULL) {
-  printf(" %s           %c                %c               %c             %s\n", 
+  printf("Etat  |  Symbole lu  |  Symbole ecrit  |  Mouvement  |  Nouvel etat%s\n",
+         passages ? "  |  Passages" : "");
+  for(int rang = 0; transitions != NULL; rang++) {
+  printf(" %s           %c                %c               %c             %s", 
     transitions->etat, transitions->symbole_lu, transitions->symbole_ecrit,
     transitions->mouvement, transitions->nouvel_etat);
+    if(passages) printf("           %llu", (unsigned long long) passages[rang]);
+    printf("\n");
     transitions = transitions->suivant;
   }
   printf("\n");
 }
 
 
-/**
-* Récupère un état spécial d'une machine de Turing (l'état initial ou 
-* l'état final) à partir de la ligne du fichier de description de la
-* machine contenant la description dudit état.
-* @param line : la ligne du fichier de description contenant la 
-* description de l'état spécial souhaité
-* @param constante : La constante attendu ('init' pour l'état initial, 
-* 'accept' pour l'état final)
-* @return la chaine de caractère représentant l'état spécial
-*/
-char* get_etat_special(char *line, char *constante)
-{
-  char *field;
-  field = strtok(line, ":");   // Split de la ligne sur :
-  if(field != NULL) 
-  {
-    // Suppression des espaces blancs
-    char *field_trim = trim_string(field);
-    // Si le champ récupéré correspond bien au champ attendu
-    if(!strcmp(field_trim, constante)) 
-    {
-      field = strtok(NULL, ":");
-      if(field) 
-      {
-        // Suppression des espaces blancs
-        char *etat_trim = trim_string(field);
-        if(strlen(etat_trim) > 0) // Un état est une chaîne de caractère
-          return etat_trim;
-        else {
-          fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine:"
-          "un état est attendu après %s\n\n", constante);
-          // Libération de l'espace mémoire allouée
-          free(etat_trim); 
-          return NULL;
-        }
-      }
-    } else {
-      fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine :"
-      "'%s' est attendu, '%s' trouvé\n\n", constante, field_trim);
-      // Libération de l'espace mémoire allouée
-      free(field_trim); 
-      return NULL;
-    }
-  } else {
-    fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine : %s:" 
-    "est attendu\n\n", constante);
-    return NULL;
-  }
-
-  return NULL;
-}
-
-
-/**
-* Récupère le champ d'une transition
-* @param line : la ligne du fichier contenant les champs de la 
-*               transition 
-* @param line_clone : une copie de line (sert pour l'affichage des 
-*                     messages d'erreurs)
-* @param is_mvt : 1 si le champ à récupérer concerne le mouvement 
-*                 (droite, gauche ou aucun), 0 sinon
-* @param alpha : L'alphabet de la machine :
-*                  -> l'alphabet d'entrée si le champ à récupérer 
-*                     est un symbole lu,
-*                  -> l'alphabet de travail si le champ à récupérer 
-*                     est un symbole écrit
-*                  -> NULL pour les autres champs
-* @param sb : le symbole blanc du ruban
-* @return le champ récupéré
-*/
-char* get_transition_field(char *line, char *line_clone, int is_mvt, 
-  char *alpha, char sb) {
-  const char *delim = ",";
-  // On split la ligne pour récupérer les différents champs de la 
-  // transition
-  char *field = strtok(line, delim);
-  if(!field) { // Si le champ est nul
-    fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine :\n"
-            "Ligne concernée : %s\n"
-            "Une transition doit être du format " 
-            "etat%ssymbole_lu%snouvel_etat%ssymbole_ecrit%smouvement\n",
-            line_clone, delim, delim, delim, delim);
-    return NULL;
-  }
-
-  // Si le champ est le symbole blanc, on ne le supprime pas 
-  // Ceci est nécessaire lorsque le symbole blanc est un espace
-  if(strlen(field) == 1 && field[0] == sb) return field;
-
-  // Suppression des espaces blancs
-  char *field_trim = trim_string(field);
-  int cond;
-
-  if(is_mvt)
-    // Si le champ à récupérer est le mouvement, 
-    // il ne doit pas être dans l'une des conditions suivantes
-    cond = strlen(field_trim) != 1 || (field_trim[0] != DROITE && 
-           field_trim[0] != GAUCHE && field_trim[0] != AUCUN);
-
-  else if(!alpha) 
-    // Si le champ à récupérer est un état, il ne doit pas être dans
-    // l'une des conditions suivantes
-    cond = strlen(field_trim) == 0;
-
-  else
-    // Si le champ à récupérer est un symbole, il ne doit pas être
-    // dans l'une des conditions suivantes
-    cond = strlen(field_trim) != 1 || 
-    (strchr(alpha, field_trim[0]) == NULL && *field_trim != sb);
-
-  // Si le champ lu n'est pas de la bonne forme 
-  // (ne respecte pas la bonne condition),
-  if(cond) {  
-    // on renvoie une erreur.
-    fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine :\n"
-            "Ligne concernée : %s\n"
-            "Une transition doit être du format " 
-            "etat%ssymbole_lu%snouvel_etat%ssymbole_ecrit%smouvement\n",
-            line_clone, delim, delim, delim, delim);
-
-    if(is_mvt) 
-      fprintf(stderr, "Le mouvement '%s' n'est pas valide. "
-              "Les mouvements possibles sont : '<' , '>' et '-'\n\n", 
-              field_trim);
-    else if(!alpha) 
-      fprintf(stderr, "L'état '%s' n'est pas valide. "
-              "Un état doit être une chaîne caractères non vide.\n\n", 
-              field_trim);
-    else 
-      fprintf(stderr, "Le symbole '%s' n'est pas valide. "
-              "Il doit être un caractère dans l'alphabet d'entrée/de "
-              "travail '%s'\n\n", field_trim, alpha);
-
-    free(field_trim);
+MT init_machine_turing(char *path, char *alphabets, char symbole_blanc) {
+  // Machine précompilée : la table est projetée en mémoire
+  if(est_machine_binaire(path)) 
+    return charger_machine_binaire(path, alphabets, symbole_blanc);
+
+  // Les machines à plusieurs rubans ont leur propre représentation
+  if(est_machine_multiruban(path)) {
+    fprintf(stderr, "\n[ERR]: %s décrit une machine à plusieurs rubans, "
+            "qui ne peut être que simulée (mode [1], moteur 'table')\n\n",
+            path);
     return NULL;
   }
 
-  return field_trim;
-}
-
-
-MT init_machine_turing(char *path, char *alphabets, char symbole_blanc) {
-  FILE *F;
-  char *line = NULL;
-  char *line_clone;
-  size_t length = 0;
-  ssize_t read;
-  char *line_trim;
-
-  if((F = fopen(path, "r")) == NULL)
-  {
-    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", path);
-    perror("\n\n");
+  MT mt = (MT) calloc(1, sizeof(struct MT_s));
+  if(!mt || !(mt->arene = init_arene(TAILLE_BLOC_ARENE))
+     || !(mt->noms = init_dictionnaire_arene(mt->arene))) {
+    perror("Erreur d'allocation de la mémoire de la machine.\n");
+    if(mt) free_arene(mt->arene);
+    free(mt);
     return NULL;
   }
-
-  MT mt = (MT) malloc(sizeof(struct MT_s));
-  mt->transitions = NULL;
-  mt->etat_in = NULL;
-  mt->etat_fin = NULL;
   
   // Initialisation des alphabets de la matrice. entree doit contenir 
   // l'alphabet d'entrée et l'alphabet de travail de la machine, 
@@ -263,326 +96,598 @@ MT init_machine_turing(char *path, char *alphabets, char symbole_blanc) {
   // Ex : 01:01_ 
   // Dans cet exemple, l'alphabet d'entrée est {0,1} et l'alphabet 
   // de travail {0,1}.
-  mt->alphabet_entree = strtok(alphabets, ":"); 
-  mt->alphabet_travail = strtok(NULL, ":");
-  // Pour vérifier qu'on a le bon nombre de paramètre
-  char *temp = strtok(NULL, ":"); 
-  if(mt->alphabet_entree == NULL || mt->alphabet_travail == NULL 
-     || temp != NULL) 
+  char *separateur = strchr(alphabets, ':');
+  if(!separateur || separateur == alphabets || !separateur[1] 
+     || strchr(separateur + 1, ':')) 
   {
     fprintf(stderr, "\n[ERR]: Alphabets de la machine incorrect, " 
      "l'entrée doit être de la forme : "
      "'alphabet_entree:alphabet_travail'\n\n");
+    free_mt(mt);
     return NULL;
   }
+  *separateur = '\0';
+  mt->alphabet_entree = alphabets;
+  mt->alphabet_travail = separateur + 1;
 
   // Initialisation du symbole blanc
   mt->symbole_blanc = symbole_blanc;
 
-  // Initiailisation des états et des transitions de la machine
-  // On lit le fichier ligne par ligne
-  while ((read = getline(&line, &length, F)) != -1) {
-    // Pour chaque ligne non nul,
-    line_trim = trim_string(line);
-    if(strlen(line_trim) != 0)
-    {
-      // On vérifie s'il s'agit de la déclaration d'un état spécial 
-      // (initial ou final) i.e. leurs lignes doivent respectivement 
-      // commencer par 'init' ou 'accept'.
-      if(!strncmp(line_trim, "init", 4)) {
-        mt->etat_in = get_etat_special(line_trim, "init");
-        if(!mt->etat_in) {
-          free(line_trim);
-          return NULL;
-        }
-      }
-      else if(!strncmp(line_trim, "accept", 6)) 
-      {
-        mt->etat_fin = get_etat_special(line_trim, "accept");
-        if(!mt->etat_fin) {
-          free(line_trim);
-          return NULL;
-        }
-      }
-
-      else { 
-        // Les autres lignes correspondent à la description des
-        // transitions : la description d'une transition doit se faire 
-        // sur une ligne (ex : 'q0,0,q1,0,>')
-
-        // On garde une copie de la ligne car strtok modifie l'argument 
-        // passé en param
-        line_clone = clone_string(line_trim);
-
-        // Récupération de l'ancien état de la transition
-        char *ea = get_transition_field(line_trim, line_clone, 0, NULL,
-                                        mt->symbole_blanc);
-        if(!ea) return NULL;
-        // Récupération du symbole lu de la transition
-        char *sl = get_transition_field(NULL, line_clone, 0, mt->alphabet_entree, mt->symbole_blanc); 
-        if(!sl) {
-          // Libération des mémoire temporaires allouées
-          free(ea);
-          return NULL;
-        }
-        // Récupération du nouvel état de la transition
-        char *ne = get_transition_field(NULL, line_clone, 0, NULL,
-                                        mt->symbole_blanc);
-        if(!ne) 
-        {
-          // Libération des mémoire temporaires allouées
-          free(ea);
-          free(sl);
-          return NULL;
-        }
-        // Récupération du symbole à écrire de la transition
-        char *se = get_transition_field(NULL, line_clone, 0, mt->alphabet_travail, mt->symbole_blanc); 
-        if(!se) {
-          // Libération des mémoire temporaires allouées
-          free(ea);
-          free(sl);
-          free(ne);
-          return NULL;
-        }
-        // Récupération du mouvement de la transition
-        char *mv = get_transition_field(NULL, line_clone, 1, NULL,
-                                        mt->symbole_blanc);
-        if(!mv) 
-        {
-          // Libération des mémoire temporaires allouées
-          free(ea);
-          free(sl);
-          free(ne);
-          free(se);
-          return NULL;
-        }
-
-        // Ajout de la nouvelle transition dans la machine
-        ajouter_transition(mt, creer_transition(ea, *sl, *se, *mv, ne), 0);
-
-        // Libération des mémoire temporaires
-        free(line_clone);
-      }
-
-      free(line_trim);
-
-    }
-
+  // Lecture des états et des transitions de la machine
+  if(!charger_transitions(mt, path)) {
+    free_mt(mt);
+    return NULL;
   }
 
-  fclose(F);
-  
-  // Initialisation des autres états et du ruban de la machine
-  mt->etat_courant = mt->etat_in;
-  mt->ruban_courant = NULL;
-  mt->tete_lecture = mt->ruban_courant;
-
-  // Si l'état initial ou l'état final n'ont pas été configuré dans le code
-  // de la machine, on renvoie une erreur. Ces étapes sont obligatoires
-  if(!mt->etat_in || !mt->etat_fin) 
-  {
-    fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine : "
-            "Les états initiaux et/ou finaux sont manquants\n");
+  // Compilation des transitions : les états sont internalisés en 
+  // identifiants entiers et les transitions indexées par 
+  // (etat, symbole) pour l'exécution
+  mt->table = compiler_transitions(mt->transitions, mt->noms, 
+                mt->etat_in, mt->etat_fin, mt->alphabet_entree, mt->alphabet_travail, 
+                mt->symbole_blanc);
+  if(!mt->table) {
+    free_mt(mt);
     return NULL;
   }
   
   return mt;
 }
 
-
 void free_mt(MT mt) {
-  // Désalloue les espaces mémoires des transitions
-  transition suivant;
-  while(mt->transitions != NULL) {
-    suivant = mt->transitions->suivant;
-    free(mt->transitions->etat);
-    free(mt->transitions->nouvel_etat);
-    free(mt->transitions);
-    mt->transitions = suivant;
+  if(!mt) return;
+  // Machine binaire : seules les structures de la machine et de la table
+  // ont été allouées, le reste est dans la projection
+  if(mt->projection) {
+    munmap(mt->projection, mt->taille_projection);
+    free(mt->table->recherches);
+    free(mt->table);
+    free(mt);
+    return;
   }
 
-  // Libère l'espace mémoire des états de la machine
-  if(mt->etat_in) free(mt->etat_in);
-  if(mt->etat_fin) free(mt->etat_fin);
+  free_dictionnaire(mt->noms);
 
-  // Désalloue l'espace mémoire du ruban
-  free_ruban(mt->ruban_courant);
+  // Désalloue l'espace mémoire de la table compilée
+  free_table_transitions(mt->table);
 
+  // Les transitions et les noms des états sont libérés avec l'arène, 
+  // sans parcourir la liste des transitions
+  free_arene(mt->arene);
   free(mt);
 }
 
+const char* libelle_resultat(int resultat) {
+  switch(resultat) {
+    case RESULTAT_ACCEPTE: return "ACCEPTE";
+    case RESULTAT_TIMEOUT: return "TIMEOUT";
+    case RESULTAT_BOUCLE: return "BOUCLE";
+    default: return "REFUSE";
+  }
+}
+
+configuration init_configuration(MT mt, char *mot) {
+  configuration c = (configuration) malloc(sizeof(struct configuration_s));
+  if(c == NULL) {
+    perror("Erreur d'allocation de la mémoire d'une configuration.\n");
+    return NULL;
+  }
+  c->mt = mt;
+  c->etat_courant = mt->table->etat_in;
+  // Initialisation du ruban avec le mot d'entrée et de la tête de 
+  // lecture sur sa première case
+  c->ruban_courant = init_ruban(mot, mt->symbole_blanc);
+  c->tete_lecture = 0;
+  c->nb_etapes = 0;
+  c->debut_cycle = -1;
+  c->periode_cycle = 0;
+  if(!c->ruban_courant) {
+    free(c);
+    return NULL;
+  }
+  return c;
+}
+
+configuration copier_configuration(configuration c) {
+  configuration res = (configuration) malloc(sizeof(struct configuration_s));
+  if(res == NULL) {
+    perror("Erreur d'allocation de la mémoire d'une configuration.\n");
+    return NULL;
+  }
+  *res = *c;
+  res->ruban_courant = copier_ruban(c->ruban_courant);
+  if(!res->ruban_courant) {
+    free(res);
+    return NULL;
+  }
+  return res;
+}
+
+int configurations_egales(configuration a, configuration b) {
+  return a->etat_courant == b->etat_courant 
+         && a->tete_lecture == b->tete_lecture
+         && rubans_egaux(a->ruban_courant, b->ruban_courant);
+}
+
+int reinitialiser_configuration(configuration c, char *mot) {
+  c->etat_courant = c->mt->table->etat_in;
+  c->tete_lecture = 0;
+  c->nb_etapes = 0;
+  c->debut_cycle = -1;
+  c->periode_cycle = 0;
+  return ruban_reinitialiser(c->ruban_courant, mot);
+}
+
+void free_configuration(configuration c) {
+  if(!c) return;
+  free_ruban(c->ruban_courant);
+  free(c);
+}
+
 /**
-* Affiche le ruban de la machine de Turing mt et son état courant
+* Affiche le ruban de la configuration c et son état courant
 */
-void afficher_ruban_machine(MT mt) {
-  printf("\n> CONFIGURATION ACTUELLE DU RUBAN :\n");
-  printf("            ETAT : %s\n ", mt->etat_courant);
-  afficher_ruban(mt->ruban_courant);
-  for(ruban r=mt->ruban_courant; r; r=r->droite) {
-    printf("   ");
-    if(r==mt->tete_lecture) {
-      printf("^\n");
-      break;
-    } else printf(" ");
-  }
+void afficher_ruban_machine(configuration c, trace t) {
+  trace_afficher(t, table_nom_etat(c->mt->table, c->etat_courant),
+                 c->ruban_courant, c->tete_lecture, c->nb_etapes);
 }
 
-void afficher_machine_turing(MT mt) {
+void afficher_machine_turing(configuration c, trace t) {
+  MT mt = c->mt;
   printf("\n\nAlphabet entrée          Alphabet de Travail\n"
          "   %s                         %s \n"
          "\nEtat initial             Etat final\n"
          "     %s                      %s\n\n", 
          mt->alphabet_entree, mt->alphabet_travail,
          mt->etat_in, mt->etat_fin);
-  afficher_transitions(mt->transitions);
-  afficher_ruban_machine(mt);
+  if(mt->transitions) afficher_transitions(mt->transitions, NULL);
+  else afficher_table_transitions(mt->table, NULL);
+  afficher_ruban_machine(c, t);
   printf("\n");
 }
 
-int simuler_etape(MT mt) {
-  if(!mt->tete_lecture) return 0;
-  for(transition tr = mt->transitions; tr != NULL; tr = tr->suivant) {
-    // Recherche de la bonne transition à appliquer :
-    // l'état de la transition = l'état courant de la machine
-    // et le symbole lu de la transition = symbole lu sur le ruban de 
-    // la machine
-    if(!strcmp(tr->etat, mt->etat_courant) && tr->symbole_lu == 
-       mt->tete_lecture->symbole ) {
-      // Le nouvel état de la transition devient L'état courant de la 
-      // machine
-      mt->etat_courant = tr->nouvel_etat;
-      mt->tete_lecture->symbole = tr->symbole_ecrit;
-      switch(tr->mouvement) {
-        case DROITE: 
-          // La bande est semi-infinie vers la droite
-          if(!mt->tete_lecture->droite) ruban_ajouter_droite(mt->tete_lecture, mt->symbole_blanc);
-          mt->tete_lecture = mt->tete_lecture->droite;
-          break;
-        case GAUCHE: 
-          mt->tete_lecture = mt->tete_lecture->gauche;
-          break;
+int simuler_etape(configuration c) {
+  table_transitions table = c->mt->table;
+  cellule *s = ruban_case(c->ruban_courant, c->tete_lecture);
+  // Recherche de la bonne transition à appliquer dans la table compilée,
+  // indexée par (état courant, symbole lu sur le ruban)
+  int32_t i = table_chercher(table, c->etat_courant, *s);
+  if(i < 0) return 0;
+  regle r = &table->regles[i];
+  // Le nouvel état de la transition devient L'état courant de la 
+  // machine
+  c->etat_courant = r->nouvel_etat;
+  *s = r->symbole_ecrit;
+  // La bande est infinie des deux côtés : le ruban est agrandi si la
+  // tête de lecture sort des cases déjà allouées
+  return ruban_deplacer(c->ruban_courant, &c->tete_lecture, 
+                        r->deplacement);
+}
+
+int resultat_configuration(configuration c, int limite_atteinte) {
+  table_transitions table = c->mt->table;
+  if(c->etat_courant == table->etat_fin) return RESULTAT_ACCEPTE;
+  // La machine n'est limitée que si elle pouvait encore avancer
+  if(limite_atteinte && table_chercher(table, c->etat_courant, 
+                 *ruban_case(c->ruban_courant, c->tete_lecture)) >= 0)
+    return RESULTAT_TIMEOUT;
+  return RESULTAT_REFUSE;
+}
+
+double horloge_secondes() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int delai_depasse(limites l, double debut) {
+  return l && l->max_secondes > 0 
+         && horloge_secondes() - debut >= l->max_secondes;
+}
+
+/**
+* Traverse les cases des symboles d'un état de recherche à partir de la
+* tête de lecture (chaque case traversée est une étape), en agrandissant
+* le ruban si nécessaire
+* @param r : le ruban
+* @param tete : la position de la tête, sur une case d'un symbole 
+*               traversé
+* @param rech : l'état de recherche
+* @param reste : le nombre maximal d'étapes
+* @return le nombre de cases traversées (au moins 1) ; la position 
+*         d'arrivée de la tête est allouée. Si le ruban ne peut pas être
+*         agrandi, la tête s'arrête sur la dernière case allouée (le 
+*         déplacement suivant échouera comme avec ruban_deplacer())
+*/
+static long traverser(ruban r, long tete, recherche rech, long reste) {
+  int d = rech->deplacement;
+  long k = 0;
+  while(k < reste) {
+    long indice = tete + d * k + r->origine;
+    // Cases allouées dans la direction de la recherche (les cases non 
+    // visitées sont blanches)
+    long disponibles = d > 0 ? r->capacite - indice : indice + 1;
+    if(disponibles <= 0) {
+      if(!ruban_etendre(r, tete + d * k)) return k - 1;
+      continue;
+    }
+    if(disponibles > reste - k) disponibles = reste - k;
+    long parcourues = balayer(r->cases + indice, disponibles, d, 
+                              rech->symboles, rech->nb);
+    k += parcourues;
+    if(parcourues < disponibles) break;
+  }
+  if(!ruban_etendre(r, tete + d * k)) return k - 1;
+  return k;
+}
+
+/**
+* Exécute une machine jusqu'à son arrêt ou jusqu'à une étape donnée. 
+* Dans un état de recherche, les cases des symboles traversés sont 
+* franchies en un seul parcours vectorisé (cf. balayer()).
+* (tranche_moteur du moteur 'table', sans contexte)
+*/
+static int executer_tranche(configuration c, long fin_tranche, 
+                            void *contexte) {
+  table_transitions table = c->mt->table;
+  ruban r = c->ruban_courant;
+  int etat = c->etat_courant, fin = table->etat_fin;
+  long tete = c->tete_lecture, n = c->nb_etapes;
+
+  // Même calcul que simuler_etape, avec la configuration gardée dans
+  // des variables locales
+  while(etat != fin && n < fin_tranche) {
+    cellule *s = ruban_case(r, tete);
+    int32_t i = table_chercher(table, etat, *s);
+    if(i < 0) break;
+    regle rg = &table->regles[i];
+    recherche rech = &table->recherches[etat];
+    if(rech->deplacement && rg->nouvel_etat == etat && rg->symbole_ecrit == *s
+       && rg->deplacement == rech->deplacement) {
+      // La règle laisse la case et l'état inchangés : tout l'état de 
+      // recherche est parcouru d'un coup
+      long k = traverser(r, tete, rech, fin_tranche - n);
+      if(k > 0) {
+        n += k;
+        tete += rech->deplacement * k;
+        if(tete < r->min) r->min = tete;
+        if(tete > r->max) r->max = tete;
+        continue;
       }
-      return 1;
     }
+    etat = rg->nouvel_etat;
+    *s = rg->symbole_ecrit;
+    n++;
+    if(!ruban_deplacer(r, &tete, rg->deplacement)) break;
   }
-  return 0;
+
+  c->etat_courant = etat;
+  c->tete_lecture = tete;
+  c->nb_etapes = n;
+  return etat == fin || n < fin_tranche;
+}
+
+int executer_tranches(configuration c, limites l, tranche_moteur tranche,
+                      resultat_moteur resultat, void *contexte) {
+  // Sans limite, la boucle s'arrête au plus tard après LONG_MAX étapes
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  double debut = horloge_secondes();
+  for(;;) {
+    long fin_tranche = limite;
+    if(l && l->max_secondes > 0 && limite - c->nb_etapes > TRANCHE_ETAPES)
+      fin_tranche = c->nb_etapes + TRANCHE_ETAPES;
+    int arret = tranche(c, fin_tranche, contexte);
+    if(arret < 0) return -1;
+    int limite_atteinte = !arret && (c->nb_etapes >= limite 
+                                     || delai_depasse(l, debut));
+    if(arret || limite_atteinte)
+      return resultat ? resultat(c, limite_atteinte, contexte)
+                      : resultat_configuration(c, limite_atteinte);
+  }
+}
+
+int executer(configuration c, limites l) {
+  if(l && l->cycles) return executer_cycles(c, l);
+  return executer_tranches(c, l, executer_tranche, NULL, NULL);
 }
 
+int simuler_turing(configuration c, trace t, limites l, profilage p) {
+  int fin = c->mt->table->etat_fin;
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  double debut = horloge_secondes();
+  int delai = 0, affichage = t->niveau != TRACE_SILENCIEUSE;
+
+  // Aucun affichage ni profil : la boucle ne fait que calculer
+  if(!affichage && !p) return executer(c, l);
+
+  if(affichage) afficher_machine_turing(c, t);
+  // La détection des cycles n'est faite que sans affichage : seule la 
+  // configuration finale est affichée
+  if(l && l->cycles && !p) {
+    int res = executer(c, l);
+    afficher_ruban_machine(c, t);
+    return res;
+  }
 
-int simuler_turing(MT mt, char *mot) {
-  // Initialisation du ruban avec le mot d'entrée
-  mt->ruban_courant = init_ruban(mot);
-  // Initialisation de la tête lecture du ruban
-  mt->tete_lecture = mt->ruban_courant;
-  afficher_machine_turing(mt);
-  while(mt->etat_courant != mt->etat_fin && simuler_etape(mt)) {
-    afficher_ruban_machine(mt);
+  while(c->etat_courant != fin && c->nb_etapes < limite 
+        && !(delai = (c->nb_etapes % TRANCHE_TRACE == 0 
+                      && delai_depasse(l, debut)))) {
+    if(p) profil_etape(p, c);
+    if(!simuler_etape(c)) break;
+    c->nb_etapes++;
+    if(trace_a_afficher(t, c->nb_etapes)) afficher_ruban_machine(c, t);
   }
-  return !strcmp(mt->etat_courant, mt->etat_fin);
+  // En mode périodique, la configuration finale est toujours affichée
+  if(affichage && !trace_a_afficher(t, c->nb_etapes)) 
+    afficher_ruban_machine(c, t);
+  int res = resultat_configuration(c, delai || c->nb_etapes >= limite);
+  if(p) {
+    // Les transitions sont réaffichées avec leurs nombres de passages
+    if(affichage) {
+      printf("\n> PROFIL DE L'EXECUTION\n");
+      if(c->mt->transitions) 
+        afficher_transitions(c->mt->transitions, p->passages_regles);
+      else afficher_table_transitions(c->mt->table, p->passages_regles);
+    }
+    if(!ecrire_profil(p, c, res)) return -1;
+  }
+  return res;
 }
 
-/**
-* Renvoie le i-ème caractère du codage d'un symbole donné
-* @param codage : le codage des symboles
-* @param symbole : le symbole à coder
-* @param symbole_blanc : le symbole blanc du ruban
-* @param i : l'indice du caractère à renvoyer
-* @return symbole_blanc si symbole est symbole_blanc, 
-*         -1 en cas d'erreur, sinon, 
-*         code symbole selon le codage dans codage et renvoie le
-*         caractère à l'indice i.
-*/
-char coder(const char codage[4][2], char symbole, char symbole_blanc, 
-           int i){
-  // L'ordre du caractère du symbole dans l'alphabet. 
-  // ex: a->0, b->1, c->2, d->3
-  int ordre = symbole-'a';
-  // Si le symbole n'est pas dans l'alphabet (est différent de a,b,c,d, 
-  // et du symbole blanc), erreur.
+codage init_codage(MT mt) {
+  codage c = (codage) malloc(sizeof(struct codage_s));
+  if(!c) {
+    perror("Erreur d'allocation de la mémoire du codage.\n");
+    return NULL;
+  }
+  c->nb_symboles = 0;
+  c->symbole_blanc = mt->symbole_blanc;
+  memset(c->entree, 0, sizeof(c->entree));
+  for(int i = 0; i < 256; i++) c->ordre[i] = -1;
+
+  // Les symboles sont numérotés dans leur ordre d'apparition dans 
+  // l'alphabet d'entrée puis dans l'alphabet de travail
+  const char *alphabets[2] = { mt->alphabet_entree, mt->alphabet_travail };
+  for(int a = 0; a < 2; a++) {
+    for(const char *p = alphabets[a]; *p; p++) {
+      unsigned char u = (unsigned char) *p;
+      if(*p == c->symbole_blanc) continue;
+      if(a == 0) c->entree[u] = 1;
+      if(c->ordre[u] < 0) c->ordre[u] = c->nb_symboles++;
+    }
+  }
+
+  // largeur = ceil(log2 k), au moins 1 bit
+  c->largeur = 1;
+  while((1 << c->largeur) < c->nb_symboles) c->largeur++;
+  return c;
+}
+
+void free_codage(codage c) {
+  free(c);
+}
+
+char coder(codage c, char symbole, int i) {
+  if(symbole == c->symbole_blanc) return c->symbole_blanc;
+  int ordre = c->ordre[(unsigned char) symbole];
+  // Si le symbole n'est pas dans les alphabets, erreur.
   // (ce cas ne peut normalement jamais arriver, car on vérifie les
   // symboles et l'alphabet de la machine lors de l'initialisation
   // de celle-ci)
-  if((ordre < 0 || ordre > 3) && symbole != symbole_blanc) return -1;
-  return symbole == symbole_blanc ? symbole_blanc : codage[ordre][i];
+  if(ordre < 0) return -1;
+  return (ordre >> (c->largeur - 1 - i)) & 1 ? '1' : '0';
 }
 
-MT machine_latin_vers_binaire(char *path_in, char *path_out) {
-  // Alphabets d'entrée et de travail de la machine à convertir
-  char alpha_latin[] = "abcd:abcd";
-  // ici, on définit ESPACE comme le symbole blanc du ruban
-  char sb = ' ';
+char* coder_mot(codage c, const char *mot) {
+  size_t n = strlen(mot);
+  char *res = (char*) malloc(n * c->largeur + 1);
+  if(!res) return NULL;
+  
+  for(size_t i = 0; i < n; i++) {
+    // Si le symbole n'est pas dans l'alphabet d'entrée, erreur.
+    if(!c->entree[(unsigned char) mot[i]]) {
+      free(res);
+      return NULL;
+    }
+    for(int j = 0; j < c->largeur; j++) 
+      res[i * c->largeur + j] = coder(c, mot[i], j);
+  }
+  res[n * c->largeur] = '\0';
 
-  // Définition du codage de l'alphabet d'entrée de la machine à 
-  // convertir (Au format {code(a),code(b),code(c),code(d)})
-  const char codage[4][2] = {"00","01","10","11"};
+  return res;
+}
 
-  char sl, se; // symbole lu, symbole ecrit
-  
-  // Création et initialisation de la machine à convertir i.e 
-  // travaillant sur l'alphabet d'entrée latin ({a,b,c,d})
-  MT mt_latin = init_machine_turing(path_in, alpha_latin, sb);
+// Taille initiale de l'index des transitions converties
+#define TAILLE_INDEX_CONVERSION 1024
 
-  if(!mt_latin) return NULL;
+/**
+* Une transition convertie, désignée par la transition d'origine et le 
+* bit qu'elle traite, et le hachage de sa ligne dans le fichier converti
+* (0 pour une case vide de l'index)
+*/
+struct ligne_convertie_s {
+  transition tr;
+  int32_t niveau;
+  uint32_t hachage;
+};
 
-  // Machine temporaire permettant de stocker uniquement les 
-  // transitions de la machine convertie avant leur écriture 
-  // dans le  fichier
-  MT mt_transitions = (MT) malloc(sizeof(struct MT_s));
-  mt_transitions->transitions = NULL;
-  mt_transitions->ruban_courant = NULL;
-  mt_transitions->etat_in = NULL;
-  mt_transitions->etat_fin = NULL;
-
-  // Convertion des transitions de la machine
-  for(transition tr=mt_latin->transitions; tr; tr=tr->suivant) {
-    // Pour chaque transition
-
-    // Conversion des transitions :
-    // On crée une nouvelle transition entre l'ancien état et un nouvel
-    // état intermédiaire tout en convertissant les symbol lus et écrits
-    // ex : Si la transition est : A,a,B,b,> 
-    // On écrit : A,0,A1,0,>
-    sl = coder(codage, tr->symbole_lu, mt_latin->symbole_blanc, 0);
-    se=coder(codage, tr->symbole_ecrit, mt_latin->symbole_blanc, 0);
-    if(sl == -1 || se == -1) 
-    {
-      free_mt(mt_latin);
-      free_mt(mt_transitions);
-      return NULL;
-    }
-    // Création de l'état intermédiaire avec snprintf
-    // On concatène 1 ou 2 (si le symbole lu est 0 ou 1) à l'état
-    // original pour obtenir ce nouvel état intermédiaire
-    // (sera free dans free_mt)
-    char *nouv_etat = (char*) malloc(sizeof(char) * strlen(tr->etat) + 3);
-    snprintf(nouv_etat, sizeof(char)*strlen(tr->etat)+3, 
-             "%s%d", tr->etat, abs(sl-'0'+1));
-    ajouter_transition(mt_transitions, 
-                       creer_transition(clone_string(tr->etat), 
-                       sl, se, tr->mouvement, nouv_etat), 1);
-
-    // On crée une transition pour relier l'état intermédiaire
-    // à l'état de destination original tout en convertissant les 
-    // symboles lus et écrits
-    // ex : Si la transition est : A,a,B,b,> 
-    // A ce stade, on écrit : A1,0,B,1,>
-    sl = coder(codage, tr->symbole_lu, mt_latin->symbole_blanc, 1);
-    se = coder(codage, tr->symbole_ecrit, mt_latin->symbole_blanc, 1);
-    if(sl == -1 || se == -1) 
-    {
-      free_mt(mt_latin);
-      free_mt(mt_transitions);
-      return NULL;
+/**
+* Index des lignes déjà écrites lors d'une conversion ; les lignes ne 
+* sont pas stockées mais régénérées depuis les transitions d'origine 
+* pour les comparer
+*/
+struct conversion_s {
+  codage c;
+  int taille;
+  int nb;
+  struct ligne_convertie_s *cases;
+  char *ligne;
+  char *autre;
+};
+
+/**
+* Ecrit dans buf le nom de l'état intermédiaire atteint après etape 
+* transitions de la chaîne de tr : les etape premiers bits lus tant que
+* le symbole n'est pas entièrement lu, puis tous ses bits suivis d'un 
+* '0' par transition d'écriture ou de déplacement déjà effectuée
+* @return la position de la fin du nom dans buf
+*/
+static char* nom_intermediaire(char *buf, codage c, transition tr, 
+                               int etape) {
+  buf += sprintf(buf, "%s", tr->etat);
+  // On concatène 1 ou 2 (si le bit lu est 0 ou 1) à l'état
+  // original pour chaque bit lu
+  for(int i = 0; i < etape && i < c->largeur; i++) 
+    buf += sprintf(buf, "%d", abs(coder(c, tr->symbole_lu, i) - '0' + 1));
+  for(int i = c->largeur - 1; i < etape; i++) *buf++ = '0';
+  *buf = '\0';
+  return buf;
+}
+
+/**
+* Ecrit dans buf la ligne numéro niveau de la chaîne de transitions 
+* remplaçant tr. La tête part du premier bit du bloc de largeur cases 
+* du symbole :
+* - lecture : les bits sont lus (et réécrits) de gauche à droite ;
+* - écriture : le dernier bit lu, les bits du symbole écrit sont 
+*   écrits de droite à gauche ;
+* - déplacement : la tête rejoint le premier bit du bloc voisin (pour 
+*   '<', une ligne par contenu possible des cases traversées : 0, 1 ou 
+*   blanc).
+* ex : si la transition est A,a,B,b,> avec code(a)=00 et code(b)=01
+* niveau 0 : A,0,A1,0,>
+* niveau 1 : A1,0,A110,1,<
+* niveau 2 : A110,0,A1100,0,>
+* niveau 3 : A1100,1,B,1,>
+* @return la longueur de la ligne, 0 si la chaîne a moins de niveau+1
+*         lignes
+*/
+static int ligne_convertie(char *buf, codage c, transition tr, 
+                           int niveau) {
+  int largeur = c->largeur, position, dernier, etape = niveau;
+  char lu, ecrit, mouvement;
+  if(niveau < largeur - 1) {
+    // Lecture
+    lu = ecrit = coder(c, tr->symbole_lu, niveau);
+    mouvement = DROITE;
+    dernier = 0;
+  } else if(niveau < 2 * largeur - 1) {
+    // Ecriture
+    position = 2 * largeur - 2 - niveau;
+    lu = coder(c, tr->symbole_lu, position);
+    ecrit = coder(c, tr->symbole_ecrit, position);
+    mouvement = position ? GAUCHE : tr->mouvement;
+    dernier = !position && (largeur == 1 || tr->mouvement == AUCUN);
+  } else {
+    // Déplacement vers le bloc voisin
+    int k = niveau - (2 * largeur - 1);
+    if(tr->mouvement == DROITE && k < largeur - 1) {
+      lu = ecrit = coder(c, tr->symbole_ecrit, k + 1);
+    } else if(tr->mouvement == GAUCHE && k < 3 * (largeur - 1)) {
+      const char contenus[3] = { '0', '1', c->symbole_blanc };
+      lu = ecrit = contenus[k % 3];
+      k /= 3;
+    } else {
+      return 0;
     }
-    // clone_string(nouv_etat) Sera free dans free_mt
-    ajouter_transition(mt_transitions, 
-      creer_transition(clone_string(nouv_etat), sl, se, 
-                       tr->mouvement, 
-                       clone_string(tr->nouvel_etat)), 1);
+    etape = 2 * largeur - 1 + k;
+    mouvement = tr->mouvement;
+    dernier = k == largeur - 2;
+  }
+  char *p = nom_intermediaire(buf, c, tr, etape);
+  p += sprintf(p, ",%c,", lu);
+  if(dernier) p += sprintf(p, "%s", tr->nouvel_etat);
+  else p = nom_intermediaire(p, c, tr, etape + 1);
+  p += sprintf(p, ",%c,%c\n", ecrit, mouvement);
+  return p - buf;
+}
 
+/**
+* Ajoute une ligne convertie à l'index si elle n'y est pas déjà
+* @return 1 si la ligne est nouvelle, 0 si elle a déjà été écrite, 
+*         -1 en cas d'erreur d'allocation
+*/
+static int ligne_nouvelle(struct conversion_s *cv, transition tr, 
+                          int niveau, int longueur) {
+  uint32_t h = (uint32_t) hachage_melanger(
+                            hachage_fnv1a(FNV1A_BASE, cv->ligne, longueur));
+  if(!h) h = 1;
+  int masque = cv->taille - 1;
+  int i = (int) (h & masque);
+  for(; cv->cases[i].hachage; i = (i + 1) & masque) {
+    if(cv->cases[i].hachage != h) continue;
+    ligne_convertie(cv->autre, cv->c, cv->cases[i].tr, 
+                    cv->cases[i].niveau);
+    if(!strcmp(cv->ligne, cv->autre)) return 0;
+  }
+  cv->cases[i].tr = tr;
+  cv->cases[i].niveau = niveau;
+  cv->cases[i].hachage = h;
+  cv->nb++;
+
+  // On garde un taux de remplissage de la table inférieur à 1/2
+  if(cv->nb * 2 <= cv->taille) return 1;
+  struct ligne_convertie_s *anciennes = cv->cases;
+  int ancienne_taille = cv->taille;
+  cv->cases = (struct ligne_convertie_s*) calloc(ancienne_taille * 2, 
+                                      sizeof(struct ligne_convertie_s));
+  if(!cv->cases) {
+    cv->cases = anciennes;
+    return -1;
+  }
+  cv->taille = ancienne_taille * 2;
+  masque = cv->taille - 1;
+  for(int j = 0; j < ancienne_taille; j++) {
+    if(!anciennes[j].hachage) continue;
+    for(i = anciennes[j].hachage & masque; cv->cases[i].hachage; 
+        i = (i + 1) & masque);
+    cv->cases[i] = anciennes[j];
+  }
+  free(anciennes);
+  return 1;
+}
+
+MT machine_latin_vers_binaire(char *path_in, char *path_out, 
+                              char *alphabets) {
+  // ici, on définit ESPACE comme le symbole blanc du ruban
+  char sb = ' ';
+
+  // Création et initialisation de la machine à convertir
+  MT mt_latin = init_machine_turing(path_in, alphabets, sb);
+  if(!mt_latin) return NULL;
+  if(!mt_latin->transitions) {
+    fprintf(stderr, "\n[ERR]: La conversion nécessite le code texte de "
+            "la machine %s\n\n", path_in);
+    free_mt(mt_latin);
+    return NULL;
+  }
+
+  // Codage des symboles de la machine et taille maximale d'une ligne
+  // convertie : deux noms d'états, chacun suivi d'au plus largeur 
+  // numéros de bits (2 chiffres au plus) et 2 * largeur zéros, et les
+  // symboles
+  struct conversion_s cv;
+  memset(&cv, 0, sizeof(cv));
+  size_t nom_max = 0;
+  for(transition tr = mt_latin->transitions; tr; tr = tr->suivant) {
+    if(strlen(tr->etat) > nom_max) nom_max = strlen(tr->etat);
+    if(strlen(tr->nouvel_etat) > nom_max) nom_max = strlen(tr->nouvel_etat);
+  }
+  cv.c = init_codage(mt_latin);
+  cv.taille = TAILLE_INDEX_CONVERSION;
+  cv.cases = (struct ligne_convertie_s*) calloc(cv.taille, 
+                                      sizeof(struct ligne_convertie_s));
+  if(cv.c) cv.ligne = (char*) malloc(2 * (nom_max + 4 * cv.c->largeur) + 16);
+  if(cv.c) cv.autre = (char*) malloc(2 * (nom_max + 4 * cv.c->largeur) + 16);
+  if(!cv.c || !cv.cases || !cv.ligne || !cv.autre) {
+    perror("Erreur d'allocation de la mémoire de la conversion.\n");
+    free_codage(cv.c);
+    free(cv.cases);
+    free(cv.ligne);
+    free(cv.autre);
+    free_mt(mt_latin);
+    return NULL;
   }
 
-  // Ecriture du code de la nouvelle machine obtenue :
   // Ouverture du fichier de destination
   FILE *F;
   if((F = fopen(path_out, "w")) == NULL)
@@ -590,6 +695,11 @@ MT machine_latin_vers_binaire(char *path_in, char *path_out) {
     fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", 
              path_out);
     perror("\n\n");
+    free_codage(cv.c);
+    free(cv.cases);
+    free(cv.ligne);
+    free(cv.autre);
+    free_mt(mt_latin);
     return NULL;
   }
 
@@ -597,15 +707,35 @@ MT machine_latin_vers_binaire(char *path_in, char *path_out) {
   fprintf(F, "init: %s\n", mt_latin->etat_in);
   fprintf(F, "accept: %s\n\n", mt_latin->etat_fin);
 
-  // Ecriture des transitions encodées
-  for(transition tr=mt_transitions->transitions; tr;tr=tr->suivant) {
-    fprintf(F, "%s,%c,%s,%c,%c\n", tr->etat, tr->symbole_lu,
-            tr->nouvel_etat, tr->symbole_ecrit, tr->mouvement);
+  // Convertion et écriture des transitions de la machine : chaque 
+  // transition devient une chaîne d'une transition par bit, dont les 
+  // lignes déjà écrites sont omises
+  int erreur = 0;
+  for(transition tr = mt_latin->transitions; tr && !erreur; 
+      tr = tr->suivant) {
+    for(int niveau = 0; !erreur; niveau++) {
+      int longueur = ligne_convertie(cv.ligne, cv.c, tr, niveau);
+      if(!longueur) break;
+      int nouvelle = ligne_nouvelle(&cv, tr, niveau, longueur);
+      if(nouvelle < 0) erreur = 1;
+      else if(nouvelle) fwrite(cv.ligne, 1, longueur, F);
+    }
   }
 
-  fclose(F);
-
-  free_mt(mt_transitions);
+  if(erreur) perror("Erreur d'allocation de la mémoire de la conversion.\n");
+  if(fclose(F) != 0 && !erreur) {
+    fprintf(stderr, "\n[ERR]: Echec de l'écriture du fichier %s", path_out);
+    perror("\n\n");
+    erreur = 1;
+  }
+  free_codage(cv.c);
+  free(cv.cases);
+  free(cv.ligne);
+  free(cv.autre);
+  if(erreur) {
+    free_mt(mt_latin);
+    return NULL;
+  }
 
   return mt_latin;
 }
\ No newline at end of file
@@ -2,6 +2,12 @@
 #define _machineturing_h_
 
 #include "ruban.h"
+#include "table_transitions.h"
+#include "dictionnaire.h"
+#include "trace.h"
+#include "arene.h"
+
+struct profilage_s;
 
 #define DROITE '>'
 #define GAUCHE '<'
@@ -18,6 +24,9 @@
 * mouvement -> le déplacement à suivre, '>' vers droite, 
 *              '<' vers la gauche et '-' rester sur place
 * nouvel_etat -> le nouvel état
+* id_etat / id_nouvel_etat -> les identifiants de etat et nouvel_etat 
+*                             dans les noms de la machine (mt->noms), -1
+*                             s'ils ne sont pas connus
 * suivant -> pointeur vers la prochaine transition
 */
 struct transition_s {
@@ -26,6 +35,8 @@ struct transition_s {
   char symbole_ecrit;
   char mouvement;
   char *nouvel_etat;
+  int32_t id_etat;
+  int32_t id_nouvel_etat;
   struct transition_s *suivant;
 };
 typedef struct transition_s* transition;
@@ -50,9 +61,22 @@ typedef struct transition_s* transition;
 *                transitions. 
 * transitions_fin -> Pointeur vers le dernier élément de la liste des 
 *                    transitions. 
-* etat_courant -> L'état courant de la machine
-* ruban_courant -> L'état courant du ruban de la machine.
-* tete_lecture -> Pointeur vers la tête de lecture du ruban.
+* table -> La table des transitions compilée, indexée par (etat, symbole)
+*          et utilisée pour l'exécution de la machine.
+* noms -> Les noms des états de la machine : les états des transitions, 
+*         l'état initial et l'état final pointent vers ces chaines
+* arene -> L'arène de la machine, où sont alloués les transitions et les
+*          noms des états : free_mt() les libère en une fois, sans 
+*          parcourir la liste des transitions. NULL pour une machine 
+*          chargée depuis un fichier binaire.
+* projection -> Pour une machine chargée depuis un fichier binaire, la 
+*               projection en mémoire du fichier, dans laquelle pointent
+*               la table, les alphabets et les états ; NULL sinon. La 
+*               liste des transitions est alors vide.
+* taille_projection -> La taille de la projection
+* Une fois construite, la machine n'est plus modifiée par les 
+* simulations : elle peut être partagée par plusieurs exécutions 
+* simultanées, chacune ayant sa propre configuration.
 */
 struct MT_s {
   char *alphabet_entree;
@@ -62,43 +86,101 @@ struct MT_s {
   char symbole_blanc;
   transition transitions;
   transition transitions_fin;
-  char *etat_courant;
-  ruban ruban_courant;
-  ruban tete_lecture;
+  table_transitions table;
+  dictionnaire noms;
+  arene arene;
+  void *projection;
+  size_t taille_projection;
 };
 typedef struct MT_s* MT;
 
 /**
-* Construit une nouvelle transition avec les paramètres d'une transition
+* Structure de données permettant de stocker la configuration d'une 
+* exécution d'une machine de Turing sur un mot.
+* mt -> La machine de Turing exécutée (partagée, non modifiée)
+* etat_courant -> L'identifiant (dans mt->table) de l'état courant
+* ruban_courant -> L'état courant du ruban de la machine.
+* tete_lecture -> La position de la tête de lecture sur le ruban.
+* nb_etapes -> Le nombre d'étapes de calcul effectuées.
+* debut_cycle -> L'étape à partir de laquelle les configurations se 
+*                répètent (résultat RESULTAT_BOUCLE)
+* periode_cycle -> La période du cycle des configurations (résultat 
+*                  RESULTAT_BOUCLE)
+*/
+struct configuration_s {
+  MT mt;
+  int etat_courant;
+  ruban ruban_courant;
+  long tete_lecture;
+  long nb_etapes;
+  long debut_cycle;
+  long periode_cycle;
+};
+typedef struct configuration_s* configuration;
+
+/**
+* Résultat de l'exécution d'une machine sur un mot
+* RESULTAT_REFUSE -> la machine s'est arrêtée hors de l'état final
+* RESULTAT_ACCEPTE -> la machine a atteint l'état final
+* RESULTAT_TIMEOUT -> le nombre maximal d'étapes ou la durée maximale 
+*                     a été atteint
+* RESULTAT_BOUCLE -> la machine est revenue dans une configuration déjà
+*                    rencontrée : elle ne s'arrêtera jamais
 */
-transition creer_transition(char *etat, char sym_lu, char sym_ecrit, char mvt, char *nouv_etat);
+enum resultat {
+  RESULTAT_REFUSE,
+  RESULTAT_ACCEPTE,
+  RESULTAT_TIMEOUT,
+  RESULTAT_BOUCLE
+};
+
+/**
+* Limites d'une exécution
+* max_etapes -> le nombre maximal d'étapes, 0 pour ne pas limiter
+* max_secondes -> la durée maximale en secondes, 0 pour ne pas limiter
+* cycles -> 1 pour détecter les configurations qui se répètent, 0 sinon
+*/
+struct limites_s {
+  long max_etapes;
+  double max_secondes;
+  int cycles;
+};
+typedef struct limites_s* limites;
+
+// Nombre d'étapes exécutées entre deux consultations de l'horloge (et,
+// avec une sauvegarde, des signaux), pour les moteurs limités en durée
+#define TRANCHE_ETAPES (1L << 20)
+
+// Nombre d'étapes (ou de blocs pour le moteur macro) entre deux 
+// consultations de l'horloge, pour les moteurs qui la consultent au fil
+// de l'exécution plutôt qu'entre deux tranches
+#define TRANCHE_HORLOGE 4096
 
 /**
-* Vérifie si une transition existe déjà ou non dans la liste ; 
-* parcoure la liste des transitions et vérifie si la transition 
-* est égale à l'une des transitions existante
-* @param mt : la machine de turing contenant les transitions
-* @param tr : la transition à vérifier
-* @return 1 si tr appartient à mt->transitions, 0 sinon
+* Construit une nouvelle transition avec les paramètres d'une transition
+* @param a : l'arène où allouer la transition (celle de la machine, 
+*            mt->arene) ; la transition est libérée avec l'arène
+* @return la transition, NULL en cas d'erreur d'allocation
 */
-int transition_existe(MT mt, transition tr);
+transition creer_transition(arene a, char *etat, char sym_lu, 
+                            char sym_ecrit, char mvt, char *nouv_etat);
 
 /**
 * Ajoute une nouvelle transition à la fin de la liste chainée des
-* transitions de la machine
+* transitions de la machine ; les doublons ne sont pas filtrés
 * @param mt : la machine de Turing où ajouter la nouvelle transition
 * @param nouveau : la nouvelle transition à ajouter
-* @param distinct : 1 pour une liste où tous les éléments sont distincts
-*                   i.e on n'insert pas de doublon dans la liste
-*                   0 pour une liste avec doublon accepté
 */
-void ajouter_transition(MT mt, transition nouveau, int distinct);
+void ajouter_transition(MT mt, transition nouveau);
 
 /**
 * Affiche une liste chainée de transition
 * @param transitions : la liste chainée de transitions à afficher
+* @param passages : le nombre de passages de chaque transition (indexé
+*                   par sa position dans la liste), affiché à côté de 
+*                   la transition ; NULL pour ne pas l'afficher
 */
-void afficher_transitions(transition transitions);
+void afficher_transitions(transition transitions, const uint64_t *passages);
 
 /**
 * Initialise une machine de Turing à partir d'un fichier contenant la 
@@ -113,6 +195,8 @@ void afficher_transitions(transition transitions);
   q0,0,q1,0,>
 * Hormi cette distinction, nous adoptons le reste du langage. 
 * Les espaces et les sauts de lignes sont bien autorisés.
+* Un fichier au format binaire précompilé (voir binaire.h) est chargé 
+* directement, sans analyse.
 * @param path : chemin vers le fichier contenant la description de la 
 *               machine
 * @param alphabets : les alphabets de la machine, doit être au format 
@@ -128,44 +212,247 @@ MT init_machine_turing(char *path, char *alphabets, char symbole_blanc);
 */
 void free_mt(MT mt);
 
+/**
+* Renvoie le libellé d'un résultat d'exécution (enum resultat), 
+* ex : "ACCEPTE"
+*/
+const char* libelle_resultat(int resultat);
+
+/**
+* Initialise la configuration initiale d'une machine sur un mot : 
+* l'état initial, le mot écrit sur le ruban et la tête de lecture sur
+* la première case du mot.
+* @param mt : la machine de Turing à exécuter
+* @param mot : le mot d'entrée
+* @return la configuration initialisée, NULL en cas d'erreur
+*/
+configuration init_configuration(MT mt, char *mot);
+
+/**
+* Renvoie une copie d'une configuration (y compris son ruban)
+* @param c : la configuration à copier
+* @return la copie, NULL en cas d'erreur
+*/
+configuration copier_configuration(configuration c);
+
+/**
+* Compare deux configurations d'une même machine : état, position de la
+* tête et contenu du ruban (les cases non visitées étant blanches)
+* @return 1 si les configurations sont égales, 0 sinon
+*/
+int configurations_egales(configuration a, configuration b);
+
+/**
+* Remet une configuration dans l'état initial pour un nouveau mot, en
+* réutilisant la mémoire de son ruban
+* @param c : la configuration à réinitialiser
+* @param mot : le nouveau mot d'entrée
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int reinitialiser_configuration(configuration c, char *mot);
+
+/**
+* Libère l'espace mémoire alloué à une configuration (la machine 
+* n'est pas libérée)
+* @param c : la configuration à désallouer
+*/
+void free_configuration(configuration c);
+
 /**
 * Affiche une machine de Turing et sa configuration courante.
-* @param mt -> La machine de Turing à afficher
+* @param c -> La configuration de la machine de Turing à afficher
+* @param t -> La trace utilisée pour afficher la configuration
+*/
+void afficher_machine_turing(configuration c, trace t);
+
+/**
+* Affiche le ruban d'une configuration et son état courant
+* @param c -> La configuration à afficher
+* @param t -> La trace utilisée pour afficher la configuration
 */
-void afficher_machine_turing(MT mt);
+void afficher_ruban_machine(configuration c, trace t);
 
 /**
 * Exécute un pas de calcul d'une machine de Turing. 
-* Le ruban de la machine est supposé initialisé.
-* @param mt : la machine de Turing à exécuter.
-* @param symbole_lu : le symbole (caractère) courant de l'entrée
+* Le ruban de la configuration est supposé initialisé.
+* @param c : la configuration de la machine de Turing à exécuter.
 * @return 0 si le calcul entier de la machine est terminé, 1 sinon
 */
-int simuler_etape(MT mt);
+int simuler_etape(configuration c);
+
+/**
+* Détermine le résultat d'une exécution à partir de sa configuration 
+* finale
+* @param c : la configuration où l'exécution s'est arrêtée
+* @param limite_atteinte : 1 si le nombre maximal d'étapes est atteint
+* @return le résultat de l'exécution (enum resultat)
+*/
+int resultat_configuration(configuration c, int limite_atteinte);
+
+/**
+* Renvoie le temps écoulé en secondes depuis une origine arbitraire 
+* (horloge monotone)
+*/
+double horloge_secondes();
+
+/**
+* Indique si la durée maximale d'une exécution est dépassée
+* @param l : les limites de l'exécution (NULL pour aucune limite)
+* @param debut : l'heure de début de l'exécution (horloge_secondes())
+* @return 1 si la durée est dépassée, 0 sinon
+*/
+int delai_depasse(limites l, double debut);
+
+/**
+* Tranche d'exécution d'un moteur (cf. executer_tranches())
+* @param c : la configuration, mise à jour
+* @param fin_tranche : l'étape à laquelle interrompre l'exécution
+* @param contexte : les données du moteur
+* @return 1 si la machine s'est arrêtée (état final ou absence de 
+*         transition), 0 si l'étape fin_tranche est atteinte, -1 en cas 
+*         d'erreur
+*/
+typedef int (*tranche_moteur)(configuration c, long fin_tranche, 
+                              void *contexte);
+
+/**
+* Résultat d'un moteur qui ne tient pas le ruban de la configuration à
+* jour pendant l'exécution (mêmes paramètres que 
+* resultat_configuration())
+*/
+typedef int (*resultat_moteur)(configuration c, int limite_atteinte,
+                               void *contexte);
+
+/**
+* Exécute une machine par tranches jusqu'à son arrêt ou jusqu'à une 
+* limite : avec une durée maximale, l'exécution est découpée en 
+* tranches de TRANCHE_ETAPES étapes entre lesquelles l'horloge est 
+* consultée
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée), NULL pour ne
+*            pas limiter
+* @param tranche : la fonction qui exécute une tranche
+* @param resultat : la fonction qui détermine le résultat, NULL pour 
+*                   resultat_configuration()
+* @param contexte : les données du moteur, passées à tranche et resultat
+* @return le résultat de l'exécution (enum resultat), -1 si tranche 
+*         renvoie une erreur
+*/
+int executer_tranches(configuration c, limites l, tranche_moteur tranche,
+                      resultat_moteur resultat, void *contexte);
+
+/**
+* Exécute une machine de Turing sans affichage jusqu'à atteindre l'état
+* final, l'arrêt de la machine, le nombre maximal d'étapes ou la durée
+* maximale, ou (si demandé) jusqu'à détecter un cycle de configurations
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution, NULL pour ne pas limiter
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*         d'allocation de la détection des cycles
+*/
+int executer(configuration c, limites l);
 
 /**
 * Simule le calcul d'une machine de Turing sur un mot jusqu'à atteindre 
-* l'état final.
-* @param mt : la machine de Turing à exécuter.
-* param mot : le mot d'entrée à exécuter sur la machine
-* @return 1 si le mot est accepté, 0 sinon
+* l'état final. Le nombre d'étapes effectuées est stocké dans 
+* c->nb_etapes.
+* @param c : la configuration initiale de la machine sur le mot
+* @param t : la trace d'exécution (niveau de verbosité et fenêtre 
+*            d'affichage du ruban)
+* @param l : les limites de l'exécution, NULL pour ne pas limiter
+* @param p : le profil où compter les passages par transition et par 
+*            état et les déplacements de la tête, écrit en JSON à la fin
+*            de l'exécution (cf. profilage.h) ; NULL pour ne pas profiler. 
+*            Avec un profil, l'exécution se fait pas à pas, sans 
+*            détection des cycles.
+* @return le résultat de l'exécution (enum resultat), -1 si le profil
+*         n'a pas pu être écrit ou en cas d'erreur d'allocation de la
+*         détection des cycles
+*/
+int simuler_turing(configuration c, trace t, limites l, 
+                   struct profilage_s *p);
+
+/**
+* Structure de données permettant de stocker le codage binaire des 
+* symboles d'une machine : les k symboles de ses alphabets (entrée puis
+* travail, sans doublon ni symbole blanc) sont numérotés dans leur ordre
+* d'apparition et chaque symbole est codé par son numéro écrit en 
+* binaire sur ceil(log2 k) bits, bit de poids fort en tête.
+* Ex : pour abcd:abcd, code(a)=00, code(b)=01, code(c)=10, code(d)=11
+* largeur -> le nombre de bits du code d'un symbole
+* nb_symboles -> le nombre k de symboles codés
+* ordre -> le numéro de chaque symbole, -1 s'il n'est pas codé
+* entree -> 1 si le symbole appartient à l'alphabet d'entrée, 0 sinon
+* symbole_blanc -> le symbole blanc, codé par lui-même sur chaque bit
+*/
+struct codage_s {
+  int largeur;
+  int nb_symboles;
+  short ordre[256];
+  char entree[256];
+  char symbole_blanc;
+};
+typedef struct codage_s* codage;
+
+/**
+* Crée le codage binaire des symboles d'une machine à partir de ses 
+* alphabets
+* @param mt : la machine
+* @return le codage, NULL en cas d'erreur
+*/
+codage init_codage(MT mt);
+
+/**
+* Libère l'espace mémoire occupé par un codage
+*/
+void free_codage(codage c);
+
+/**
+* Renvoie le i-ème caractère du codage d'un symbole donné
+* @param c : le codage des symboles
+* @param symbole : le symbole à coder
+* @param i : l'indice du bit à renvoyer (0 pour le poids fort)
+* @return le symbole blanc si symbole est le symbole blanc, 
+*         -1 si le symbole n'est pas codé, sinon, '0' ou '1' selon 
+*         le i-ème bit du code de symbole
+*/
+char coder(codage c, char symbole, int i);
+
+/**
+* Code un mot d'entrée symbole par symbole
+* @param c : le codage des symboles
+* @param mot : le mot à coder
+* @return le mot codé (à libérer), NULL si mot contient un symbole 
+*         hors de l'alphabet d'entrée ou en cas d'erreur d'allocation
 */
-int simuler_turing(MT mt, char *mot);
+char* coder_mot(codage c, const char *mot);
 
 /**
 * Cette fonction lit dans un fichier le code d'une machine de Turing 
-*qui travaille sur l'alphabet d'entrée {a,b,c,d} et qui écrit dans un 
-* autre fichier le code d'une machine équivalente travaillant sur 
-* l'alphabet {0,1} avec le codage suivant :
-* code(a) = 00, code(b) = 01, code(c) = 10, code(d) = 11
-* Cette fonction est spécifiquement fait pour cet usage.
+* travaillant sur des alphabets quelconques et écrit dans un autre 
+* fichier le code d'une machine équivalente travaillant sur l'alphabet 
+* {0,1}, chaque symbole étant remplacé par son code (cf. struct 
+* codage_s). Chaque transition est remplacée par une chaîne de 
+* transitions passant par des états intermédiaires, nommés d'après 
+* l'état d'origine et les bits lus : la chaîne lit tous les bits du 
+* symbole, écrit ceux du symbole écrit puis déplace la tête de largeur
+* cases, jusqu'au premier bit du bloc voisin.
+* Les transitions converties sont écrites au fur et à mesure, dans 
+* l'ordre des transitions d'origine, sans copie de la machine en 
+* mémoire. Une ligne déjà écrite (préfixe commun à deux chaînes) est 
+* omise : les lignes écrites sont indexées par leur hachage (table à 
+* adressage ouvert), ce qui rend chaque recherche de doublon O(1) et la
+* conversion linéaire en le nombre de transitions.
 * @param path_in : fichier contenant la description de la machine 
-* à convertir (travaillant sur l'alphabet {a,b,c,d})
+*                  à convertir
 * @param path_out : fichier qui contiendra la description de la machine 
 *                   résultat (travaillant sur l'alphabet {0,1})
+* @param alphabets : les alphabets de la machine à convertir, au format
+*                    alphabet_entree:alphabet_travail (modifié)
 * @return la machine d'origine (codé dans path_in) ou NULL en cas d'erreur
 */
-MT machine_latin_vers_binaire(char *path_in, char *path_out);
+MT machine_latin_vers_binaire(char *path_in, char *path_out, 
+                              char *alphabets);
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,469 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "hachage.h"
+#include "dictionnaire.h"
+#include "macro.h"
+
+#define TAILLE_MEMO_INITIALE 1024
+
+/**
+* Issue de la simulation d'une machine dans un bloc :
+* SORTIE_GAUCHE / SORTIE_DROITE -> la tête est sortie du bloc par la 
+*                                  gauche / la droite
+* SORTIE_ARRET -> la machine s'est arrêtée dans le bloc (état final ou
+*                 absence de transition)
+* SORTIE_LIMITE -> le nombre d'étapes autorisé est épuisé
+*/
+enum sortie_bloc {
+  SORTIE_GAUCHE,
+  SORTIE_DROITE,
+  SORTIE_ARRET,
+  SORTIE_LIMITE
+};
+
+/**
+* Effet mémorisé de l'entrée dans un bloc.
+* bloc -> l'identifiant du contenu du bloc à la sortie
+* etat -> l'état à la sortie du bloc
+* sortie -> l'issue de la simulation (enum sortie_bloc)
+* tete -> la position de la tête dans le bloc à l'arrêt
+* gauche / droite -> les positions extrêmes de la tête dans le bloc
+* etapes -> le nombre d'étapes effectuées dans le bloc
+*/
+struct effet_s {
+  int32_t bloc;
+  int32_t etat;
+  int32_t sortie;
+  int32_t tete;
+  int32_t gauche;
+  int32_t droite;
+  long etapes;
+};
+
+/**
+* Structure de données du moteur macro.
+* table -> la table des transitions de la machine
+* k -> la taille des blocs
+* borne -> au delà de ce nombre d'étapes dans un même bloc, la machine 
+*          y boucle indéfiniment (nombre de configurations d'un bloc)
+* blocs -> les contenus de blocs rencontrés, internalisés
+* cles / effets -> table de hachage (etat, bloc, côté) -> effet
+* taille_memo -> la taille de la table de hachage (puissance de 2)
+* nb_memo -> le nombre d'effets mémorisés
+* ruban -> le macro-ruban : identifiants des contenus des blocs
+* capacite -> le nombre de blocs alloués
+* origine -> l'indice dans ruban du bloc 0
+* min / max -> les blocs extrêmes visités
+*/
+struct macro_s {
+  table_transitions table;
+  int k;
+  long borne;
+  dictionnaire blocs;
+  uint64_t *cles;
+  struct effet_s *effets;
+  long taille_memo;
+  long nb_memo;
+  int32_t *ruban;
+  long capacite;
+  long origine;
+  long min;
+  long max;
+};
+typedef struct macro_s* macro;
+
+/**
+* Division entière arrondie vers -infini
+*/
+static long division_inferieure(long a, long b) {
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+* Calcule le nombre de configurations distinctes d'une machine dans un 
+* bloc : nb_etats * k * nb_symboles^k, saturé à LONG_MAX
+*/
+static long borne_bloc(table_transitions t, int k) {
+  long borne = (long) t->nb_etats * k;
+  for(int i = 0; i < k; i++) {
+    if(borne > LONG_MAX / t->nb_symboles) return LONG_MAX;
+    borne *= t->nb_symboles;
+  }
+  return borne;
+}
+
+/**
+* Cherche l'effet mémorisé d'une entrée dans un bloc
+* @return l'indice de la case de la table de hachage correspondante
+*/
+static long case_memo(macro m, uint64_t cle) {
+  long masque = m->taille_memo - 1;
+  long i = hachage_melanger(cle) & masque;
+  while(m->cles[i] && m->cles[i] != cle) i = (i + 1) & masque;
+  return i;
+}
+
+/**
+* Mémorise l'effet d'une entrée dans un bloc
+*/
+static int memoriser(macro m, uint64_t cle, struct effet_s *effet) {
+  if((m->nb_memo + 1) * 2 > m->taille_memo) {
+    // Agrandissement de la table de hachage : la table n'est remplacée
+    // que si les deux allocations réussissent
+    uint64_t *cles = (uint64_t*) calloc(m->taille_memo * 2, 
+                                        sizeof(uint64_t));
+    struct effet_s *effets = (struct effet_s*) malloc(sizeof(struct effet_s)
+                                                      * m->taille_memo * 2);
+    if(!cles || !effets) {
+      free(cles);
+      free(effets);
+      return 0;
+    }
+    uint64_t *anciennes_cles = m->cles;
+    struct effet_s *anciens_effets = m->effets;
+    long taille = m->taille_memo;
+    m->cles = cles;
+    m->effets = effets;
+    m->taille_memo *= 2;
+    for(long i = 0; i < taille; i++) {
+      if(!anciennes_cles[i]) continue;
+      long j = case_memo(m, anciennes_cles[i]);
+      m->cles[j] = anciennes_cles[i];
+      m->effets[j] = anciens_effets[i];
+    }
+    free(anciennes_cles);
+    free(anciens_effets);
+  }
+  long i = case_memo(m, cle);
+  m->cles[i] = cle;
+  m->effets[i] = *effet;
+  m->nb_memo++;
+  return 1;
+}
+
+/**
+* Agrandit le macro-ruban pour qu'il contienne le bloc b
+*/
+static int etendre_macro_ruban(macro m, long b) {
+  long indice = b + m->origine;
+  if(indice >= 0 && indice < m->capacite) return 1;
+  long ajout = m->capacite;
+  if(indice < 0 && -indice > ajout) ajout = -indice;
+  if(indice >= m->capacite && indice - m->capacite + 1 > ajout) 
+    ajout = indice - m->capacite + 1;
+  int32_t *ruban = (int32_t*) calloc(m->capacite + ajout, sizeof(int32_t));
+  if(!ruban) return 0;
+  long decalage = indice < 0 ? ajout : 0;
+  memcpy(ruban + decalage, m->ruban, sizeof(int32_t) * m->capacite);
+  free(m->ruban);
+  m->ruban = ruban;
+  m->capacite += ajout;
+  m->origine += decalage;
+  return 1;
+}
+
+/**
+* Simule case par case la machine dans un bloc
+* @param t : la table des transitions
+* @param cases : le contenu du bloc, modifié
+* @param k : la taille du bloc
+* @param etat : l'état courant, mis à jour
+* @param tete : la position de la tête dans le bloc, mise à jour
+* @param gauche / droite : les positions extrêmes de la tête dans le 
+*                         bloc, mises à jour
+* @param limite : le nombre maximal d'étapes à effectuer
+* @param etapes : le nombre d'étapes effectuées
+* @return l'issue de la simulation (enum sortie_bloc)
+*/
+static int simuler_bloc(table_transitions t, cellule *cases, int k, 
+                        int *etat, int *tete, int *gauche, int *droite,
+                        long limite, long *etapes) {
+  int e = *etat, p = *tete, sortie;
+  if(p < *gauche) *gauche = p;
+  if(p > *droite) *droite = p;
+  long n = 0;
+  for(;;) {
+    if(e == t->etat_fin) { sortie = SORTIE_ARRET; break; }
+    int32_t i = table_chercher(t, e, cases[p]);
+    if(i < 0) { sortie = SORTIE_ARRET; break; }
+    if(n >= limite) { sortie = SORTIE_LIMITE; break; }
+    regle r = &t->regles[i];
+    cases[p] = r->symbole_ecrit;
+    e = r->nouvel_etat;
+    p += r->deplacement;
+    n++;
+    if(p < 0) { sortie = SORTIE_GAUCHE; break; }
+    if(p >= k) { sortie = SORTIE_DROITE; break; }
+    if(p < *gauche) *gauche = p;
+    if(p > *droite) *droite = p;
+  }
+  *etat = e;
+  *tete = p;
+  *etapes = n;
+  return sortie;
+}
+
+/**
+* Simule case par case la machine dans un bloc (mêmes paramètres que
+* simuler_bloc()) par tranches de TRANCHE_ETAPES étapes, l'horloge 
+* étant consultée entre deux tranches : la borne de détection d'une 
+* boucle dans un bloc peut dépasser de loin la durée maximale
+* @param l / debut : les limites et l'heure de début de l'exécution
+* @param delai : mis à 1 si la durée maximale est dépassée
+* @return l'issue de la simulation (enum sortie_bloc), SORTIE_LIMITE si
+*         la durée maximale est dépassée
+*/
+static int simuler_bloc_tranches(table_transitions t, cellule *cases, 
+                                 int k, int *etat, int *tete, int *gauche,
+                                 int *droite, long limite, long *etapes,
+                                 limites l, double debut, int *delai) {
+  long n = 0, tranche;
+  int sortie;
+  do {
+    sortie = simuler_bloc(t, cases, k, etat, tete, gauche, droite, 
+                          limite - n < TRANCHE_ETAPES ? limite - n 
+                                                      : TRANCHE_ETAPES,
+                          &tranche);
+    n += tranche;
+  } while(sortie == SORTIE_LIMITE && n < limite 
+          && !(*delai = delai_depasse(l, debut)));
+  *etapes = n;
+  return sortie;
+}
+
+/**
+* Avance d'une étape la machine dans un bloc où elle boucle
+*/
+static void avancer_bloc(table_transitions t, cellule *cases, int k, 
+                         int *etat, int *tete) {
+  int gauche = k, droite = -1;
+  long etapes;
+  simuler_bloc(t, cases, k, etat, tete, &gauche, &droite, 1, &etapes);
+}
+
+/**
+* Calcule le cycle d'une machine qui boucle dans un bloc : le reste du 
+* ruban ne change plus, le cycle des configurations est celui du bloc
+* @param t : la table des transitions
+* @param initial / etat / tete : le contenu du bloc, l'état et la 
+*                                position de la tête à l'entrée dans le
+*                                bloc
+* @param cycle / etat_cycle / tete_cycle : une configuration du bloc 
+*                                          atteinte dans le cycle
+* @param k : la taille du bloc
+* @param debut : le nombre d'étapes depuis l'entrée dans le bloc avant 
+*                le début du cycle
+* @param periode : la période du cycle
+*/
+static void cycle_bloc(table_transitions t, const cellule *initial, 
+                       int etat, int tete, const cellule *cycle, 
+                       int etat_cycle, int tete_cycle, int k, long *debut,
+                       long *periode) {
+  cellule a[TAILLE_BLOC_MAX], b[TAILLE_BLOC_MAX];
+  int ea = etat_cycle, ta = tete_cycle, eb = etat, tb = tete;
+  memcpy(a, cycle, k);
+  long n = 0;
+  do {
+    avancer_bloc(t, a, k, &ea, &ta);
+    n++;
+  } while(ea != etat_cycle || ta != tete_cycle || memcmp(a, cycle, k));
+  *periode = n;
+  // Deux exécutions depuis l'entrée dans le bloc, décalées d'une 
+  // période, se rejoignent au début du cycle
+  memcpy(a, initial, k);
+  memcpy(b, initial, k);
+  ea = etat;
+  ta = tete;
+  for(long i = 0; i < n; i++) avancer_bloc(t, b, k, &eb, &tb);
+  for(n = 0; ea != eb || ta != tb || memcmp(a, b, k); n++) {
+    avancer_bloc(t, a, k, &ea, &ta);
+    avancer_bloc(t, b, k, &eb, &tb);
+  }
+  *debut = n;
+}
+
+/**
+* Libère l'espace mémoire alloué au moteur macro
+*/
+static void free_macro(macro m) {
+  free_dictionnaire(m->blocs);
+  free(m->cles);
+  free(m->effets);
+  free(m->ruban);
+  free(m);
+}
+
+/**
+* Construit le moteur macro et son macro-ruban à partir du ruban d'une
+* configuration
+*/
+static macro init_macro(configuration c, int k) {
+  macro m = (macro) calloc(1, sizeof(struct macro_s));
+  if(!m) return NULL;
+  ruban r = c->ruban_courant;
+  m->table = c->mt->table;
+  m->k = k;
+  m->borne = borne_bloc(m->table, k);
+  m->blocs = init_dictionnaire();
+  m->taille_memo = TAILLE_MEMO_INITIALE;
+  m->cles = (uint64_t*) calloc(m->taille_memo, sizeof(uint64_t));
+  m->effets = (struct effet_s*) malloc(sizeof(struct effet_s) 
+                                       * m->taille_memo);
+  // Le bloc blanc reçoit l'identifiant 0, valeur des blocs jamais 
+  // visités du macro-ruban
+  cellule blanc[TAILLE_BLOC_MAX];
+  memset(blanc, r->symbole_blanc, k);
+  m->min = division_inferieure(r->min, k);
+  m->max = division_inferieure(r->max, k);
+  m->capacite = 2 * (m->max - m->min + 1) + 16;
+  m->origine = (m->capacite - (m->max - m->min + 1)) / 2 - m->min;
+  m->ruban = (int32_t*) calloc(m->capacite, sizeof(int32_t));
+  if(!m->blocs || !m->cles || !m->effets || !m->ruban
+     || dictionnaire_ajouter(m->blocs, (char*) blanc, k) != 0
+     || !ruban_etendre(r, m->min * k) 
+     || !ruban_etendre(r, m->max * k + k - 1)) {
+    free_macro(m);
+    return NULL;
+  }
+  for(long b = m->min; b <= m->max; b++) {
+    int id = dictionnaire_ajouter(m->blocs, (char*) ruban_case(r, b * k), k);
+    if(id < 0) {
+      free_macro(m);
+      return NULL;
+    }
+    m->ruban[b + m->origine] = id;
+  }
+  return m;
+}
+
+/**
+* Recopie le macro-ruban dans le ruban de la configuration
+* @param min / max : les positions extrêmes visitées par la tête, qui
+*                    deviennent les bornes du ruban (les cases des blocs
+*                    au delà n'ont pas été visitées)
+*/
+static int ecrire_ruban(macro m, ruban r, long min, long max) {
+  int k = m->k;
+  if(!ruban_etendre(r, m->min * k) || !ruban_etendre(r, m->max * k + k - 1))
+    return 0;
+  for(long b = m->min; b <= m->max; b++) 
+    memcpy(ruban_case(r, b * k), m->blocs->chaines[m->ruban[b + m->origine]],
+           k);
+  r->min = min;
+  r->max = max;
+  return 1;
+}
+
+int executer_macro(configuration c, int k, limites l) {
+  if(k < 1 || k > TAILLE_BLOC_MAX) {
+    fprintf(stderr, "\n[ERR]: La taille des blocs doit être comprise "
+            "entre 1 et %d\n\n", TAILLE_BLOC_MAX);
+    return -1;
+  }
+  macro m = init_macro(c, k);
+  if(!m) {
+    perror("Erreur d'allocation de la mémoire du moteur macro.\n");
+    return -1;
+  }
+  table_transitions t = m->table;
+  long max_etapes = l && l->max_etapes > 0 ? l->max_etapes : 0;
+  long limite = max_etapes > 0 ? max_etapes : LONG_MAX;
+  double debut = horloge_secondes();
+  long nb_blocs = 0;
+  long n = c->nb_etapes;
+  int etat = c->etat_courant;
+  long b = division_inferieure(c->tete_lecture, k);
+  int tete = c->tete_lecture - b * k;
+  long min = c->ruban_courant->min, max = c->ruban_courant->max;
+  int erreur = 0, boucle = 0, delai = 0;
+  cellule cases[TAILLE_BLOC_MAX];
+
+  for(;;) {
+    if(++nb_blocs % TRANCHE_HORLOGE == 0 && (delai = delai_depasse(l, debut)))
+      break;
+    int32_t *bloc = &m->ruban[b + m->origine];
+    // L'effet d'un bloc ne peut être mémorisé que si la tête y entre 
+    // par l'un de ses bords
+    int entree = tete == 0 || tete == k - 1;
+    // Le bit de poids fort distingue les clés de la valeur 0 (case vide)
+    uint64_t cle = (1ULL << 63) | ((uint64_t) *bloc << 32) 
+                   | ((uint64_t) etat << 1) | (tete != 0);
+    struct effet_s effet;
+    long i = case_memo(m, cle);
+
+    if(entree && m->cles[i] == cle && m->effets[i].etapes <= limite - n) {
+      // Effet déjà connu : il est appliqué en une seule fois
+      effet = m->effets[i];
+    } 
+    else {
+      // Simulation case par case dans le bloc, bornée par le nombre de
+      // configurations du bloc pour détecter une boucle infinie
+      memcpy(cases, m->blocs->chaines[*bloc], k);
+      effet.etat = etat;
+      effet.tete = tete;
+      effet.gauche = k;
+      effet.droite = -1;
+      long restant = limite - n;
+      int boucle_possible = m->borne < restant;
+      effet.sortie = simuler_bloc_tranches(t, cases, k, &effet.etat, 
+                       &effet.tete, &effet.gauche, &effet.droite, 
+                       boucle_possible ? m->borne + 1 : restant, 
+                       &effet.etapes, l, debut, &delai);
+      if(effet.sortie == SORTIE_LIMITE && boucle_possible && !delai) {
+        // La machine ne sortira jamais du bloc : elle n'atteint que la 
+        // limite d'étapes, qu'on simule si elle existe
+        if(max_etapes <= 0) {
+          long debut_cycle;
+          cycle_bloc(t, (cellule*) m->blocs->chaines[*bloc], etat, tete,
+                     cases, effet.etat, effet.tete, k, &debut_cycle, 
+                     &c->periode_cycle);
+          c->debut_cycle = n + debut_cycle;
+          boucle = 1;
+        } else {
+          long supplement;
+          simuler_bloc_tranches(t, cases, k, &effet.etat, &effet.tete, 
+                                &effet.gauche, &effet.droite, 
+                                restant - effet.etapes, &supplement, l, 
+                                debut, &delai);
+          effet.etapes += supplement;
+        }
+        effet.sortie = SORTIE_LIMITE;
+      }
+      effet.bloc = dictionnaire_ajouter(m->blocs, (char*) cases, k);
+      if(effet.bloc < 0) { erreur = 1; break; }
+      if(entree && effet.sortie != SORTIE_LIMITE 
+         && !memoriser(m, cle, &effet)) { erreur = 1; break; }
+    }
+
+    *bloc = effet.bloc;
+    etat = effet.etat;
+    n += effet.etapes;
+    if(b * k + effet.gauche < min) min = b * k + effet.gauche;
+    if(b * k + effet.droite > max) max = b * k + effet.droite;
+    if(effet.sortie == SORTIE_GAUCHE || effet.sortie == SORTIE_DROITE) {
+      b += effet.sortie == SORTIE_GAUCHE ? -1 : 1;
+      tete = effet.sortie == SORTIE_GAUCHE ? k - 1 : 0;
+      if(!etendre_macro_ruban(m, b)) { erreur = 1; break; }
+      if(b < m->min) m->min = b;
+      if(b > m->max) m->max = b;
+    } else {
+      tete = effet.tete;
+      break;
+    }
+  }
+
+  if(erreur || !ecrire_ruban(m, c->ruban_courant, min, max)) {
+    perror("Erreur d'allocation de la mémoire du moteur macro.\n");
+    free_macro(m);
+    return -1;
+  }
+  c->etat_courant = etat;
+  c->tete_lecture = b * k + tete;
+  c->nb_etapes = n;
+  free_macro(m);
+  if(boucle) return RESULTAT_BOUCLE;
+  return resultat_configuration(c, n >= limite || delai);
+}
@@ -0,0 +1,35 @@
+#ifndef _macro_h_
+#define _macro_h_
+
+#include "machineturing.h"
+
+/**
+* Taille maximale (en cases) d'un bloc du moteur macro
+*/
+#define TAILLE_BLOC_MAX 64
+
+/**
+* Exécute une machine de Turing avec le moteur macro : le ruban est 
+* découpé en blocs de k cases consécutives, chaque bloc étant vu comme
+* un macro-symbole. La première fois que la machine entre dans un bloc 
+* d'un contenu donné, dans un état donné et par un côté donné, le 
+* calcul dans le bloc est simulé case par case et son effet (nouveau 
+* contenu, état et côté de sortie, nombre d'étapes) est mémorisé ; les
+* fois suivantes, cet effet est appliqué directement. Le nombre 
+* d'étapes obtenu est exact et le résultat est le même qu'avec 
+* executer(), sauf pour une machine qui ne sort plus d'un bloc : sans 
+* limite d'étapes, elle est arrêtée avec le résultat RESULTAT_BOUCLE et
+* le début et la période de son cycle dans c->debut_cycle et 
+* c->periode_cycle.
+* @param c : la configuration de départ, mise à jour (état, ruban, 
+*            position de la tête et nombre d'étapes)
+* @param k : la taille des blocs, entre 1 et TAILLE_BLOC_MAX
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite par ce moteur), NULL pour ne pas
+*            limiter
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int executer_macro(configuration c, int k, limites l);
+
+
+#endif
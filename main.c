@@ -2,10 +2,253 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <readline/readline.h>
 #include <readline/history.h>
 
 #include "machineturing.h"
+#include "lot.h"
+#include "macro.h"
+#include "castor.h"
+#include "natif.h"
+#include "threade.h"
+#include "binaire.h"
+#include "bits.h"
+#include "rle.h"
+#include "multiruban.h"
+#include "nondeterministe.h"
+#include "sauvegarde.h"
+#include "profilage.h"
+#include "debogueur.h"
+#include "trace_binaire.h"
+#include "optimiseur.h"
+#include "journal.h"
+
+/**
+* Moteurs d'exécution disponibles
+* MOTEUR_TABLE -> exécution pas à pas avec la table des transitions
+* MOTEUR_MACRO -> exécution par blocs de k cases avec mémorisation
+* MOTEUR_NATIF -> exécution du code C compilé de la machine
+* MOTEUR_THREADE -> exécution du code threadé (goto calculé)
+* MOTEUR_COMPARER -> exécution avec la table et avec le code threadé, 
+*                    et comparaison des deux exécutions
+* MOTEUR_BITS -> exécution sur un ruban compacté (1 ou 2 bits par case)
+* MOTEUR_RLE -> exécution sur un ruban compressé en plages, les boucles
+*               sur un état traversant une plage en une fois
+* MOTEUR_NTM -> exploration en largeur de toutes les branches d'une 
+*               machine non déterministe
+*/
+enum moteur {
+  MOTEUR_TABLE,
+  MOTEUR_MACRO,
+  MOTEUR_NATIF,
+  MOTEUR_THREADE,
+  MOTEUR_COMPARER,
+  MOTEUR_BITS,
+  MOTEUR_RLE,
+  MOTEUR_NTM
+};
+
+// Noms des moteurs sur la ligne de commande (dans l'ordre de l'enum)
+const char *noms_moteurs[] = { "table", "macro", "natif", "threade", 
+                               "comparer", "bits", "rle", "ntm", NULL };
+
+/**
+* Options de la ligne de commande du programme
+* t -> la trace d'exécution des simulations
+* fichier_lot -> le fichier des mots à exécuter en mode lot ('-' pour 
+*                l'entrée standard), NULL hors du mode lot
+* nb_threads -> le nombre de threads du mode lot
+* limites -> les limites (étapes, durée, détection des cycles) de 
+*            chaque exécution
+* moteur -> le moteur d'exécution (enum moteur)
+* taille_bloc -> la taille des blocs du moteur macro
+* sauvegarde -> le fichier des instantanés de l'exécution, NULL pour ne
+*               pas en prendre
+* intervalle -> le nombre de secondes entre deux instantanés
+* reprise -> l'instantané depuis lequel reprendre l'exécution, NULL pour
+*            partir du mot d'entrée
+* fichier_profil -> le fichier où écrire le profil de l'exécution en 
+*                   JSON ('-' pour la sortie standard), NULL pour ne pas
+*                   profiler
+* debogueur -> 1 pour exécuter la machine dans le débogueur, 0 sinon
+* capacite_journal -> le nombre d'étapes annulables du débogueur
+* intervalle_points -> le nombre d'étapes entre deux points de reprise
+*                      du débogueur, 0 pour ne garder que l'état initial
+* trace_binaire -> le fichier où écrire la trace binaire de l'exécution,
+*                  NULL pour ne pas en écrire
+* compresser -> 1 pour compresser les blocs de la trace binaire
+*/
+struct options_s {
+  trace t;
+  char *fichier_lot;
+  int nb_threads;
+  struct limites_s limites;
+  int moteur;
+  int taille_bloc;
+  char *sauvegarde;
+  double intervalle;
+  char *reprise;
+  char *fichier_profil;
+  int debogueur;
+  long capacite_journal;
+  long intervalle_points;
+  char *trace_binaire;
+  int compresser;
+};
+typedef struct options_s* options;
+
+/**
+* Exécute une machine sur une configuration avec le code threadé
+* @param c : la configuration initiale, mise à jour
+* @param l : les limites de l'exécution
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int executer_programme(configuration c, limites l) {
+  programme p = compiler_programme(c->mt->table);
+  if(!p) return -1;
+  int res = executer_threade(p, c, l);
+  free_programme(p);
+  return res;
+}
+
+/**
+* Exécute une machine avec la table des transitions (executer()) et 
+* avec le code threadé, et vérifie que les deux exécutions donnent le 
+* même résultat, le même nombre d'étapes et la même configuration finale
+* @param c : la configuration initiale, mise à jour par le code threadé
+* @param l : les limites de l'exécution ; seul le nombre maximal 
+*            d'étapes est pris en compte, la durée et la détection des 
+*            cycles rendant les deux exécutions incomparables
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*         ou de différence
+*/
+int comparer_moteurs(configuration c, limites l) {
+  struct limites_s etapes = { l->max_etapes, 0, 0 };
+  configuration copie = copier_configuration(c);
+  if(!copie) return -1;
+  int res_table = executer(copie, &etapes);
+  int res = executer_programme(c, &etapes);
+  if(res >= 0 && (res != res_table || c->nb_etapes != copie->nb_etapes 
+                  || !configurations_egales(c, copie))) {
+    fprintf(stderr, "\n[ERR]: Exécutions différentes : table %s en %ld "
+            "étapes, threadé %s en %ld étapes%s\n\n", 
+            libelle_resultat(res_table), copie->nb_etapes, 
+            libelle_resultat(res), c->nb_etapes, 
+            res == res_table && c->nb_etapes == copie->nb_etapes 
+            ? " (configurations finales différentes)" : "");
+    res = -1;
+  } else if(res >= 0) {
+    fprintf(stderr, "[COMPARAISON]: table et threadé identiques (%s, %ld "
+            "étapes)\n", libelle_resultat(res), c->nb_etapes);
+  }
+  free_configuration(copie);
+  return res;
+}
+
+/**
+* Exécute une machine sur une configuration avec le moteur choisi. Les
+* moteurs autres que la table n'affichent que la configuration finale.
+* @param c : la configuration initiale
+* @param opt : les options de l'exécution
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int executer_moteur(configuration c, options opt) {
+  int res;
+  natif n;
+  switch(opt->moteur) {
+    case MOTEUR_MACRO:
+      res = executer_macro(c, opt->taille_bloc, &opt->limites);
+      break;
+    case MOTEUR_NATIF:
+      if(!(n = charger_natif(c->mt))) return -1;
+      res = executer_natif(n, c, &opt->limites);
+      free_natif(n);
+      break;
+    case MOTEUR_THREADE:
+      res = executer_programme(c, &opt->limites);
+      break;
+    case MOTEUR_COMPARER:
+      res = comparer_moteurs(c, &opt->limites);
+      break;
+    case MOTEUR_BITS:
+      // Le ruban n'est recopié que pour être affiché
+      res = executer_bits(c, &opt->limites, 
+                          opt->t->niveau != TRACE_SILENCIEUSE, stderr);
+      break;
+    case MOTEUR_RLE:
+      res = executer_rle(c, &opt->limites, 
+                         opt->t->niveau != TRACE_SILENCIEUSE, stderr);
+      break;
+    case MOTEUR_NTM:
+      res = executer_non_deterministe(c, &opt->limites, opt->nb_threads,
+                                      opt->t->niveau != TRACE_SILENCIEUSE, 
+                                      stderr);
+      break;
+    default:
+      return simuler_turing(c, opt->t, &opt->limites, NULL);
+  }
+  if(res >= 0 && opt->t->niveau != TRACE_SILENCIEUSE) 
+    trace_afficher(opt->t, table_nom_etat(c->mt->table, c->etat_courant),
+                   c->ruban_courant, c->tete_lecture, c->nb_etapes);
+  return res;
+}
+
+/**
+* Exécute une machine avec la table des transitions en relevant son 
+* profil (cf. profilage.h), écrit en JSON dans opt->fichier_profil
+* @param c : la configuration initiale, mise à jour
+* @param opt : les options de l'exécution
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int profiler_machine(configuration c, options opt) {
+  FILE *F = stdout;
+  if(strcmp(opt->fichier_profil, "-") && 
+     (F = fopen(opt->fichier_profil, "w")) == NULL) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", 
+            opt->fichier_profil);
+    perror("\n\n");
+    return -1;
+  }
+  profilage p = init_profil(c, F);
+  int res = p ? simuler_turing(c, opt->t, &opt->limites, p) : -1;
+  free_profil(p);
+  if(F != stdout && fclose(F) == EOF) {
+    perror("\n[ERR]: Echec de l'écriture du profil");
+    res = -1;
+  }
+  return res;
+}
+
+/**
+* Simule une machine de turing à plusieurs rubans sur un mot d'entrée 
+* et affiche le résultat (mêmes paramètres que simuler_machine())
+* @return 1 en cas d'erreur lors de l'exécution, 0 sinon
+*/
+int simuler_multiruban(char *path, char *alphabets, char sb, 
+                       char *mot_entree, options opt) {
+  if(opt->moteur != MOTEUR_TABLE || opt->limites.cycles || opt->sauvegarde
+     || opt->fichier_profil || opt->debogueur || opt->trace_binaire) {
+    fprintf(stderr, "\n[ERR]: Les machines à plusieurs rubans ne "
+            "s'exécutent qu'avec le moteur 'table', sans détection des "
+            "cycles, sauvegarde, profil, débogueur ni trace binaire\n\n");
+    return 1;
+  }
+  MT_multi mt = init_machine_multiruban(path, alphabets, sb);
+  if(!mt) return 1;
+  configuration_multi c = init_configuration_multi(mt, mot_entree);
+  if(!c) {
+    free_mt_multi(mt);
+    return 1;
+  }
+  int res = executer_multi(c, opt->t, &opt->limites);
+  printf("%s\n", libelle_resultat(res));
+  printf("Nombre d'étapes : %ld\n", c->nb_etapes);
+
+  free_configuration_multi(c);
+  free_mt_multi(mt);
+  return 0;
+}
 
 /**
 * Simule une machine de turing sur un mot d'entrée et affiche le 
@@ -15,61 +258,267 @@
 *                    alphabet_entree:alphabet_travail
 * @param sb : le symbole blanc de la machine
 * @param mot_entree : le mot d'entrée à simuler
+* @param opt : les options de la simulation
 * @return 1 en cas d'erreur lors de l'exécution, 0 sinon
 */
 int simuler_machine(char *path, char *alphabets, char sb, 
-                    char *mot_entree) {
+                    char *mot_entree, options opt) {
+  if(est_machine_multiruban(path)) 
+    return simuler_multiruban(path, alphabets, sb, mot_entree, opt);
+  // Le hachage de la machine est calculé avant l'analyse, qui modifie
+  // les alphabets
+  uint64_t hachage = 0;
+  sauvegarde s = NULL;
+  if(opt->sauvegarde 
+     && (!hacher_machine(path, alphabets, sb, &hachage) 
+         || !(s = init_sauvegarde(opt->sauvegarde, hachage, 
+                                  opt->intervalle))))
+    return 1;
   MT mt = init_machine_turing(path, alphabets, sb);
-  if(!mt) return 1;
-  if(simuler_turing(mt, mot_entree)) printf("ACCEPTE\n");
-  else printf("REFUSE\n");
+  configuration c = mt ? init_configuration(mt, mot_entree) : NULL;
+  if(!c || (opt->reprise && !reprendre_sauvegarde(opt->reprise, hachage, c))) {
+    free_configuration(c);
+    if(mt) free_mt(mt);
+    free_sauvegarde(s);
+    return 1;
+  }
+  int res;
+  if(s) {
+    res = executer_sauvegarde(c, &opt->limites, s);
+    if(opt->t->niveau != TRACE_SILENCIEUSE) 
+      trace_afficher(opt->t, table_nom_etat(mt->table, c->etat_courant),
+                     c->ruban_courant, c->tete_lecture, c->nb_etapes);
+    if(!free_sauvegarde(s)) res = -1;
+  } else if(opt->fichier_profil) {
+    res = profiler_machine(c, opt);
+  } else if(opt->debogueur) {
+    res = deboguer(c, opt->t, &opt->limites, opt->capacite_journal, 
+                   opt->intervalle_points);
+  } else if(opt->trace_binaire) {
+    trace_binaire tb = init_trace_binaire(opt->trace_binaire, c, 
+                                          opt->compresser);
+    res = tb ? executer_trace_binaire(c, &opt->limites, tb) : -1;
+    if(tb && opt->t->niveau != TRACE_SILENCIEUSE) 
+      trace_afficher(opt->t, table_nom_etat(mt->table, c->etat_courant),
+                     c->ruban_courant, c->tete_lecture, c->nb_etapes);
+    if(tb && !fermer_trace_binaire(tb, c, res, stderr)) res = -1;
+  } else {
+    res = executer_moteur(c, opt);
+  }
+  if(res < 0) {
+    free_configuration(c);
+    free_mt(mt);
+    return 1;
+  }
+  printf("%s\n", libelle_resultat(res));
+  printf("Nombre d'étapes : %ld\n", c->nb_etapes);
+  if(res == RESULTAT_BOUCLE) 
+    printf("Cycle de configurations : début à l'étape %ld, période %ld\n",
+           c->debut_cycle, c->periode_cycle);
 
+  free_configuration(c);
   free_mt(mt);
 
   return 0;
 }
 
 /**
-* Code un mot d'entrée à exécuter sur la machine convertie en utilisant
-* le codage code(a)=00,code(b)=01,code(c)=10,code(d)=11
-*/
-char* coder_mot(char *mot_entree) {
-  const char codage[4][2] = {"00","01","10","11"};
-  char *res = (char*) malloc(sizeof(char) * strlen(mot_entree) * 2 + 1);
-  int ordre, i;
-  
-  for(i=0; i<strlen(mot_entree); i++) {
-    // L'ordre du caractère du symbole i dans l'alphabet. 
-    // ex: a->0, b->1, c->2, d->3
-    ordre = mot_entree[i]-'a';
-    // Si le symbole n'est pas dans l'alphabet 
-    // (est différent de a,b,c et d), erreur.
-    if(ordre < 0 || ordre > 3) 
-    {
-      free(res);
-      return NULL;
-    }
+* Compile une machine de Turing et l'écrit au format binaire
+* @param path : chemin vers la machine à compiler
+* @param alphabets : les alphabets de la machine, au format
+*                    alphabet_entree:alphabet_travail
+* @param sb : le symbole blanc de la machine
+* @param sortie : le fichier binaire à créer
+* @return 1 en cas d'erreur, 0 sinon
+*/
+int compiler_binaire(char *path, char *alphabets, char sb, char *sortie) {
+  MT mt = init_machine_turing(path, alphabets, sb);
+  if(!mt) return 1;
+  int ok = ecrire_machine_binaire(mt, sortie);
+  if(ok) 
+    fprintf(stderr, "[BINAIRE]: %d états, %d règles écrits dans %s\n", 
+            mt->table->nb_etats, mt->table->nb_regles, sortie);
+  free_mt(mt);
+  return !ok;
+}
 
-    res[i*2] = codage[ordre][0];
-    res[i*2 + 1] = codage[ordre][1];
+// Limite d'étapes par défaut de la comparaison des machines d'origine et
+// optimisée : la machine d'origine peut ne pas s'arrêter
+#define ETAPES_COMPARAISON_DEFAUT 100000000
+
+/**
+* Optimise une machine de Turing et l'écrit au format texte, puis 
+* compare le nombre d'étapes des deux machines sur les mots de 
+* opt->fichier_lot s'il est donné
+* @param path : chemin vers la machine à optimiser
+* @param alphabets : les alphabets de la machine, au format
+*                    alphabet_entree:alphabet_travail
+* @param sb : le symbole blanc de la machine
+* @param sortie : le fichier de la machine optimisée
+* @param opt : les options (mots et limites de la comparaison)
+* @return 1 en cas d'erreur, 0 sinon
+*/
+int optimiser(char *path, char *alphabets, char sb, char *sortie, 
+              options opt) {
+  // Copie des alphabets, modifiés par l'analyse, pour relire la machine
+  // optimisée
+  char *alphabets_optimisee = strdup(alphabets);
+  MT mt = alphabets_optimisee ? init_machine_turing(path, alphabets, sb) 
+                              : NULL;
+  struct rapport_optimisation_s r;
+  int ok = mt && optimiser_machine(mt, sortie, &r);
+  if(ok) {
+    afficher_rapport_optimisation(&r, stderr);
+    fprintf(stderr, "[OPTIM]: machine optimisée écrite dans %s\n", sortie);
+  }
+  FILE *F = stdin;
+  if(ok && opt->fichier_lot && strcmp(opt->fichier_lot, "-") && 
+     (F = fopen(opt->fichier_lot, "r")) == NULL) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", 
+            opt->fichier_lot);
+    perror("\n\n");
+    ok = 0;
+  }
+  if(ok && opt->fichier_lot) {
+    struct limites_s l = opt->limites;
+    if(!l.max_etapes && !l.max_secondes) 
+      l.max_etapes = ETAPES_COMPARAISON_DEFAUT;
+    MT optimisee = init_machine_turing(sortie, alphabets_optimisee, sb);
+    ok = optimisee && comparer_machines(mt, optimisee, F, &l, stderr);
+    if(optimisee) free_mt(optimisee);
+    if(F != stdin) fclose(F);
   }
-  res[2*i] = '\0';
+  if(mt) free_mt(mt);
+  free(alphabets_optimisee);
+  return !ok;
+}
 
-  return res;
+/**
+* Données des moteurs du mode lot, préparées une seule fois et partagées
+* par ses threads
+* opt -> les options de l'exécution (moteur, taille des blocs)
+* n -> le code natif de la machine (moteur 'natif')
+* p -> le code threadé de la machine (moteur 'threade')
+*/
+struct moteur_lot_s {
+  options opt;
+  natif n;
+  programme p;
+};
+
+/**
+* Exécute un mot du mode lot avec le moteur choisi (cf. moteur_lot). 
+* Les moteurs n'affichent rien et ne recopient pas le ruban ; 
+* l'exploration non déterministe d'un mot se fait sur un seul thread, 
+* les mots étant déjà répartis entre les threads du lot.
+*/
+static int executer_mot_lot(configuration c, limites l, void *contexte) {
+  struct moteur_lot_s *m = (struct moteur_lot_s*) contexte;
+  switch(m->opt->moteur) {
+    case MOTEUR_MACRO:
+      return executer_macro(c, m->opt->taille_bloc, l);
+    case MOTEUR_NATIF:
+      return executer_natif(m->n, c, l);
+    case MOTEUR_THREADE:
+      return executer_threade(m->p, c, l);
+    case MOTEUR_COMPARER:
+      return comparer_moteurs(c, l);
+    case MOTEUR_BITS:
+      return executer_bits(c, l, 0, NULL);
+    case MOTEUR_RLE:
+      return executer_rle(c, l, 0, NULL);
+    case MOTEUR_NTM:
+      return executer_non_deterministe(c, l, 1, 0, NULL);
+    default:
+      return executer(c, l);
+  }
+}
+
+/**
+* Exécute une machine de Turing en mode lot sur les mots d'un fichier
+* (un mot par ligne) et affiche le résultat de chaque mot.
+* @param path : chemin vers la machine à exécuter
+* @param alphabets : les alphabets de la machine, au format
+*                    alphabet_entree:alphabet_travail
+* @param sb : le symbole blanc de la machine
+* @param opt : les options de l'exécution
+* @return 1 en cas d'erreur lors de l'exécution, 0 sinon
+*/
+int simuler_lot(char *path, char *alphabets, char sb, options opt) {
+  FILE *F = stdin;
+  if(strcmp(opt->fichier_lot, "-") && 
+     (F = fopen(opt->fichier_lot, "r")) == NULL) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", 
+            opt->fichier_lot);
+    perror("\n\n");
+    return 1;
+  }
+  MT mt = init_machine_turing(path, alphabets, sb);
+  if(!mt) {
+    if(F != stdin) fclose(F);
+    return 1;
+  }
+  // Le code natif ou threadé est préparé une fois pour tous les mots
+  struct moteur_lot_s m = { opt, NULL, NULL };
+  int ret = 1;
+  if(opt->moteur == MOTEUR_NATIF) m.n = charger_natif(mt);
+  if(opt->moteur == MOTEUR_THREADE) m.p = compiler_programme(mt->table);
+  if((opt->moteur != MOTEUR_NATIF || m.n) 
+     && (opt->moteur != MOTEUR_THREADE || m.p))
+    ret = executer_lot(mt, F, stdout, opt->nb_threads, &opt->limites, 
+                       executer_mot_lot, &m);
+  free_natif(m.n);
+  free_programme(m.p);
+  if(F != stdin) fclose(F);
+  free_mt(mt);
+  return ret;
 }
 
+// Limite d'étapes par défaut de l'énumération des castors affairés
+#define ETAPES_CASTOR_DEFAUT 10000
+
 /**
 * Aide à l'utilisation du programme
 */
 void usage() {
-  fprintf(stderr, "Usage :[1]   ./simulation_mt PATH ALPHABETS SB\n"
+  fprintf(stderr, "Usage :[1]   ./simulation_mt [OPTIONS] PATH ALPHABETS SB\n"
+                  "                 OU\n"
+                  "       [2]  ./simulation_mt [OPTIONS] -C PATH_IN PATH_OUT\n"
+                  "                 OU\n"
+                  "       [3]  ./simulation_mt [OPTIONS] -E N\n"
+                  "                 OU\n"
+                  "       [4]  ./simulation_mt -B PATH_BIN PATH ALPHABETS SB\n"
                   "                 OU\n"
-                  "       [2]  ./simulation_mt -C PATH_IN PATH_OUT\n"
+                  "       [5]  ./simulation_mt [OPTIONS] -D TRACE [DEBUT [FIN]]\n"
+                  "                 OU\n"
+                  "       [6]  ./simulation_mt [OPTIONS] -O PATH_OPT PATH ALPHABETS SB\n"
         "[1] Simule la machine de turing decrit dans PATH\n"
         "[2] Convertit la machine de turing decrit dans PATH_IN, "
-        "travaillant sur l'alphabet d'entree {a,b,c,d}\n"
-        "    en une machine equivalente travaillant sur {0,1}. " 
-        "Execute ensuite la nouvelle machine obtenue\n\n"
+        "travaillant sur les alphabets -a\n"
+        "    (par defaut {a,b,c,d}), en une machine equivalente "
+        "travaillant sur {0,1}. Execute\n"
+        "    ensuite la nouvelle machine obtenue\n"
+        "[3] Enumere les machines a N etats et 2 symboles (castor "
+        "affaire) et affiche les\n"
+        "    champions et les machines qui atteignent la limite "
+        "d'etapes -n (par defaut %ld)\n"
+        "[4] Compile la machine decrite dans PATH au format binaire dans "
+        "PATH_BIN. PATH_BIN\n"
+        "    peut ensuite remplacer PATH en [1] : il est projete en "
+        "memoire, sans analyse\n"
+        "[5] Relit la trace binaire TRACE (cf. -o) et affiche les "
+        "configurations des étapes\n"
+        "    DEBUT à FIN (FIN = DEBUT par défaut ; -t et -w s'appliquent), "
+        "ou seulement la\n"
+        "    configuration finale sans DEBUT\n"
+        "[6] Optimise la machine decrite dans PATH et l'ecrit dans "
+        "PATH_OPT : etats\n"
+        "    inaccessibles et sans issue retires, etats equivalents "
+        "fusionnes, transitions '-'\n"
+        "    composees avec la suivante. Avec -b FICHIER, compare les "
+        "etapes des deux\n"
+        "    machines sur les mots de FICHIER (limite -n, par defaut %ld)"
+        "\n\n"
         "PARAMETRES\n"
         "[1]\n"
         "PATH        Chemin vers le fichier contenant la "
@@ -86,38 +535,403 @@ void usage() {
         "PATH_IN      Chemin du fichier contenant la description de la "
         "machine a convertir\n"
         "PATH_OUT     Fichier ou stocker le code de la machine convertit"
-        "\n\n");
+        "\n\n"
+        "OPTIONS (avant les paramètres)\n"
+        "-q           Mode silencieux : n'affiche que le résultat et le "
+        "nombre d'étapes\n"
+        "-t N         Affiche la configuration toutes les N étapes\n"
+        "-w W         N'affiche que les W cases de part et d'autre de la "
+        "tête de lecture\n"
+        "-n MAX       Arrête l'exécution après MAX étapes (résultat TIMEOUT)\n"
+        "-T S         Arrête l'exécution après S secondes (résultat TIMEOUT)\n"
+        "-c           Détecte les cycles de configurations (résultat BOUCLE, "
+        "avec le début\n"
+        "             et la période du cycle ; moteurs 'table' et 'ntm' "
+        "seulement)\n"
+        "-b FICHIER   Mode lot [1] : exécute la machine sur chaque mot "
+        "de FICHIER (un par ligne,\n"
+        "             '-' pour l'entrée standard) et affiche "
+        "'mot<TAB>RESULTAT<TAB>etapes'\n"
+        "-j N         Nombre de threads du mode lot, de l'énumération et "
+        "du moteur 'ntm' (par\n"
+        "             défaut, le nombre de processeurs)\n"
+        "-m MOTEUR    Moteur d'exécution : 'table' (par défaut, pas à pas), "
+        "'macro' (blocs de K\n"
+        "             cases dont l'effet est mémorisé), 'natif' (code C "
+        "compilé et chargé,\n"
+        "             gardé en cache), 'threade' (code threadé, goto "
+        "calculé), 'comparer'\n"
+        "             (exécute avec 'table' et 'threade' et vérifie que "
+        "les résultats et les\n"
+        "             nombres d'étapes sont identiques), 'bits' (ruban "
+        "compacté, 1 ou 2 bits\n"
+        "             par case, machines d'au plus 4 symboles), 'rle' "
+        "(ruban en plages,\n"
+        "             une boucle sur un état traverse une plage en une "
+        "fois) ou 'ntm' (toutes\n"
+        "             les transitions d'une machine non déterministe, "
+        "branches explorées en\n"
+        "             largeur). Seule la configuration finale\n"
+        "             est affichée par les moteurs autres que 'table'\n"
+        "-k K         Taille des blocs du moteur macro (par défaut 4)\n"
+        "-a ALPHABETS Alphabets de la machine à convertir en [2] (par "
+        "défaut abcd:abcd) ;\n"
+        "             chaque symbole est codé sur ceil(log2 k) bits\n"
+        "-S FICHIER, --sauvegarde FICHIER\n"
+        "             [1] Écrit un instantané de l'exécution dans FICHIER "
+        "toutes les -I secondes,\n"
+        "             sur SIGUSR1 et à la fin ; SIGTERM et SIGINT "
+        "écrivent un instantané et\n"
+        "             arrêtent l'exécution\n"
+        "-I S, --intervalle S\n"
+        "             Secondes entre deux instantanés (par défaut %d)\n"
+        "--resume FICHIER\n"
+        "             [1] Reprend l'exécution enregistrée dans FICHIER "
+        "(même machine, mêmes\n"
+        "             alphabets), sans lire de mot d'entrée ; les "
+        "instantanés suivants sont\n"
+        "             écrits dans FICHIER, sauf avec -S\n"
+        "-p FICHIER   [1] Profile l'exécution (moteur 'table', sans -c) : "
+        "passages par\n"
+        "             transition et par état, positions extrêmes et "
+        "retournements de la tête,\n"
+        "             taille du ruban, écrits en JSON dans FICHIER ('-' "
+        "pour la sortie\n"
+        "             standard) ; les transitions sont réaffichées avec "
+        "leurs passages\n"
+        "-d           [1] Débogueur (moteur 'table') : la machine avance, "
+        "recule ou va à une\n"
+        "             étape donnée sur commande ('h' pour l'aide) ; les "
+        "étapes sont annulées\n"
+        "             avec un journal, sans réexécution depuis le début\n"
+        "--journal N  Nombre d'étapes annulables du débogueur (par défaut "
+        "%ld, 4 octets par\n"
+        "             étape)\n"
+        "--points K   Point de reprise du débogueur toutes les K étapes, "
+        "pour reculer au-delà\n"
+        "             du journal (par défaut, l'état initial seulement)\n"
+        "-o FICHIER, --trace-binaire FICHIER\n"
+        "             [1] Écrit chaque étape (moteur 'table', sans -c) dans "
+        "la trace binaire\n"
+        "             FICHIER, relue par [5] ; l'écriture se fait dans un "
+        "thread dédié\n"
+        "-z           Compresse les blocs de la trace binaire en plages "
+        "d'une même transition\n"
+        "\n", (long) ETAPES_CASTOR_DEFAUT, 
+  (long) ETAPES_COMPARAISON_DEFAUT, INTERVALLE_SAUVEGARDE_DEFAUT, 
+  CAPACITE_JOURNAL_DEFAUT);
+}
+
+/**
+* Recherche le moteur d'exécution nommé sur la ligne de commande
+* @param nom : le nom du moteur
+* @return le moteur (enum moteur), -1 si le nom est inconnu
+*/
+int lire_moteur(char *nom) {
+  for(int i = 0; noms_moteurs[i]; i++) 
+    if(!strcmp(noms_moteurs[i], nom)) return i;
+  fprintf(stderr, "\n[ERR]: Moteur d'exécution '%s' inconnu\n\n", nom);
+  return -1;
+}
+
+/**
+* Lit un entier strictement positif passé en option
+* @param texte : le texte de l'option
+* @param valeur : l'entier lu
+* @return 1 si le texte est un entier strictement positif, 0 sinon
+*/
+int lire_entier(char *texte, long *valeur) {
+  char *fin;
+  *valeur = strtol(texte, &fin, 10);
+  if(*texte == '\0' || *fin != '\0' || *valeur <= 0) {
+    fprintf(stderr, "\n[ERR]: '%s' n'est pas un entier strictement "
+            "positif\n\n", texte);
+    return 0;
+  }
+  return 1;
 }
 
 int main(int argc, char *argv[]) {
-  if(argc != 4) {
+  char *fichier_binaire = NULL;
+  // Alphabets par défaut de la machine à convertir
+  char alphabets_latin[] = "abcd:abcd";
+  char *alphabets_conversion = alphabets_latin;
+  int conversion = 0, niveau = TRACE_COMPLETE, opt;
+  long periode = 1, fenetre = 0, nb_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  long taille_bloc = 4, nb_etats = 0;
+  struct options_s o = { NULL, NULL, 1, { 0, 0, 0 }, MOTEUR_TABLE, 4, 
+                         NULL, INTERVALLE_SAUVEGARDE_DEFAUT, NULL, NULL,
+                         0, CAPACITE_JOURNAL_DEFAUT, 0, NULL, 0 };
+  char *fichier_decodage = NULL, *fichier_optimise = NULL;
+  char *fin;
+  // Options longues : la reprise et les réglages du débogueur n'ont pas
+  // d'option courte
+  struct option options_longues[] = {
+    { "sauvegarde", required_argument, NULL, 'S' },
+    { "intervalle", required_argument, NULL, 'I' },
+    { "resume", required_argument, NULL, 'R' },
+    { "journal", required_argument, NULL, 'L' },
+    { "points", required_argument, NULL, 'P' },
+    { "trace-binaire", required_argument, NULL, 'o' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  // Lecture des options, qui doivent précéder les paramètres
+  while((opt = getopt_long(argc, argv, "+Cqt:w:n:T:cb:j:m:k:E:B:a:S:I:p:do:zD:O:", 
+                           options_longues, NULL)) != -1) {
+    switch(opt) {
+      case 'C': 
+        conversion = 1; 
+        break;
+      case 'q': 
+        niveau = TRACE_SILENCIEUSE; 
+        break;
+      case 't': 
+        niveau = TRACE_PERIODIQUE;
+        if(!lire_entier(optarg, &periode)) return 1;
+        break;
+      case 'w': 
+        if(!lire_entier(optarg, &fenetre)) return 1;
+        break;
+      case 'n': 
+        if(!lire_entier(optarg, &o.limites.max_etapes)) return 1;
+        break;
+      case 'T': 
+        o.limites.max_secondes = strtod(optarg, &fin);
+        if(*fin != '\0' || o.limites.max_secondes <= 0) {
+          fprintf(stderr, "\n[ERR]: '%s' n'est pas une durée valide\n\n",
+                  optarg);
+          return 1;
+        }
+        break;
+      case 'c': 
+        o.limites.cycles = 1;
+        break;
+      case 'b': 
+        o.fichier_lot = optarg;
+        break;
+      case 'B': 
+        fichier_binaire = optarg;
+        break;
+      case 'a': 
+        alphabets_conversion = optarg;
+        break;
+      case 'j': 
+        if(!lire_entier(optarg, &nb_threads)) return 1;
+        break;
+      case 'm': 
+        if((o.moteur = lire_moteur(optarg)) < 0) return 1;
+        break;
+      case 'k': 
+        if(!lire_entier(optarg, &taille_bloc)) return 1;
+        break;
+      case 'E': 
+        if(!lire_entier(optarg, &nb_etats)) return 1;
+        break;
+      case 'S': 
+        o.sauvegarde = optarg;
+        break;
+      case 'I': 
+        o.intervalle = strtod(optarg, &fin);
+        if(*fin != '\0' || o.intervalle <= 0) {
+          fprintf(stderr, "\n[ERR]: '%s' n'est pas une durée valide\n\n",
+                  optarg);
+          return 1;
+        }
+        break;
+      case 'R': 
+        o.reprise = optarg;
+        break;
+      case 'p': 
+        o.fichier_profil = optarg;
+        break;
+      case 'd': 
+        o.debogueur = 1;
+        break;
+      case 'L': 
+        if(!lire_entier(optarg, &o.capacite_journal)) return 1;
+        break;
+      case 'P': 
+        if(!lire_entier(optarg, &o.intervalle_points)) return 1;
+        break;
+      case 'o': 
+        o.trace_binaire = optarg;
+        break;
+      case 'z': 
+        o.compresser = 1;
+        break;
+      case 'D': 
+        fichier_decodage = optarg;
+        break;
+      case 'O': 
+        fichier_optimise = optarg;
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  o.nb_threads = nb_threads > 0 ? nb_threads : 1;
+  o.taille_bloc = taille_bloc;
+  // La reprise continue à sauvegarder dans l'instantané repris
+  if(o.reprise && !o.sauvegarde) o.sauvegarde = o.reprise;
+  // Le moteur 'ntm' détecte toujours les configurations répétées
+  if(o.limites.cycles && o.moteur != MOTEUR_TABLE && o.moteur != MOTEUR_NTM) {
+    fprintf(stderr, "\n[ERR]: La détection des cycles n'est possible "
+            "qu'avec les moteurs 'table'\n       et 'ntm'\n\n");
+    return 1;
+  }
+  if(o.sauvegarde && (o.moteur != MOTEUR_TABLE || o.limites.cycles 
+                      || conversion || o.fichier_lot || nb_etats 
+                      || fichier_binaire)) {
+    fprintf(stderr, "\n[ERR]: La sauvegarde et la reprise ne sont "
+            "possibles qu'en mode [1], avec le\n       moteur 'table' et "
+            "sans détection des cycles\n\n");
+    return 1;
+  }
+  if(o.fichier_profil && (o.moteur != MOTEUR_TABLE || o.limites.cycles 
+                          || o.sauvegarde || o.fichier_lot || nb_etats 
+                          || fichier_binaire)) {
+    fprintf(stderr, "\n[ERR]: Le profil n'est possible qu'en mode [1], "
+            "avec le moteur 'table',\n       sans détection des cycles "
+            "ni sauvegarde\n\n");
+    return 1;
+  }
+  if(o.debogueur && (o.moteur != MOTEUR_TABLE || o.limites.cycles 
+                     || o.sauvegarde || o.fichier_profil || o.fichier_lot 
+                     || nb_etats || fichier_binaire)) {
+    fprintf(stderr, "\n[ERR]: Le débogueur n'est possible qu'en mode [1], "
+            "avec le moteur 'table',\n       sans détection des cycles, "
+            "sauvegarde ni profil\n\n");
+    return 1;
+  }
+  if(o.trace_binaire && (o.moteur != MOTEUR_TABLE || o.limites.cycles 
+                         || o.sauvegarde || o.fichier_profil || o.debogueur
+                         || o.fichier_lot || nb_etats || fichier_binaire
+                         || fichier_decodage)) {
+    fprintf(stderr, "\n[ERR]: La trace binaire n'est possible qu'en mode "
+            "[1], avec le moteur\n       'table', sans détection des "
+            "cycles, sauvegarde, profil ni débogueur\n\n");
+    return 1;
+  }
+
+  // Décodage d'une trace binaire : les étapes à afficher sont optionnelles
+  if(fichier_decodage) {
+    long debut = -1, fin_decodage;
+    if(argc - optind > 2 || conversion || o.fichier_lot || nb_etats 
+       || fichier_binaire || o.sauvegarde || o.fichier_profil 
+       || o.debogueur) {
+      usage();
+      return 1;
+    }
+    if(argc - optind >= 1) {
+      debut = strtol(argv[optind], &fin, 10);
+      if(*argv[optind] == '\0' || *fin != '\0' || debut < 0) {
+        fprintf(stderr, "\n[ERR]: '%s' n'est pas une étape valide\n\n",
+                argv[optind]);
+        return 1;
+      }
+    }
+    fin_decodage = debut;
+    if(argc - optind == 2) {
+      fin_decodage = strtol(argv[optind + 1], &fin, 10);
+      if(*argv[optind + 1] == '\0' || *fin != '\0' 
+         || fin_decodage < debut) {
+        fprintf(stderr, "\n[ERR]: '%s' n'est pas une étape valide\n\n",
+                argv[optind + 1]);
+        return 1;
+      }
+    }
+    // Sans -t, toutes les étapes demandées sont affichées
+    trace t = init_trace(niveau == TRACE_SILENCIEUSE ? TRACE_COMPLETE 
+                         : niveau, periode, fenetre);
+    if(!t) return 1;
+    int ok = decoder_trace_binaire(fichier_decodage, t, debut, 
+                                   fin_decodage);
+    free_trace(t);
+    return !ok;
+  }
+
+  // Énumération des castors affairés : aucun paramètre
+  if(nb_etats) {
+    if(argc != optind || conversion || o.fichier_lot) {
+      usage();
+      return 1;
+    }
+    return enumerer_castors(nb_etats, o.limites.max_etapes > 0 ? 
+                            o.limites.max_etapes : ETAPES_CASTOR_DEFAUT, 
+                            o.nb_threads, stdout);
+  }
+
+  if(argc - optind != 3 - conversion || (conversion && o.fichier_lot)) {
     usage();
     return 1;
   }
+  argv += optind - 1;
+
+  // Compilation au format binaire
+  if(fichier_binaire) {
+    if(conversion || o.fichier_lot) {
+      usage();
+      return 1;
+    }
+    return compiler_binaire(argv[1], argv[2], argv[3][0], fichier_binaire);
+  }
+
+  // Optimisation : les mots du mode lot servent à la comparaison
+  if(fichier_optimise) {
+    if(conversion || o.sauvegarde || o.fichier_profil || o.debogueur 
+       || o.trace_binaire) {
+      usage();
+      return 1;
+    }
+    return optimiser(argv[1], argv[2], argv[3][0], fichier_optimise, &o);
+  }
+
+  // Mode lot : aucune trace, seuls les résultats sont affichés
+  if(o.fichier_lot) return simuler_lot(argv[1], argv[2], argv[3][0], &o);
+
+  trace t = init_trace(niveau, periode, fenetre);
+  if(!t) return 1;
+  o.t = t;
 
   // Si option -C spécifié
-  if(!strcmp(argv[1], "-C")) {
-    MT mt_latin = machine_latin_vers_binaire(argv[2], 
-                  argv[3]);
-    if(!mt_latin) return 1;
+  if(conversion) {
+    // Copie des alphabets, modifiés par la conversion
+    char *alphabets_latin_mt = strdup(alphabets_conversion);
+    MT mt_latin = alphabets_latin_mt ? 
+      machine_latin_vers_binaire(argv[1], argv[2], alphabets_latin_mt) : NULL;
+    codage code = mt_latin ? init_codage(mt_latin) : NULL;
+    if(!code) {
+      if(mt_latin) free_mt(mt_latin);
+      free(alphabets_latin_mt);
+      free_trace(t);
+      return 1;
+    }
 
     printf("\n========================================================================\n");
-    printf("\nConversion de la machine de l'alphabet {a,b,c,d} vers {0,1} avec succès\n"
-           "Code de la nouvelle machine dans %s\n", argv[3]);
+    printf("\nConversion de la machine de l'alphabet {%s} vers {0,1} avec "
+           "succès (%d bits par symbole)\n"
+           "Code de la nouvelle machine dans %s\n", 
+           mt_latin->alphabet_travail, code->largeur, argv[2]);
 
     char alphabets[] = "01:01";
     printf("\n>>> SIMULATION DE LA MACHINE '%s'\n" 
-           ">>> ALPHABET abcd:abcd\n", argv[3]);
+           ">>> ALPHABET %s:%s\n", argv[2], mt_latin->alphabet_entree,
+           mt_latin->alphabet_travail);
 
     char *mot_entree = readline("\nMot d'entrée > ");
 
     // Converti le mot d'entree en binaire (en utilisant le codage)
-    // code(a)=00, code(b)=01, code(c)=10, code(d)=11
-    char *mot_bin = coder_mot(mot_entree);
+    char *mot_bin = mot_entree ? coder_mot(code, mot_entree) : NULL;
     if(!mot_bin) {
       fprintf(stderr, "Le mot d'entree n'est pas correct. Il doit être "
-              "dans l'alphabet abcd\n");
-      free(mt_latin);
+              "dans l'alphabet %s\n", mt_latin->alphabet_entree);
+      free(mot_entree);
+      free_codage(code);
+      free_mt(mt_latin);
+      free(alphabets_latin_mt);
+      free_trace(t);
       return 1;
     }
 
@@ -125,10 +939,15 @@ int main(int argc, char *argv[]) {
            "Simulation de la machine sur %s\n",
            mot_entree, mot_bin, mot_bin);
 
-    int ret = simuler_machine(argv[3], alphabets, 
-                              mt_latin->symbole_blanc, mot_bin);
+    int ret = simuler_machine(argv[2], alphabets, 
+                              mt_latin->symbole_blanc, mot_bin, &o);
 
+    free(mot_bin);
+    free(mot_entree);
+    free_codage(code);
     free_mt(mt_latin);
+    free(alphabets_latin_mt);
+    free_trace(t);
 
     return ret;
   }
@@ -138,8 +957,17 @@ int main(int argc, char *argv[]) {
   printf("\n>>> SIMULATION DE LA MACHINE '%s'\n" 
           ">>> ALPHABET %s\n", argv[1], argv[2]);
 
-  char *mot_entree = readline("\nMot d'entrée > ");
+  // En reprise, le ruban est celui de l'instantané
+  char *mot_entree = o.reprise ? strdup("") : readline("\nMot d'entrée > ");
+  if(!mot_entree) {
+    fprintf(stderr, "\n[ERR]: Aucun mot d'entrée lu\n\n");
+    free_trace(t);
+    return 1;
+  }
 
-  return simuler_machine(argv[1], argv[2], argv[3][0], mot_entree);
+  int ret = simuler_machine(argv[1], argv[2], argv[3][0], mot_entree, &o);
+  free(mot_entree);
+  free_trace(t);
+  return ret;
 
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "hachage.h"
+#include "multiruban.h"
+
+/**
+* Supprime les espaces au début et à la fin d'une chaine (modifiée)
+*/
+static char* trim(char *s) {
+  while(isspace((unsigned char) *s)) s++;
+  char *fin = s + strlen(s);
+  while(fin > s && isspace((unsigned char) fin[-1])) fin--;
+  *fin = '\0';
+  return s;
+}
+
+int est_machine_multiruban(const char *path) {
+  FILE *F = fopen(path, "r");
+  if(!F) return 0;
+  char *ligne = NULL;
+  size_t taille = 0;
+  int res = 0;
+  while(getline(&ligne, &taille, F) != -1) {
+    char *l = trim(ligne);
+    if(*l == '\0') continue;
+    res = !strncmp(l, "rubans", 6);
+    break;
+  }
+  free(ligne);
+  fclose(F);
+  return res;
+}
+
+/**
+* Hache la clé (etat, symboles lus) d'une transition
+*/
+static uint64_t hacher_cle(int etat, const unsigned char *lus, int k) {
+  uint64_t h = hachage_fnv1a(FNV1A_BASE, &etat, sizeof(etat));
+  return hachage_melanger(hachage_fnv1a(h, lus, k));
+}
+
+long multi_chercher(MT_multi mt, int etat, const unsigned char *lus) {
+  long masque = mt->taille_index - 1;
+  long i = (long) (hacher_cle(etat, lus, mt->nb_rubans) & masque);
+  for(; mt->index[i] >= 0; i = (i + 1) & masque) {
+    transition_multi tr = &mt->transitions[mt->index[i]];
+    if(tr->etat == etat && !memcmp(tr->lus, lus, mt->nb_rubans))
+      return mt->index[i];
+  }
+  return -1;
+}
+
+/**
+* Construit l'index (etat, symboles lus) -> première transition
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int indexer_transitions(MT_multi mt) {
+  mt->taille_index = 16;
+  while(mt->taille_index < 2 * mt->nb_transitions) mt->taille_index *= 2;
+  mt->index = (int32_t*) malloc(sizeof(int32_t) * mt->taille_index);
+  if(!mt->index) return 0;
+  memset(mt->index, -1, sizeof(int32_t) * mt->taille_index);
+  long masque = mt->taille_index - 1;
+  for(long t = 0; t < mt->nb_transitions; t++) {
+    transition_multi tr = &mt->transitions[t];
+    long i = (long) (hacher_cle(tr->etat, tr->lus, mt->nb_rubans) & masque);
+    while(mt->index[i] >= 0
+          && (mt->transitions[mt->index[i]].etat != tr->etat
+              || memcmp(mt->transitions[mt->index[i]].lus, tr->lus,
+                        mt->nb_rubans)))
+      i = (i + 1) & masque;
+    // Seule la première transition déclarée est appliquée
+    if(mt->index[i] >= 0) mt->nb_conflits++;
+    else mt->index[i] = (int32_t) t;
+  }
+  if(mt->nb_conflits)
+    fprintf(stderr, "[ATTENTION]: %ld transitions pour des couples "
+            "(etat, symboles lus) déjà définis : seule la première "
+            "déclarée est appliquée\n", mt->nb_conflits);
+  return 1;
+}
+
+/**
+* Affiche une erreur de syntaxe d'une ligne de transition
+*/
+static void erreur_transition(MT_multi mt, long n, const char *ligne,
+                              const char *precision) {
+  fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine :\n"
+          "Ligne %ld : %s\n"
+          "Une transition à %d rubans doit être du format etat,lu_1,...,"
+          "lu_%d,nouvel_etat,ecrit_1,...,ecrit_%d,mouvement_1,...,"
+          "mouvement_%d\n%s\n\n", n, ligne, mt->nb_rubans, mt->nb_rubans,
+          mt->nb_rubans, mt->nb_rubans, precision);
+}
+
+/**
+* Analyse les champs d'une ligne de transition (cf. 
+* lire_transition_multi())
+* @param copie : copie de la ligne, pour les messages d'erreur
+*/
+static int analyser_transition_multi(MT_multi mt, char *ligne, 
+                                     const char *copie, long n, 
+                                     long *capacite) {
+  int k = mt->nb_rubans, nb_champs = 2 + 3 * k;
+  char *champs[2 + 3 * MAX_RUBANS];
+  char sb = mt->symbole_blanc;
+
+  // Les champs vides sont ignorés ; un champ égal au symbole blanc est
+  // gardé tel quel (symbole blanc espace)
+  int nb = 0;
+  char *p = ligne;
+  while(*p) {
+    char *fin = strchr(p, ',');
+    if(fin) *fin = '\0';
+    if(*p) {
+      if(nb == nb_champs) nb++;
+      else champs[nb++] = (p[0] == sb && p[1] == '\0') ? p : trim(p);
+    }
+    if(!fin || nb > nb_champs) break;
+    p = fin + 1;
+  }
+  if(nb != nb_champs) {
+    erreur_transition(mt, n, copie, "Nombre de champs incorrect.");
+    return 0;
+  }
+
+  if(mt->nb_transitions == *capacite) {
+    *capacite = *capacite ? *capacite * 2 : 64;
+    transition_multi t = (transition_multi) realloc(mt->transitions,
+                          sizeof(struct transition_multi_s) * *capacite);
+    if(!t) {
+      perror("Erreur d'allocation lors de la lecture de la machine.\n");
+      return 0;
+    }
+    mt->transitions = t;
+  }
+  transition_multi tr = &mt->transitions[mt->nb_transitions];
+  memset(tr, 0, sizeof(*tr));
+  for(int i = 0; i < 2 * k + 1; i++) {
+    if(i == k) continue;
+    char *c = champs[i + 1];
+    if(strlen(c) != 1 || (c[0] != sb && !strchr(mt->alphabet_entree, c[0])
+                          && !strchr(mt->alphabet_travail, c[0]))) {
+      char precision[256];
+      snprintf(precision, sizeof(precision), "Le symbole '%s' n'est pas "
+               "valide. Il doit être un caractère des alphabets '%s:%s'",
+               c, mt->alphabet_entree, mt->alphabet_travail);
+      erreur_transition(mt, n, copie, precision);
+      return 0;
+    }
+    if(i < k) tr->lus[i] = (unsigned char) c[0];
+    else tr->ecrits[i - k - 1] = (unsigned char) c[0];
+  }
+  for(int i = 0; i < k; i++) {
+    char *c = champs[2 + 2 * k + i];
+    if(strlen(c) != 1 || (c[0] != DROITE && c[0] != GAUCHE
+                          && c[0] != AUCUN)) {
+      erreur_transition(mt, n, copie, "Les mouvements possibles sont : "
+                        "'<' , '>' et '-'");
+      return 0;
+    }
+    tr->deplacements[i] = c[0] == DROITE ? 1 : c[0] == GAUCHE ? -1 : 0;
+  }
+  if(!*champs[0] || !*champs[k + 1]) {
+    erreur_transition(mt, n, copie, "Un état doit être une chaîne "
+                      "caractères non vide.");
+    return 0;
+  }
+  tr->etat = dictionnaire_ajouter(mt->noms, champs[0], strlen(champs[0]));
+  tr->nouvel_etat = dictionnaire_ajouter(mt->noms, champs[k + 1],
+                                         strlen(champs[k + 1]));
+  if(tr->etat < 0 || tr->nouvel_etat < 0) {
+    perror("Erreur d'allocation lors de la lecture de la machine.\n");
+    return 0;
+  }
+  mt->nb_transitions++;
+  return 1;
+}
+
+/**
+* Analyse une ligne de transition et l'ajoute aux transitions de la
+* machine
+* @param mt : la machine
+* @param ligne : la ligne (modifiée)
+* @param n : le numéro de la ligne
+* @param capacite : le nombre de transitions allouées, mis à jour
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int lire_transition_multi(MT_multi mt, char *ligne, long n,
+                                 long *capacite) {
+  // Copie de la ligne pour les messages d'erreur
+  char *copie = strdup(ligne);
+  if(!copie) {
+    perror("Erreur d'allocation lors de la lecture de la machine.\n");
+    return 0;
+  }
+  int ok = analyser_transition_multi(mt, ligne, copie, n, capacite);
+  free(copie);
+  return ok;
+}
+
+/**
+* Analyse une déclaration 'mot_cle: valeur'
+* @return la valeur (sans espaces), NULL si la ligne n'est pas de cette
+*         forme
+*/
+static char* lire_declaration(char *ligne, const char *mot_cle) {
+  char *separateur = strchr(ligne, ':');
+  if(!separateur) return NULL;
+  *separateur = '\0';
+  if(strcmp(trim(ligne), mot_cle)) return NULL;
+  char *valeur = trim(separateur + 1);
+  return *valeur ? valeur : NULL;
+}
+
+MT_multi init_machine_multiruban(char *path, char *alphabets,
+                                 char symbole_blanc) {
+  char *separateur = strchr(alphabets, ':');
+  if(!separateur || separateur == alphabets || !separateur[1]
+     || strchr(separateur + 1, ':')) {
+    fprintf(stderr, "\n[ERR]: Alphabets de la machine incorrect, "
+     "l'entrée doit être de la forme : "
+     "'alphabet_entree:alphabet_travail'\n\n");
+    return NULL;
+  }
+  FILE *F = fopen(path, "r");
+  if(!F) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", path);
+    perror("\n\n");
+    return NULL;
+  }
+  MT_multi mt = (MT_multi) calloc(1, sizeof(struct MT_multi_s));
+  if(!mt || !(mt->noms = init_dictionnaire())) {
+    perror("Erreur d'allocation de la mémoire de la machine.\n");
+    free(mt);
+    fclose(F);
+    return NULL;
+  }
+  *separateur = '\0';
+  mt->alphabet_entree = alphabets;
+  mt->alphabet_travail = separateur + 1;
+  mt->symbole_blanc = symbole_blanc;
+  mt->etat_in = mt->etat_fin = -1;
+
+  char *ligne = NULL, *valeur;
+  size_t taille = 0;
+  long n = 0, capacite = 0;
+  int ok = 1;
+  while(ok && getline(&ligne, &taille, F) != -1) {
+    n++;
+    char *l = trim(ligne);
+    if(*l == '\0') continue;
+    if(!mt->nb_rubans) {
+      // La première ligne déclare le nombre de rubans
+      valeur = lire_declaration(l, "rubans");
+      mt->nb_rubans = valeur ? atoi(valeur) : 0;
+      if(mt->nb_rubans < 1 || mt->nb_rubans > MAX_RUBANS) {
+        fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine, "
+                "ligne %ld : 'rubans: k' est attendu, avec k entre 1 et "
+                "%d\n\n", n, MAX_RUBANS);
+        ok = 0;
+      }
+    } else if(!strncmp(l, "init", 4) || !strncmp(l, "accept", 6)) {
+      int init = l[0] == 'i';
+      if(!(valeur = lire_declaration(l, init ? "init" : "accept"))) {
+        fprintf(stderr, "\n[ERR]: Erreur dans le code de la machine, "
+                "ligne %ld : un état est attendu après %s\n\n", n,
+                init ? "init" : "accept");
+        ok = 0;
+        break;
+      }
+      int32_t id = dictionnaire_ajouter(mt->noms, valeur, strlen(valeur));
+      if(id < 0) {
+        perror("Erreur d'allocation lors de la lecture de la machine.\n");
+        ok = 0;
+      }
+      if(init) mt->etat_in = id;
+      else mt->etat_fin = id;
+    } else {
+      ok = lire_transition_multi(mt, l, n, &capacite);
+    }
+  }
+  free(ligne);
+  fclose(F);
+
+  if(ok && (mt->etat_in < 0 || mt->etat_fin < 0)) {
+    fprintf(stderr, "\n[ERR]: Les états initial (init) et final (accept) "
+            "de la machine doivent être déclarés\n\n");
+    ok = 0;
+  }
+  if(!ok || !indexer_transitions(mt)) {
+    if(ok) perror("Erreur d'allocation de la mémoire de la machine.\n");
+    free_mt_multi(mt);
+    return NULL;
+  }
+  return mt;
+}
+
+configuration_multi init_configuration_multi(MT_multi mt, char *mot) {
+  configuration_multi c = (configuration_multi) calloc(1,
+                                 sizeof(struct configuration_multi_s));
+  if(!c) {
+    perror("Erreur d'allocation de la configuration.\n");
+    return NULL;
+  }
+  c->mt = mt;
+  c->etat_courant = mt->etat_in;
+  for(int i = 0; i < mt->nb_rubans; i++) {
+    // Le mot d'entrée est écrit sur le premier ruban
+    for(char *s = mot; i == 0 && *s; s++) {
+      if(!strchr(mt->alphabet_entree, *s)) {
+        fprintf(stderr, "\n[ERR]: Le symbole '%c' du mot d'entrée n'est "
+                "pas dans l'alphabet d'entrée '%s'\n\n", *s,
+                mt->alphabet_entree);
+        free_configuration_multi(c);
+        return NULL;
+      }
+    }
+    c->rubans[i] = init_ruban(i == 0 ? mot : "", mt->symbole_blanc);
+    if(!c->rubans[i]) {
+      free_configuration_multi(c);
+      return NULL;
+    }
+  }
+  return c;
+}
+
+void afficher_configuration_multi(configuration_multi c, trace t) {
+  const char *nom = c->mt->noms->chaines[c->etat_courant];
+  char *etiquette = (char*) malloc(strlen(nom) + 32);
+  if(!etiquette) {
+    perror("Erreur d'allocation de la trace.\n");
+    return;
+  }
+  for(int i = 0; i < c->mt->nb_rubans; i++) {
+    sprintf(etiquette, "%s (ruban %d)", nom, i + 1);
+    trace_afficher(t, etiquette, c->rubans[i], c->tetes[i], c->nb_etapes);
+  }
+  free(etiquette);
+}
+
+int executer_multi(configuration_multi c, trace t, limites l) {
+  MT_multi mt = c->mt;
+  int k = mt->nb_rubans, etat = c->etat_courant;
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  long n = c->nb_etapes;
+  double debut = horloge_secondes();
+  int affichage = t && t->niveau != TRACE_SILENCIEUSE;
+  int arret = 0, delai = 0;
+  unsigned char lus[MAX_RUBANS];
+
+  if(affichage) afficher_configuration_multi(c, t);
+  while(etat != mt->etat_fin && n < limite) {
+    if(n % TRANCHE_ETAPES == 0 && n > c->nb_etapes
+       && (delai = delai_depasse(l, debut)))
+      break;
+    for(int i = 0; i < k; i++) lus[i] = *ruban_case(c->rubans[i],
+                                                    c->tetes[i]);
+    long j = multi_chercher(mt, etat, lus);
+    if(j < 0) {
+      arret = 1;
+      break;
+    }
+    transition_multi tr = &mt->transitions[j];
+    etat = tr->nouvel_etat;
+    n++;
+    for(int i = 0; i < k; i++) {
+      *ruban_case(c->rubans[i], c->tetes[i]) = tr->ecrits[i];
+      if(!ruban_deplacer(c->rubans[i], &c->tetes[i], tr->deplacements[i]))
+        arret = 1;
+    }
+    if(arret) break;
+    if(affichage && trace_a_afficher(t, n)) {
+      c->etat_courant = etat;
+      c->nb_etapes = n;
+      afficher_configuration_multi(c, t);
+    }
+  }
+  c->etat_courant = etat;
+  c->nb_etapes = n;
+  // En mode périodique, la configuration finale est toujours affichée
+  if(affichage && !trace_a_afficher(t, n)) afficher_configuration_multi(c, t);
+
+  if(etat == mt->etat_fin) return RESULTAT_ACCEPTE;
+  if(arret || !(delai || n >= limite)) return RESULTAT_REFUSE;
+  // La machine n'est limitée que si elle pouvait encore avancer
+  for(int i = 0; i < k; i++) lus[i] = *ruban_case(c->rubans[i],
+                                                  c->tetes[i]);
+  return multi_chercher(mt, etat, lus) >= 0 ? RESULTAT_TIMEOUT
+                                            : RESULTAT_REFUSE;
+}
+
+void free_configuration_multi(configuration_multi c) {
+  if(!c) return;
+  for(int i = 0; i < MAX_RUBANS; i++) free_ruban(c->rubans[i]);
+  free(c);
+}
+
+void free_mt_multi(MT_multi mt) {
+  if(!mt) return;
+  free(mt->transitions);
+  free(mt->index);
+  free_dictionnaire(mt->noms);
+  free(mt);
+}
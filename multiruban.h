@@ -0,0 +1,144 @@
+#ifndef _multiruban_h_
+#define _multiruban_h_
+
+#include "machineturing.h"
+
+/**
+* Nombre maximal de rubans d'une machine
+*/
+#define MAX_RUBANS 8
+
+/**
+* Structure de données représentant une transition d'une machine à k
+* rubans, dont les états sont remplacés par leurs identifiants (dans
+* les noms de la machine).
+* etat -> l'état de départ
+* nouvel_etat -> le nouvel état
+* lus -> les k symboles lus, un par ruban
+* ecrits -> les k symboles à écrire
+* deplacements -> les k déplacements des têtes (+1, -1 ou 0)
+*/
+struct transition_multi_s {
+  int32_t etat;
+  int32_t nouvel_etat;
+  unsigned char lus[MAX_RUBANS];
+  unsigned char ecrits[MAX_RUBANS];
+  signed char deplacements[MAX_RUBANS];
+};
+typedef struct transition_multi_s* transition_multi;
+
+/**
+* Structure de données permettant de stocker une machine de turing à
+* plusieurs rubans. Le mot d'entrée est écrit sur le premier ruban, les
+* autres rubans sont blancs au départ.
+* nb_rubans -> le nombre k de rubans
+* alphabet_entree / alphabet_travail / symbole_blanc -> comme pour MT
+* noms -> les noms des états
+* etat_in / etat_fin -> les identifiants des états initial et final
+* transitions / nb_transitions -> les transitions, dans l'ordre du
+*                                 fichier
+* index -> table de hachage (etat, symboles lus) -> indice de la
+*          première transition déclarée, -1 pour une case vide
+* taille_index -> le nombre de cases de l'index (puissance de 2)
+* nb_conflits -> le nombre de couples (etat, symboles lus) ayant
+*                plusieurs transitions
+*/
+struct MT_multi_s {
+  int nb_rubans;
+  char *alphabet_entree;
+  char *alphabet_travail;
+  char symbole_blanc;
+  dictionnaire noms;
+  int32_t etat_in;
+  int32_t etat_fin;
+  struct transition_multi_s *transitions;
+  long nb_transitions;
+  int32_t *index;
+  long taille_index;
+  long nb_conflits;
+};
+typedef struct MT_multi_s* MT_multi;
+
+/**
+* Configuration d'une machine à plusieurs rubans
+* mt -> la machine
+* etat_courant -> l'identifiant de l'état courant
+* rubans -> les k rubans
+* tetes -> les positions des k têtes de lecture
+* nb_etapes -> le nombre d'étapes effectuées
+*/
+struct configuration_multi_s {
+  MT_multi mt;
+  int etat_courant;
+  ruban rubans[MAX_RUBANS];
+  long tetes[MAX_RUBANS];
+  long nb_etapes;
+};
+typedef struct configuration_multi_s* configuration_multi;
+
+/**
+* Indique si un fichier décrit une machine à plusieurs rubans, i.e. si
+* sa première ligne non vide est 'rubans: k'
+* @param path : chemin vers le fichier
+* @return 1 si le fichier décrit une machine à plusieurs rubans, 0 sinon
+*/
+int est_machine_multiruban(const char *path);
+
+/**
+* Lit la description d'une machine à k rubans. Le format est celui
+* d'une machine à un ruban (cf. init_machine_turing()) précédé de la
+* ligne 'rubans: k', chaque transition portant k symboles lus, k
+* symboles écrits et k mouvements :
+* etat,lu_1,...,lu_k,nouvel_etat,ecrit_1,...,ecrit_k,mvt_1,...,mvt_k
+* @param path : chemin vers le fichier de description
+* @param alphabets : les alphabets de la machine, au format
+*                    alphabet_entree:alphabet_travail (modifié)
+* @param symbole_blanc : le symbole blanc des rubans
+* @return la machine, NULL en cas d'erreur
+*/
+MT_multi init_machine_multiruban(char *path, char *alphabets,
+                                 char symbole_blanc);
+
+/**
+* Recherche la transition à appliquer dans un état pour les symboles
+* lus sur les k rubans
+* @return l'indice de la transition, -1 s'il n'y en a pas
+*/
+long multi_chercher(MT_multi mt, int etat, const unsigned char *lus);
+
+/**
+* Initialise la configuration initiale d'une machine à plusieurs rubans
+* sur un mot, écrit sur le premier ruban
+* @return la configuration, NULL en cas d'erreur
+*/
+configuration_multi init_configuration_multi(MT_multi mt, char *mot);
+
+/**
+* Exécute une machine à plusieurs rubans jusqu'à son arrêt ou jusqu'à
+* une limite, en affichant les configurations selon la trace (chaque
+* ruban avec sa tête de lecture)
+* @param c : la configuration de départ, mise à jour
+* @param t : la trace d'exécution
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite), NULL pour ne pas limiter
+* @return le résultat de l'exécution (enum resultat)
+*/
+int executer_multi(configuration_multi c, trace t, limites l);
+
+/**
+* Affiche la configuration d'une machine à plusieurs rubans
+*/
+void afficher_configuration_multi(configuration_multi c, trace t);
+
+/**
+* Libère l'espace mémoire alloué pour une configuration
+*/
+void free_configuration_multi(configuration_multi c);
+
+/**
+* Libère l'espace mémoire alloué pour une machine à plusieurs rubans
+*/
+void free_mt_multi(MT_multi mt);
+
+
+#endif
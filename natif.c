@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "hachage.h"
+#include "natif.h"
+
+// Nom de la fonction générée dans la bibliothèque
+#define SYMBOLE_NATIF "mt_executer"
+
+/**
+* Écrit l'en-tête du code généré. La structure du ruban doit être 
+* identique à celle de ruban.h : sa taille est vérifiée au chargement.
+*/
+static void generer_entete(FILE *f) {
+  fprintf(f, 
+    "/* Code généré par simulation_mt (version %d) */\n"
+    "typedef unsigned char cellule;\n"
+    "struct ruban_s {\n"
+    "  cellule *cases;\n"
+    "  long capacite;\n"
+    "  long origine;\n"
+    "  long min;\n"
+    "  long max;\n"
+    "  cellule symbole_blanc;\n"
+    "};\n"
+    "const unsigned long mt_taille_ruban = sizeof(struct ruban_s);\n\n"
+    "#define DROITE(e) if(++p > r->max) { \\\n"
+    "    if(p + r->origine >= r->capacite && !etendre(r, p)) \\\n"
+    "      { p--; etat = e; goto arret; } \\\n"
+    "    r->max = p; }\n"
+    "#define GAUCHE(e) if(--p < r->min) { \\\n"
+    "    if(p + r->origine < 0 && !etendre(r, p)) \\\n"
+    "      { p++; etat = e; goto arret; } \\\n"
+    "    r->min = p; }\n\n"
+    "int " SYMBOLE_NATIF "(struct ruban_s *r, int *etat_, long *tete, "
+    "long *etapes,\n"
+    "                long fin_tranche, "
+    "int (*etendre)(struct ruban_s*, long)) {\n"
+    "  int etat = *etat_, arret = 1;\n"
+    "  long p = *tete, n = *etapes;\n"
+    "  cellule *c;\n", VERSION_NATIF);
+}
+
+/**
+* Génère le code C d'une machine
+* @param t : la table des transitions de la machine
+* @param f : le fichier où écrire le code
+*/
+static void generer_code(table_transitions t, FILE *f) {
+  generer_entete(f);
+  fprintf(f, "  switch(etat) {\n");
+  for(int e = 0; e < t->nb_etats; e++) 
+    fprintf(f, "    case %d: goto E%d;\n", e, e);
+  fprintf(f, "    default: goto arret;\n  }\n");
+
+  // Les noms des états, lus dans le fichier de la machine, ne sont pas
+  // recopiés dans le code : seul leur identifiant l'est
+  for(int e = 0; e < t->nb_etats; e++) {
+    fprintf(f, "E%d:\n", e);
+    // L'état final arrête la machine avant toute lecture
+    if(e == t->etat_fin) {
+      fprintf(f, "  etat = %d;\n  goto arret;\n", e);
+      continue;
+    }
+    fprintf(f, "  if(n >= fin_tranche) { etat = %d; arret = 0; "
+            "goto arret; }\n"
+            "  c = r->cases + r->origine + p;\n"
+            "  switch(*c) {\n", e);
+    for(int code = 0; code < t->nb_symboles; code++) {
+      unsigned char s = t->symboles[code];
+      int32_t i = table_chercher(t, e, s);
+      if(i < 0) continue;
+      regle rg = &t->regles[i];
+      fprintf(f, "    case %d: *c = %d; n++; ", s, rg->symbole_ecrit);
+      if(rg->deplacement > 0) fprintf(f, "DROITE(%d) ", rg->nouvel_etat);
+      else if(rg->deplacement < 0) 
+        fprintf(f, "GAUCHE(%d) ", rg->nouvel_etat);
+      fprintf(f, "goto E%d;\n", rg->nouvel_etat);
+    }
+    fprintf(f, "    default: etat = %d; goto arret;\n  }\n", e);
+  }
+  fprintf(f, 
+    "arret:\n"
+    "  *etat_ = etat;\n"
+    "  *tete = p;\n"
+    "  *etapes = n;\n"
+    "  return arret;\n"
+    "}\n");
+}
+
+/**
+* Crée un répertoire s'il n'existe pas. Les bibliothèques du cache sont
+* chargées avec dlopen : le répertoire doit appartenir à l'utilisateur
+* et n'être modifiable ni par son groupe ni par les autres.
+* @return 1 si le répertoire existe et est sûr, 0 sinon
+*/
+static int creer_repertoire(const char *chemin) {
+  struct stat st;
+  if(mkdir(chemin, 0700) != 0 && errno != EEXIST) return 0;
+  return lstat(chemin, &st) == 0 && S_ISDIR(st.st_mode) 
+         && st.st_uid == getuid() && !(st.st_mode & (S_IWGRP | S_IWOTH));
+}
+
+/**
+* Choisit le répertoire du cache des bibliothèques compilées
+* @param chemin : le chemin du répertoire (de taille PATH_MAX)
+* @return 1 si le cache est utilisable, 0 sinon
+*/
+static int repertoire_cache(char *chemin) {
+  const char *xdg = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+  size_t l;
+  if(xdg && *xdg) {
+    snprintf(chemin, PATH_MAX, "%s", xdg);
+    l = strlen(chemin);
+    snprintf(chemin + l, PATH_MAX - l, "/simulation_mt");
+    if(creer_repertoire(chemin)) return 1;
+  }
+  if(home && *home) {
+    snprintf(chemin, PATH_MAX, "%s/.cache", home);
+    l = strlen(chemin);
+    int ok = creer_repertoire(chemin);
+    snprintf(chemin + l, PATH_MAX - l, "/simulation_mt");
+    if(ok && creer_repertoire(chemin)) return 1;
+  }
+  return 0;
+}
+
+/**
+* Exécute une commande du compilateur via /bin/sh sans passer par 
+* system() : les chemins sont transmis comme arguments ($1, $2)
+* @param commande : la commande, qui désigne les chemins par "$1" et "$2"
+* @param sortie : le chemin du fichier produit ($1)
+* @param source : le chemin du fichier source ($2)
+* @return 1 si la commande se termine avec le code 0, 0 sinon
+*/
+static int executer_compilateur(const char *commande, const char *sortie,
+                                const char *source) {
+  pid_t pid = fork();
+  if(pid < 0) {
+    perror("Erreur de lancement du compilateur.\n");
+    return 0;
+  }
+  if(pid == 0) {
+    execl("/bin/sh", "sh", "-c", commande, "sh", sortie, source, 
+          (char*) NULL);
+    _exit(127);
+  }
+  int statut;
+  while(waitpid(pid, &statut, 0) < 0)
+    if(errno != EINTR) {
+      perror("Erreur d'attente du compilateur.\n");
+      return 0;
+    }
+  return WIFEXITED(statut) && WEXITSTATUS(statut) == 0;
+}
+
+/**
+* Compile un code généré en bibliothèque partagée
+* @param code : le code C
+* @param taille : la taille du code
+* @param compilateur : la commande du compilateur
+* @param bibliotheque : le chemin de la bibliothèque à créer
+* @return 1 en cas de succès, 0 sinon
+*/
+static int compiler_code(char *code, size_t taille, const char *compilateur,
+                         const char *bibliotheque) {
+  char source[PATH_MAX + 64], temporaire[PATH_MAX + 64];
+  char commande[PATH_MAX];
+  snprintf(source, sizeof(source), "%s.%d.c", bibliotheque, (int) getpid());
+  snprintf(temporaire, sizeof(temporaire), "%s.%d", bibliotheque, 
+           (int) getpid());
+
+  FILE *f = fopen(source, "w");
+  if(!f) {
+    perror("Erreur d'écriture du code natif.\n");
+    return 0;
+  }
+  int ok = fwrite(code, 1, taille, f) == taille;
+  ok = fclose(f) == 0 && ok;
+
+  // La bibliothèque est compilée sous un nom temporaire puis renommée,
+  // pour que des exécutions simultanées ne chargent jamais un fichier 
+  // incomplet. $CC peut contenir des options : il passe par le shell, 
+  // mais les chemins lui sont donnés en paramètres positionnels et ne 
+  // sont jamais interprétés
+  snprintf(commande, sizeof(commande), 
+           "%s -O2 -shared -fPIC -w -o \"$1\" \"$2\"", compilateur);
+  ok = ok && executer_compilateur(commande, temporaire, source)
+       && rename(temporaire, bibliotheque) == 0;
+  if(!ok) {
+    fprintf(stderr, "\n[ERR]: Échec de la compilation du code natif "
+            "('%s' avec $1=%s, $2=%s)\n", commande, temporaire, source);
+    unlink(temporaire);
+  }
+  unlink(source);
+  return ok;
+}
+
+natif charger_natif(MT mt) {
+  char *code = NULL;
+  size_t taille = 0;
+  FILE *f = open_memstream(&code, &taille);
+  if(!f) {
+    perror("Erreur d'allocation du code natif.\n");
+    return NULL;
+  }
+  generer_code(mt->table, f);
+  if(fclose(f) != 0) {
+    perror("Erreur d'allocation du code natif.\n");
+    free(code);
+    return NULL;
+  }
+
+  // La clé du cache dépend du code généré (qui inclut la version du 
+  // générateur) et du compilateur
+  const char *compilateur = getenv("CC");
+  if(!compilateur || !*compilateur) compilateur = "cc";
+  uint64_t h = hachage_fnv1a(FNV1A_BASE, code, taille);
+  h = hachage_fnv1a(h, compilateur, strlen(compilateur));
+
+  // Sans cache sûr, la bibliothèque est compilée dans un répertoire 
+  // privé (créé en 0700 par mkdtemp), supprimé une fois chargée
+  char repertoire[PATH_MAX], bibliotheque[PATH_MAX + 32];
+  int cache = repertoire_cache(repertoire);
+  if(!cache) {
+    snprintf(repertoire, PATH_MAX, "/tmp/simulation_mt_XXXXXX");
+    if(!mkdtemp(repertoire)) {
+      perror("Erreur de création du répertoire du code natif.\n");
+      free(code);
+      return NULL;
+    }
+  }
+  snprintf(bibliotheque, sizeof(bibliotheque), "%s/mt_%016llx.so", 
+           repertoire, (unsigned long long) h);
+  int compile = (cache && access(bibliotheque, R_OK) == 0)
+                || compiler_code(code, taille, compilateur, bibliotheque);
+  free(code);
+
+  natif n = compile ? (natif) malloc(sizeof(struct natif_s)) : NULL;
+  if(compile && !n) perror("Erreur d'allocation du code natif.\n");
+  if(n) n->bibliotheque = dlopen(bibliotheque, RTLD_NOW | RTLD_LOCAL);
+  if(!cache) {
+    unlink(bibliotheque);
+    rmdir(repertoire);
+  }
+  if(!n) return NULL;
+  const unsigned long *taille_ruban = NULL;
+  if(n->bibliotheque) {
+    n->executer = (fonction_natif) dlsym(n->bibliotheque, SYMBOLE_NATIF);
+    taille_ruban = (const unsigned long*) dlsym(n->bibliotheque, 
+                                                "mt_taille_ruban");
+  }
+  if(!n->bibliotheque || !n->executer || !taille_ruban 
+     || *taille_ruban != sizeof(struct ruban_s)) {
+    fprintf(stderr, "\n[ERR]: Chargement du code natif '%s' impossible"
+            " (%s)\n", bibliotheque, 
+            n->bibliotheque ? "bibliothèque incompatible" : dlerror());
+    free_natif(n);
+    return NULL;
+  }
+  return n;
+}
+
+/**
+* Exécute une tranche avec le code natif n (tranche_moteur)
+*/
+static int executer_tranche(configuration c, long fin_tranche, 
+                            void *contexte) {
+  natif n = (natif) contexte;
+  return n->executer(c->ruban_courant, &c->etat_courant, &c->tete_lecture,
+                     &c->nb_etapes, fin_tranche, ruban_etendre);
+}
+
+int executer_natif(natif n, configuration c, limites l) {
+  return executer_tranches(c, l, executer_tranche, NULL, n);
+}
+
+void free_natif(natif n) {
+  if(!n) return;
+  if(n->bibliotheque) dlclose(n->bibliotheque);
+  free(n);
+}
@@ -0,0 +1,68 @@
+#ifndef _natif_h_
+#define _natif_h_
+
+#include "machineturing.h"
+
+/**
+* Version du générateur de code, incluse dans la clé du cache : elle
+* doit être incrémentée à chaque modification du code généré
+*/
+#define VERSION_NATIF 1
+
+/**
+* Fonction générée pour une machine : exécute la machine depuis l'état
+* *etat, la position *tete et l'étape *etapes, jusqu'à son arrêt ou 
+* jusqu'à l'étape fin_tranche (même calcul que executer()). 
+* La fonction etendre est appelée quand la tête sort des cases allouées.
+* @return 1 si la machine s'est arrêtée, 0 si fin_tranche est atteinte
+*/
+typedef int (*fonction_natif)(ruban r, int *etat, long *tete, 
+                              long *etapes, long fin_tranche,
+                              int (*etendre)(ruban, long));
+
+/**
+* Code natif d'une machine de Turing, chargé avec dlopen.
+* bibliotheque -> la bibliothèque partagée chargée
+* executer -> la fonction d'exécution de la machine
+*/
+struct natif_s {
+  void *bibliotheque;
+  fonction_natif executer;
+};
+typedef struct natif_s* natif;
+
+/**
+* Traduit la table des transitions d'une machine en un fichier C (un 
+* label par état, un switch sur le symbole lu par état, un goto vers le
+* nouvel état par transition), le compile en bibliothèque partagée avec
+* le compilateur local ($CC, cc par défaut) puis la charge avec dlopen.
+* Les bibliothèques sont gardées dans un cache ($XDG_CACHE_HOME ou 
+* ~/.cache/simulation_mt) sous un nom dérivé du hachage du code généré :
+* une machine déjà compilée est chargée directement. Sans cache sûr, la
+* bibliothèque est compilée dans un répertoire privé de /tmp, supprimé 
+* une fois chargée.
+* @param mt : la machine à compiler
+* @return le code natif chargé, NULL en cas d'erreur
+*/
+natif charger_natif(MT mt);
+
+/**
+* Exécute une machine de Turing avec son code natif. Le nombre d'étapes
+* et le résultat sont les mêmes qu'avec executer().
+* @param n : le code natif de la machine de la configuration
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite par ce moteur), NULL pour ne pas
+*            limiter
+* @return le résultat de l'exécution (enum resultat)
+*/
+int executer_natif(natif n, configuration c, limites l);
+
+/**
+* Décharge le code natif d'une machine
+* @param n : le code natif à libérer
+*/
+void free_natif(natif n);
+
+
+#endif
@@ -0,0 +1,839 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "hachage.h"
+#include "nondeterministe.h"
+
+// Nombre de cases d'un morceau de ruban : 1 << DECALAGE_MORCEAU
+#define DECALAGE_MORCEAU 6
+#define TAILLE_MORCEAU (1L << DECALAGE_MORCEAU)
+// Nombre de fils d'un noeud de l'index des morceaux : 1 << DECALAGE_NOEUD
+#define DECALAGE_NOEUD 3
+#define ARITE_NOEUD (1 << DECALAGE_NOEUD)
+// Nombre de segments de l'ensemble des configurations :
+// 1 << DECALAGE_SEGMENTS
+#define DECALAGE_SEGMENTS 6
+#define NB_SEGMENTS (1 << DECALAGE_SEGMENTS)
+// Nombre de cases allouées initialement pour un segment
+#define TAILLE_SEGMENT_MIN 64
+// Nombre de configurations de la frontière réservées à la fois par un
+// thread
+#define TAILLE_PAQUET 16
+// Nombre de configurations allouées initialement pour une frontière
+#define CAPACITE_FRONTIERE_MIN 64
+
+/**
+* Morceau de ruban, partagé par toutes les branches qui ne l'ont pas
+* modifié depuis leur ancêtre commun.
+* refs -> le nombre de branches qui utilisent le morceau (accès
+*         atomique) ; une branche ne modifie un morceau que si elle est
+*         la seule à l'utiliser, sinon elle le copie
+* cases -> les cases du morceau
+*/
+struct morceau_s {
+  int refs;
+  cellule cases[TAILLE_MORCEAU];
+};
+typedef struct morceau_s* morceau;
+
+/**
+* Noeud de l'index des morceaux du ruban d'une branche. L'index est un 
+* arbre persistant : comme les morceaux, ses noeuds sont partagés par 
+* les branches qui ne les ont pas modifiés, et une écriture ne copie que
+* les noeuds du chemin vers son morceau.
+* refs -> le nombre de branches et de noeuds qui utilisent le noeud 
+*         (accès atomique)
+* fils -> les noeuds fils, ou les morceaux pour un noeud de niveau 1 ;
+*         NULL pour un sous-arbre blanc
+*/
+struct noeud_s {
+  int refs;
+  union {
+    struct noeud_s *noeuds[ARITE_NOEUD];
+    morceau morceaux[ARITE_NOEUD];
+  } fils;
+};
+typedef struct noeud_s* noeud;
+
+/**
+* Branche du calcul, i.e. configuration de la machine. Une branche
+* rangée dans l'ensemble des configurations n'est plus modifiée.
+* etat -> l'identifiant de l'état
+* tete -> la position de la tête de lecture
+* min / max -> les positions extrêmes visitées par la tête sur la branche
+* profondeur -> le nombre d'étapes depuis le début du calcul
+* racine -> la racine de l'index des morceaux du ruban, NULL pour un 
+*           ruban blanc. Le morceau k contient les positions 
+*           k * TAILLE_MORCEAU à (k + 1) * TAILLE_MORCEAU - 1 ; il est 
+*           rangé dans l'index à l'indice donné par indice_morceau()
+* hauteur -> le niveau de la racine (0 sans racine) : l'index contient 
+*            les indices 0 à ARITE_NOEUD^hauteur - 1
+* hachage_ruban -> le XOR des hachages des cases non blanches
+* hachage -> le hachage de la configuration
+*/
+struct branche_s {
+  int32_t etat;
+  long tete;
+  long min;
+  long max;
+  long profondeur;
+  noeud racine;
+  int hauteur;
+  uint64_t hachage_ruban;
+  uint64_t hachage;
+};
+typedef struct branche_s* branche;
+
+/**
+* Compteurs d'un thread
+* developpees -> les configurations dont les transitions ont été
+*                appliquées
+* arrets -> les configurations sans transition (branches arrêtées hors
+*           de l'état final)
+* branches -> les configurations créées
+* recherches / doublons -> les recherches dans l'ensemble des
+*                          configurations, et celles qui ont trouvé la
+*                          configuration déjà explorée
+* morceaux_alloues / morceaux_copies -> les morceaux de ruban créés
+*                                       blancs, ou copiés à l'écriture
+* noeuds_copies -> les noeuds de l'index des morceaux copiés à 
+*                  l'écriture
+*/
+struct compteurs_s {
+  long developpees;
+  long arrets;
+  long branches;
+  long recherches;
+  long doublons;
+  long morceaux_alloues;
+  long morceaux_copies;
+  long noeuds_copies;
+};
+
+/**
+* Segment de l'ensemble des configurations explorées : table de hachage
+* (adressage ouvert) protégée par son propre verrou. Le segment d'une
+* configuration est donné par les bits de poids fort de son hachage.
+*/
+struct segment_s {
+  pthread_mutex_t verrou;
+  long taille;
+  long nb;
+  branche *cases;
+};
+
+/**
+* Données partagées de l'exploration.
+* table -> la table des transitions de la machine
+* blanc -> le symbole blanc
+* limites / debut -> les limites et l'heure de début de l'exploration
+* segments -> l'ensemble des configurations explorées, qui possède les
+*             branches
+* frontiere -> les configurations du niveau en cours de développement
+* nb_frontiere / capacite_frontiere -> leur nombre et la capacité
+* suivant -> l'indice de la prochaine configuration à développer
+*            (accès atomique)
+* acceptee -> la première branche arrivée dans l'état final, NULL avant
+*             (accès atomique)
+* interrompue -> 1 si la durée maximale est dépassée
+* erreur -> 1 en cas d'erreur d'allocation
+* depart -> verrou tenu par le thread principal pendant la création des
+*           threads : les barrières ne sont initialisées qu'ensuite,
+*           pour le nombre de threads effectivement créés
+* debut_niveau / fin_niveau -> barrières de début et de fin du
+*                              développement d'un niveau
+* termine -> 1 lorsque l'exploration est finie
+*/
+struct exploration_s {
+  table_transitions table;
+  cellule blanc;
+  limites limites;
+  double debut;
+  struct segment_s segments[NB_SEGMENTS];
+  branche *frontiere;
+  long nb_frontiere;
+  long capacite_frontiere;
+  long suivant;
+  branche acceptee;
+  int interrompue;
+  int erreur;
+  pthread_mutex_t depart;
+  pthread_barrier_t debut_niveau;
+  pthread_barrier_t fin_niveau;
+  int termine;
+};
+typedef struct exploration_s* exploration;
+
+/**
+* Paramètres d'un thread : les configurations nouvelles qu'il a créées
+* pour le niveau suivant, ses compteurs et la dernière configuration
+* retrouvée dans l'ensemble à une profondeur plus grande (repetee, 
+* rangée dans l'ensemble, et profondeur_repetee, la profondeur à 
+* laquelle elle a été retrouvée ; NULL et 0 avant)
+*/
+struct travailleur_s {
+  exploration e;
+  branche *suivantes;
+  long nb_suivantes;
+  long capacite;
+  struct compteurs_s stats;
+  branche repetee;
+  long profondeur_repetee;
+};
+
+/**
+* Hachage du contenu d'une case (même hachage que cycles.c) : les cases
+* blanches ne contribuent pas au hachage du ruban
+*/
+static inline uint64_t hachage_case(long position, cellule symbole,
+                                    cellule blanc) {
+  if(symbole == blanc) return 0;
+  return hachage_melanger(((uint64_t) position << 8) ^ symbole);
+}
+
+static inline uint64_t hachage_branche(branche b) {
+  return b->hachage_ruban ^ hachage_melanger(hachage_melanger(b->etat)
+                                             ^ (uint64_t) b->tete);
+}
+
+/**
+* Indice dans l'index d'une branche du morceau de numéro k : les 
+* numéros positifs et négatifs sont entrelacés (0, -1, 1, -2, ...) pour
+* que l'index reste petit autour de l'origine
+*/
+static inline unsigned long indice_morceau(long k) {
+  return k >= 0 ? (unsigned long) k << 1 
+                : ((unsigned long) -(k + 1) << 1) | 1;
+}
+
+/**
+* Renvoie le morceau de numéro k d'une branche, NULL s'il est blanc
+*/
+static inline morceau morceau_numero(branche b, long k) {
+  unsigned long z = indice_morceau(k);
+  noeud n = b->racine;
+  if(!n || z >> (DECALAGE_NOEUD * b->hauteur)) return NULL;
+  for(int h = b->hauteur; h > 1 && n; h--)
+    n = n->fils.noeuds[(z >> (DECALAGE_NOEUD * (h - 1))) 
+                       & (ARITE_NOEUD - 1)];
+  return n ? n->fils.morceaux[z & (ARITE_NOEUD - 1)] : NULL;
+}
+
+static inline cellule lire_case(branche b, long position, cellule blanc) {
+  morceau m = morceau_numero(b, position >> DECALAGE_MORCEAU);
+  return m ? m->cases[position & (TAILLE_MORCEAU - 1)] : blanc;
+}
+
+/**
+* Crée un morceau utilisé par une seule branche, copie d'un morceau
+* donné ou blanc
+* @param modele : le morceau à copier, NULL pour un morceau blanc
+* @return le morceau, NULL en cas d'erreur d'allocation
+*/
+static morceau creer_morceau(morceau modele, cellule blanc) {
+  morceau m = (morceau) malloc(sizeof(struct morceau_s));
+  if(!m) return NULL;
+  m->refs = 1;
+  if(modele) memcpy(m->cases, modele->cases, TAILLE_MORCEAU);
+  else memset(m->cases, blanc, TAILLE_MORCEAU);
+  return m;
+}
+
+static void liberer_morceau(morceau m) {
+  if(m && __atomic_sub_fetch(&m->refs, 1, __ATOMIC_ACQ_REL) == 0) free(m);
+}
+
+/**
+* Crée un noeud de l'index utilisé par une seule branche, copie d'un 
+* noeud donné (ses fils sont alors partagés) ou vide
+* @param modele : le noeud à copier, NULL pour un noeud vide
+* @param niveau : le niveau du noeud
+* @return le noeud, NULL en cas d'erreur d'allocation
+*/
+static noeud creer_noeud(noeud modele, int niveau) {
+  noeud n = (noeud) malloc(sizeof(struct noeud_s));
+  if(!n) return NULL;
+  n->refs = 1;
+  if(!modele) {
+    memset(&n->fils, 0, sizeof(n->fils));
+    return n;
+  }
+  n->fils = modele->fils;
+  for(int j = 0; j < ARITE_NOEUD; j++) {
+    if(niveau > 1 && n->fils.noeuds[j])
+      __atomic_add_fetch(&n->fils.noeuds[j]->refs, 1, __ATOMIC_RELAXED);
+    else if(niveau == 1 && n->fils.morceaux[j])
+      __atomic_add_fetch(&n->fils.morceaux[j]->refs, 1, __ATOMIC_RELAXED);
+  }
+  return n;
+}
+
+static void liberer_noeud(noeud n, int niveau) {
+  if(!n || __atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+  for(int j = 0; j < ARITE_NOEUD; j++) {
+    if(niveau > 1) liberer_noeud(n->fils.noeuds[j], niveau - 1);
+    else liberer_morceau(n->fils.morceaux[j]);
+  }
+  free(n);
+}
+
+static void free_branche(branche b) {
+  if(!b) return;
+  liberer_noeud(b->racine, b->hauteur);
+  free(b);
+}
+
+/**
+* Ecrit un symbole sur le ruban d'une branche en cours de construction,
+* en copiant les noeuds de l'index et le morceau de la case s'ils sont
+* partagés
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int ecrire_case(branche b, long position, cellule symbole,
+                       cellule blanc, struct compteurs_s *stats) {
+  long k = position >> DECALAGE_MORCEAU;
+  long i = position & (TAILLE_MORCEAU - 1);
+  morceau actuel = morceau_numero(b, k);
+  if(actuel ? actuel->cases[i] == symbole : symbole == blanc) return 1;
+
+  // Agrandissement de l'index : l'ancienne racine devient le premier 
+  // fils de la nouvelle
+  unsigned long z = indice_morceau(k);
+  while(!b->racine || z >> (DECALAGE_NOEUD * b->hauteur)) {
+    noeud racine = creer_noeud(NULL, b->hauteur + 1);
+    if(!racine) return 0;
+    racine->fils.noeuds[0] = b->racine;
+    b->racine = racine;
+    b->hauteur++;
+  }
+  // Descente vers le morceau, en copiant les noeuds partagés
+  noeud *n = &b->racine;
+  morceau *m;
+  for(int h = b->hauteur; ; h--) {
+    if(__atomic_load_n(&(*n)->refs, __ATOMIC_ACQUIRE) > 1) {
+      noeud copie = creer_noeud(*n, h);
+      if(!copie) return 0;
+      liberer_noeud(*n, h);
+      *n = copie;
+      stats->noeuds_copies++;
+    }
+    int j = (z >> (DECALAGE_NOEUD * (h - 1))) & (ARITE_NOEUD - 1);
+    if(h == 1) {
+      m = &(*n)->fils.morceaux[j];
+      break;
+    }
+    n = &(*n)->fils.noeuds[j];
+    if(!*n && !(*n = creer_noeud(NULL, h - 1))) return 0;
+  }
+  if(!*m) {
+    if(!(*m = creer_morceau(NULL, blanc))) return 0;
+    stats->morceaux_alloues++;
+  } else if(__atomic_load_n(&(*m)->refs, __ATOMIC_ACQUIRE) > 1) {
+    morceau copie = creer_morceau(*m, blanc);
+    if(!copie) return 0;
+    liberer_morceau(*m);
+    *m = copie;
+    stats->morceaux_copies++;
+  }
+  b->hachage_ruban ^= hachage_case(position, (*m)->cases[i], blanc)
+                      ^ hachage_case(position, symbole, blanc);
+  (*m)->cases[i] = symbole;
+  return 1;
+}
+
+/**
+* Crée la branche fille d'une branche par une règle : la fille partage
+* l'index et tous les morceaux de sa mère, sauf le morceau où la règle 
+* écrit un symbole différent et les noeuds de son chemin dans l'index
+* @return la branche, NULL en cas d'erreur d'allocation
+*/
+static branche deriver(branche mere, regle rg, cellule blanc,
+                       struct compteurs_s *stats) {
+  branche b = (branche) malloc(sizeof(struct branche_s));
+  if(!b) return NULL;
+  *b = *mere;
+  if(b->racine) __atomic_add_fetch(&b->racine->refs, 1, __ATOMIC_RELAXED);
+  if(!ecrire_case(b, mere->tete, rg->symbole_ecrit, blanc, stats)) {
+    free_branche(b);
+    return NULL;
+  }
+  b->etat = rg->nouvel_etat;
+  b->tete += rg->deplacement;
+  if(b->tete < b->min) b->min = b->tete;
+  if(b->tete > b->max) b->max = b->tete;
+  b->profondeur++;
+  b->hachage = hachage_branche(b);
+  return b;
+}
+
+/**
+* Crée la branche d'une configuration
+* @return la branche, NULL en cas d'erreur d'allocation
+*/
+static branche branche_configuration(configuration c,
+                                     struct compteurs_s *stats) {
+  ruban r = c->ruban_courant;
+  branche b = (branche) calloc(1, sizeof(struct branche_s));
+  if(!b) return NULL;
+  b->etat = c->etat_courant;
+  b->tete = c->tete_lecture;
+  b->min = r->min;
+  b->max = r->max;
+  b->profondeur = c->nb_etapes;
+  for(long p = r->min; p <= r->max; p++) {
+    if(!ecrire_case(b, p, *ruban_case(r, p), r->symbole_blanc, stats)) {
+      free_branche(b);
+      return NULL;
+    }
+  }
+  b->hachage = hachage_branche(b);
+  return b;
+}
+
+/**
+* Recopie le ruban d'une branche dans le ruban d'une configuration
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int recopier_branche(branche b, ruban r) {
+  if(!ruban_etendre(r, b->min) || !ruban_etendre(r, b->max)) return 0;
+  for(long p = b->min; p <= b->max; p++)
+    *ruban_case(r, p) = lire_case(b, p, r->symbole_blanc);
+  r->min = b->min;
+  r->max = b->max;
+  return 1;
+}
+
+static int morceaux_egaux(morceau a, morceau b, cellule blanc) {
+  if(a && b) return !memcmp(a->cases, b->cases, TAILLE_MORCEAU);
+  morceau m = a ? a : b;
+  for(long i = 0; i < TAILLE_MORCEAU; i++)
+    if(m->cases[i] != blanc) return 0;
+  return 1;
+}
+
+/**
+* Indique si un sous-arbre de l'index ne contient que des cases blanches
+*/
+static int sous_arbre_blanc(noeud n, int niveau, cellule blanc) {
+  if(!n) return 1;
+  for(int j = 0; j < ARITE_NOEUD; j++) {
+    if(niveau > 1 ? !sous_arbre_blanc(n->fils.noeuds[j], niveau - 1, blanc)
+       : n->fils.morceaux[j] 
+         && !morceaux_egaux(n->fils.morceaux[j], NULL, blanc))
+      return 0;
+  }
+  return 1;
+}
+
+/**
+* Compare deux sous-arbres de même niveau, les sous-arbres partagés
+* n'étant pas comparés
+*/
+static int sous_arbres_egaux(noeud a, noeud b, int niveau, cellule blanc) {
+  if(a == b) return 1;
+  if(!a || !b) return sous_arbre_blanc(a ? a : b, niveau, blanc);
+  for(int j = 0; j < ARITE_NOEUD; j++) {
+    if(niveau > 1 ? !sous_arbres_egaux(a->fils.noeuds[j], b->fils.noeuds[j],
+                                       niveau - 1, blanc)
+       : a->fils.morceaux[j] != b->fils.morceaux[j]
+         && !morceaux_egaux(a->fils.morceaux[j], b->fils.morceaux[j], blanc))
+      return 0;
+  }
+  return 1;
+}
+
+/**
+* Compare deux configurations : état, position de la tête et contenu du
+* ruban, les morceaux et sous-arbres partagés n'étant pas comparés
+* @return 1 si les configurations sont égales, 0 sinon
+*/
+static int branches_egales(branche a, branche b, cellule blanc) {
+  if(a->etat != b->etat || a->tete != b->tete
+     || a->hachage_ruban != b->hachage_ruban)
+    return 0;
+  // L'index le plus haut ne contient que des blancs hors de son premier
+  // fils, qui correspond à la racine de l'autre
+  noeud ra = a->racine, rb = b->racine;
+  int ha = a->hauteur, hb = b->hauteur;
+  while(ra && rb && ha != hb) {
+    noeud *haut = ha > hb ? &ra : &rb;
+    int *h = ha > hb ? &ha : &hb;
+    for(int j = 1; j < ARITE_NOEUD; j++)
+      if(!sous_arbre_blanc((*haut)->fils.noeuds[j], *h - 1, blanc)) return 0;
+    *haut = (*haut)->fils.noeuds[0];
+    (*h)--;
+  }
+  if(!ra || !rb) return sous_arbre_blanc(ra ? ra : rb, ra ? ha : hb, blanc);
+  return sous_arbres_egaux(ra, rb, ha, blanc);
+}
+
+/**
+* Double la taille d'un segment (son verrou est pris)
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int agrandir_segment(struct segment_s *s) {
+  long taille = s->taille * 2;
+  branche *cases = (branche*) calloc(taille, sizeof(branche));
+  if(!cases) return 0;
+  for(long i = 0; i < s->taille; i++) {
+    if(!s->cases[i]) continue;
+    long k = s->cases[i]->hachage & (taille - 1);
+    while(cases[k]) k = (k + 1) & (taille - 1);
+    cases[k] = s->cases[i];
+  }
+  free(s->cases);
+  s->cases = cases;
+  s->taille = taille;
+  return 1;
+}
+
+/**
+* Range une configuration dans l'ensemble des configurations explorées,
+* qui la possède alors, si elle n'y est pas déjà
+* @param existante : reçoit la configuration égale déjà rangée, si elle
+*                    existe
+* @return 1 si la configuration est nouvelle, 0 si elle a déjà été
+*         explorée, -1 en cas d'erreur d'allocation
+*/
+static int inserer_configuration(exploration e, branche b,
+                                 struct compteurs_s *stats,
+                                 branche *existante) {
+  struct segment_s *s =
+    &e->segments[b->hachage >> (64 - DECALAGE_SEGMENTS)];
+  stats->recherches++;
+  pthread_mutex_lock(&s->verrou);
+  if(2 * (s->nb + 1) > s->taille && !agrandir_segment(s)) {
+    pthread_mutex_unlock(&s->verrou);
+    return -1;
+  }
+  long k = b->hachage & (s->taille - 1);
+  while(s->cases[k]) {
+    if(s->cases[k]->hachage == b->hachage
+       && branches_egales(s->cases[k], b, e->blanc)) {
+      *existante = s->cases[k];
+      pthread_mutex_unlock(&s->verrou);
+      stats->doublons++;
+      return 0;
+    }
+    k = (k + 1) & (s->taille - 1);
+  }
+  s->cases[k] = b;
+  s->nb++;
+  pthread_mutex_unlock(&s->verrou);
+  return 1;
+}
+
+static int ajouter_suivante(struct travailleur_s *tr, branche b) {
+  if(tr->nb_suivantes == tr->capacite) {
+    long capacite = tr->capacite ? tr->capacite * 2 : CAPACITE_FRONTIERE_MIN;
+    branche *suivantes = (branche*) realloc(tr->suivantes,
+                                            capacite * sizeof(branche));
+    if(!suivantes) return 0;
+    tr->suivantes = suivantes;
+    tr->capacite = capacite;
+  }
+  tr->suivantes[tr->nb_suivantes++] = b;
+  return 1;
+}
+
+/**
+* Applique à une configuration toutes les transitions de son couple
+* (etat, symbole lu). Les configurations filles nouvelles sont gardées
+* pour le niveau suivant ; une fille dans l'état final termine
+* l'exploration.
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int developper(struct travailleur_s *tr, branche b) {
+  exploration e = tr->e;
+  table_transitions t = e->table;
+  tr->stats.developpees++;
+  int32_t i = table_chercher(t, b->etat, lire_case(b, b->tete, e->blanc));
+  if(i < 0) {
+    tr->stats.arrets++;
+    return 1;
+  }
+  for(int32_t j = i; j < i + t->regles[i].nb_alternatives; j++) {
+    branche f = deriver(b, &t->regles[j], e->blanc, &tr->stats);
+    if(!f) return 0;
+    tr->stats.branches++;
+    branche existante = NULL;
+    int nouvelle = inserer_configuration(e, f, &tr->stats, &existante);
+    if(nouvelle <= 0) {
+      // Les branches rangées ne sont plus modifiées : la profondeur de
+      // existante peut être lue sans verrou
+      if(nouvelle == 0 && existante->profondeur < f->profondeur) {
+        tr->repetee = existante;
+        tr->profondeur_repetee = f->profondeur;
+      }
+      free_branche(f);
+      if(nouvelle < 0) return 0;
+      continue;
+    }
+    if(f->etat == t->etat_fin) {
+      branche attendue = NULL;
+      __atomic_compare_exchange_n(&e->acceptee, &attendue, f, 0,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+      return 1;
+    }
+    if(!ajouter_suivante(tr, f)) return 0;
+  }
+  return 1;
+}
+
+static int exploration_arretee(exploration e) {
+  return __atomic_load_n(&e->acceptee, __ATOMIC_ACQUIRE)
+         || __atomic_load_n(&e->interrompue, __ATOMIC_RELAXED)
+         || __atomic_load_n(&e->erreur, __ATOMIC_RELAXED);
+}
+
+/**
+* Développe les configurations de la frontière réservées par paquets,
+* jusqu'à ce que toutes soient réservées ou que l'exploration s'arrête
+*/
+static void developper_niveau(struct travailleur_s *tr) {
+  exploration e = tr->e;
+  long i, fin;
+  while(!exploration_arretee(e)
+        && (i = __atomic_fetch_add(&e->suivant, TAILLE_PAQUET,
+                                   __ATOMIC_RELAXED)) < e->nb_frontiere) {
+    fin = i + TAILLE_PAQUET < e->nb_frontiere ? i + TAILLE_PAQUET
+                                              : e->nb_frontiere;
+    for(; i < fin; i++) {
+      if(!developper(tr, e->frontiere[i])) {
+        __atomic_store_n(&e->erreur, 1, __ATOMIC_RELAXED);
+        return;
+      }
+    }
+    if(delai_depasse(e->limites, e->debut))
+      __atomic_store_n(&e->interrompue, 1, __ATOMIC_RELAXED);
+  }
+}
+
+static void* travailleur(void *arg) {
+  struct travailleur_s *tr = (struct travailleur_s*) arg;
+  exploration e = tr->e;
+  // Attend que le thread principal ait initialisé les barrières
+  pthread_mutex_lock(&e->depart);
+  pthread_mutex_unlock(&e->depart);
+  for(;;) {
+    pthread_barrier_wait(&e->debut_niveau);
+    if(e->termine) break;
+    developper_niveau(tr);
+    pthread_barrier_wait(&e->fin_niveau);
+  }
+  return NULL;
+}
+
+/**
+* Remplace la frontière par les configurations créées par les threads
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int niveau_suivant(exploration e, struct travailleur_s *trs,
+                          int nb_threads) {
+  long n = 0;
+  for(int i = 0; i < nb_threads; i++) n += trs[i].nb_suivantes;
+  if(n > e->capacite_frontiere) {
+    branche *frontiere = (branche*) realloc(e->frontiere,
+                                            n * sizeof(branche));
+    if(!frontiere) return 0;
+    e->frontiere = frontiere;
+    e->capacite_frontiere = n;
+  }
+  e->nb_frontiere = 0;
+  for(int i = 0; i < nb_threads; i++) {
+    if(trs[i].nb_suivantes)
+      memcpy(e->frontiere + e->nb_frontiere, trs[i].suivantes,
+             trs[i].nb_suivantes * sizeof(branche));
+    e->nb_frontiere += trs[i].nb_suivantes;
+    trs[i].nb_suivantes = 0;
+  }
+  return 1;
+}
+
+/**
+* Indique si une configuration de la frontière a encore une transition
+*/
+static int frontiere_active(exploration e) {
+  for(long i = 0; i < e->nb_frontiere; i++) {
+    branche b = e->frontiere[i];
+    if(table_chercher(e->table, b->etat, lire_case(b, b->tete, e->blanc))
+       >= 0)
+      return 1;
+  }
+  return 0;
+}
+
+int executer_non_deterministe(configuration c, limites l, int nb_threads,
+                              int recopier, FILE *statistiques) {
+  struct exploration_s e;
+  memset(&e, 0, sizeof(e));
+  e.table = c->mt->table;
+  e.blanc = c->ruban_courant->symbole_blanc;
+  e.limites = l;
+  e.debut = horloge_secondes();
+  struct compteurs_s total;
+  memset(&total, 0, sizeof(total));
+
+  int erreur = 0;
+  for(int i = 0; i < NB_SEGMENTS; i++) {
+    pthread_mutex_init(&e.segments[i].verrou, NULL);
+    e.segments[i].taille = TAILLE_SEGMENT_MIN;
+    e.segments[i].cases = (branche*) calloc(TAILLE_SEGMENT_MIN,
+                                            sizeof(branche));
+    if(!e.segments[i].cases) erreur = 1;
+  }
+  e.capacite_frontiere = CAPACITE_FRONTIERE_MIN;
+  e.frontiere = (branche*) malloc(CAPACITE_FRONTIERE_MIN * sizeof(branche));
+  struct travailleur_s *trs = (struct travailleur_s*) calloc(nb_threads,
+                                          sizeof(struct travailleur_s));
+  pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * nb_threads);
+  branche initiale = branche_configuration(c, &total), existante;
+  if(erreur || !e.frontiere || !trs || !threads || !initiale
+     || inserer_configuration(&e, initiale, &total, &existante) < 0) {
+    perror("Erreur d'allocation de la mémoire de l'exploration.\n");
+    free_branche(initiale);
+    for(int i = 0; i < NB_SEGMENTS; i++) {
+      pthread_mutex_destroy(&e.segments[i].verrou);
+      free(e.segments[i].cases);
+    }
+    free(e.frontiere);
+    free(trs);
+    free(threads);
+    return -1;
+  }
+  e.frontiere[0] = initiale;
+  e.nb_frontiere = 1;
+  if(initiale->etat == e.table->etat_fin) e.acceptee = initiale;
+
+  // Les threads et le thread principal se synchronisent au début et à
+  // la fin du développement de chaque niveau. L'exploration continue 
+  // avec les threads qui ont pu être créés.
+  int lances = 0;
+  pthread_mutex_init(&e.depart, NULL);
+  pthread_mutex_lock(&e.depart);
+  for(; lances < nb_threads; lances++) {
+    trs[lances].e = &e;
+    if(pthread_create(&threads[lances], NULL, travailleur, &trs[lances]))
+      break;
+  }
+  pthread_barrier_init(&e.debut_niveau, NULL, lances + 1);
+  pthread_barrier_init(&e.fin_niveau, NULL, lances + 1);
+  if(!lances) {
+    fprintf(stderr, "\n[ERR]: Echec de la création des threads de "
+            "l'exploration\n\n");
+    e.erreur = 1;
+  }
+  pthread_mutex_unlock(&e.depart);
+
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  long max_frontiere = 1, nb_niveaux = 0;
+  int limite_atteinte = 0;
+  // Une configuration du dernier niveau atteint
+  branche derniere = initiale;
+  while(!exploration_arretee(&e) && e.nb_frontiere > 0) {
+    if(derniere->profondeur >= limite || delai_depasse(l, e.debut)) {
+      limite_atteinte = 1;
+      break;
+    }
+    e.suivant = 0;
+    pthread_barrier_wait(&e.debut_niveau);
+    pthread_barrier_wait(&e.fin_niveau);
+    if(!niveau_suivant(&e, trs, nb_threads)) {
+      e.erreur = 1;
+      break;
+    }
+    nb_niveaux++;
+    if(e.nb_frontiere > 0) derniere = e.frontiere[0];
+    if(e.nb_frontiere > max_frontiere) max_frontiere = e.nb_frontiere;
+  }
+  e.termine = 1;
+  pthread_barrier_wait(&e.debut_niveau);
+  for(int i = 0; i < lances; i++) pthread_join(threads[i], NULL);
+  double duree = horloge_secondes() - e.debut;
+
+  long distinctes = 0;
+  for(int i = 0; i < nb_threads; i++) {
+    total.developpees += trs[i].stats.developpees;
+    total.arrets += trs[i].stats.arrets;
+    total.branches += trs[i].stats.branches;
+    total.recherches += trs[i].stats.recherches;
+    total.doublons += trs[i].stats.doublons;
+    total.morceaux_alloues += trs[i].stats.morceaux_alloues;
+    total.morceaux_copies += trs[i].stats.morceaux_copies;
+    total.noeuds_copies += trs[i].stats.noeuds_copies;
+  }
+  for(int i = 0; i < NB_SEGMENTS; i++) distinctes += e.segments[i].nb;
+
+  int res;
+  branche b = e.acceptee ? e.acceptee : derniere;
+  long profondeur = b->profondeur;
+  if(e.erreur) {
+    if(lances)
+      perror("Erreur d'allocation de la mémoire de l'exploration.\n");
+    res = -1;
+  } else if(e.acceptee) {
+    res = RESULTAT_ACCEPTE;
+  } else if(e.interrompue) {
+    res = RESULTAT_TIMEOUT;
+  } else if(limite_atteinte) {
+    // L'exploration n'est limitée que si une branche pouvait avancer
+    res = frontiere_active(&e) ? RESULTAT_TIMEOUT : RESULTAT_REFUSE;
+  } else if(!total.arrets && total.doublons) {
+    // Aucune branche ne s'est arrêtée : la frontière ne s'est vidée que
+    // parce que toutes les branches sont revenues sur des configurations
+    // déjà explorées. Le cycle rapporté est celui de la dernière 
+    // configuration retrouvée.
+    res = RESULTAT_BOUCLE;
+    for(int i = 0; i < nb_threads; i++) {
+      if(trs[i].repetee && trs[i].profondeur_repetee >= profondeur) {
+        b = trs[i].repetee;
+        profondeur = trs[i].profondeur_repetee;
+      }
+    }
+    c->debut_cycle = b->profondeur;
+    c->periode_cycle = profondeur - b->profondeur;
+  } else {
+    res = RESULTAT_REFUSE;
+  }
+  c->etat_courant = b->etat;
+  c->tete_lecture = b->tete;
+  c->nb_etapes = profondeur;
+  if(res >= 0 && recopier && !recopier_branche(b, c->ruban_courant)) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    res = -1;
+  }
+  if(statistiques) {
+    if(duree <= 0) duree = 1e-9;
+    fprintf(statistiques, "[NTM]: %ld configurations développées sur %ld "
+            "niveaux par %d threads en %.3f s\n"
+            "[NTM]: frontière maximale : %ld configurations ; %ld branches "
+            "créées, %ld arrêtées\n"
+            "[NTM]: %ld doublons sur %ld recherches (%.1f %%), %ld "
+            "configurations distinctes\n"
+            "[NTM]: morceaux de ruban (%ld cases) : %ld alloués, %ld copiés "
+            "à l'écriture ; %ld noeuds de l'index copiés\n",
+            total.developpees, nb_niveaux, lances, duree, max_frontiere,
+            total.branches, total.arrets, total.doublons, total.recherches,
+            total.recherches ? 100.0 * total.doublons / total.recherches : 0,
+            distinctes, (long) TAILLE_MORCEAU, total.morceaux_alloues,
+            total.morceaux_copies, total.noeuds_copies);
+  }
+
+  pthread_barrier_destroy(&e.debut_niveau);
+  pthread_barrier_destroy(&e.fin_niveau);
+  pthread_mutex_destroy(&e.depart);
+  for(int i = 0; i < NB_SEGMENTS; i++) {
+    for(long k = 0; k < e.segments[i].taille; k++)
+      free_branche(e.segments[i].cases[k]);
+    pthread_mutex_destroy(&e.segments[i].verrou);
+    free(e.segments[i].cases);
+  }
+  for(int i = 0; i < nb_threads; i++) free(trs[i].suivantes);
+  free(e.frontiere);
+  free(trs);
+  free(threads);
+  return res;
+}
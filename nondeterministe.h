@@ -0,0 +1,54 @@
+#ifndef _nondeterministe_h_
+#define _nondeterministe_h_
+
+#include <stdio.h>
+
+#include "machineturing.h"
+
+/**
+* Exécute une machine non déterministe : toutes les transitions
+* déclarées pour un couple (etat, symbole) sont appliquées, chacune
+* donnant une branche du calcul. Les configurations sont explorées en
+* largeur, niveau par niveau (un niveau par étape), par plusieurs
+* threads. Chaque configuration atteinte est rangée dans un ensemble
+* partagé indexé par son hachage (segments protégés chacun par un
+* verrou) : une configuration déjà explorée n'est pas développée une
+* seconde fois. Les rubans des branches sont découpés en morceaux de
+* taille fixe partagés entre une branche et ses filles, un morceau
+* n'étant copié que lorsqu'une branche y écrit un symbole différent
+* (copie sur écriture). Les morceaux d'une branche sont rangés dans un
+* arbre persistant, partagé de la même façon : une étape ne copie que
+* les noeuds du chemin vers le morceau modifié, et la mémoire d'une
+* branche ne croît pas avec la longueur du ruban.
+* L'exploration s'arrête dès qu'une branche atteint l'état final
+* (ACCEPTE, nombre d'étapes de la branche acceptante, qui est la plus
+* courte), lorsque plus aucune configuration nouvelle n'est atteinte
+* (REFUSE si au moins une branche s'est arrêtée, BOUCLE si toutes sont
+* revenues sur des configurations déjà explorées, avec le début et la
+* période de la dernière répétition trouvée dans c->debut_cycle et 
+* c->periode_cycle) ou à une limite (TIMEOUT ; la limite d'étapes est
+* la profondeur de l'exploration). Pour une machine déterministe, le 
+* résultat est celui de executer_cycles() lorsque la machine boucle, 
+* celui de executer() sinon.
+* @param c : la configuration de départ, mise à jour avec la branche
+*            acceptante ou, à défaut, une configuration du dernier
+*            niveau exploré (état, position de la tête, nombre d'étapes
+*            et, si recopier, ruban)
+* @param l : les limites de l'exploration (étapes et durée ; la
+*            détection des cycles est faite par l'ensemble des
+*            configurations explorées), NULL pour ne pas limiter
+* @param nb_threads : le nombre de threads
+* @param recopier : 1 pour recopier le ruban de la branche dans
+*                   c->ruban_courant, 0 pour ne pas le faire
+* @param statistiques : flux où afficher la taille maximale de la
+*                       frontière, le taux de doublons et le nombre de
+*                       morceaux de ruban copiés, NULL pour ne rien
+*                       afficher
+* @return le résultat de l'exploration (enum resultat), -1 en cas
+*         d'erreur
+*/
+int executer_non_deterministe(configuration c, limites l, int nb_threads,
+                              int recopier, FILE *statistiques);
+
+
+#endif
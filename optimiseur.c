@@ -0,0 +1,577 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "optimiseur.h"
+#include "hachage.h"
+
+/**
+* Transition de travail de l'optimiseur, rangée à l'indice
+* etat * nb_symboles + code du symbole lu.
+* cible -> l'identifiant du nouvel état, -1 s'il n'y a pas de transition
+* rang -> le rang de la transition d'origine, qui ordonne les lignes du
+*         fichier écrit
+* economie -> le nombre d'étapes retirées par la fusion des transitions
+*             '-' qui suivent
+* ecrit -> le symbole écrit
+* mouvement -> le déplacement ('>', '<' ou '-')
+*/
+struct regle_optim_s {
+  int32_t cible;
+  int32_t rang;
+  int32_t economie;
+  unsigned char ecrit;
+  char mouvement;
+};
+
+/**
+* Structure de données d'une optimisation en cours.
+* t -> la table de la machine d'origine
+* n / k -> le nombre d'états et de symboles de la table
+* regles -> les transitions de travail (n * k)
+* garde -> 1 pour les états conservés, 0 pour les états retirés
+* classe -> la classe d'équivalence de chaque état conservé
+* representant -> classe -> l'état qui la représente dans le fichier
+* nb_classes -> le nombre de classes d'équivalence
+*/
+struct optimisation_s {
+  table_transitions t;
+  int n;
+  int k;
+  struct regle_optim_s *regles;
+  char *garde;
+  int32_t *classe;
+  int32_t *representant;
+  int nb_classes;
+};
+typedef struct optimisation_s* optimisation;
+
+// Etats d'une transition pendant la fusion des transitions '-'
+#define FUSION_EN_COURS 1
+#define FUSION_TRAITEE 2
+
+/**
+* Ligne du fichier écrit : la transition d'un représentant pour un
+* symbole lu
+*/
+struct ligne_optim_s {
+  int32_t rang;
+  int32_t etat;
+  int32_t code;
+};
+
+/**
+* Recopie les transitions de la table dans les transitions de travail.
+* Les transitions de l'état final, jamais appliquées, sont omises.
+*/
+static void lire_regles(optimisation o) {
+  table_transitions t = o->t;
+  for(int q = 0; q < o->n; q++) {
+    for(int a = 0; a < o->k; a++) {
+      struct regle_optim_s *rg = &o->regles[q * o->k + a];
+      int32_t i = table_chercher(t, q, t->symboles[a]);
+      rg->cible = -1;
+      if(i < 0 || q == t->etat_fin) continue;
+      rg->cible = t->regles[i].nouvel_etat;
+      rg->rang = t->regles[i].rang;
+      rg->economie = 0;
+      rg->ecrit = t->regles[i].symbole_ecrit;
+      rg->mouvement = t->regles[i].mouvement;
+    }
+  }
+}
+
+/**
+* Fusionne les transitions '-' : la transition appliquée après une
+* transition qui ne déplace pas la tête est connue (celle du nouvel état
+* pour le symbole écrit), la transition est donc remplacée par la
+* suivante, elle-même fusionnée au préalable. Les chaînes sont suivies
+* une seule fois : chaque transition est marquée en cours puis traitée.
+* Une chaîne qui revient sur elle-même (la machine boucle sur place) est
+* laissée telle quelle.
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int fusionner_immobiles(optimisation o) {
+  table_transitions t = o->t;
+  long nb = (long) o->n * o->k;
+  char *etats = (char*) calloc(nb + 1, 1);
+  long *chaine = (long*) malloc(sizeof(long) * (nb + 1));
+  if(!etats || !chaine) {
+    free(etats);
+    free(chaine);
+    return 0;
+  }
+  for(long e = 0; e < nb; e++) {
+    if(etats[e] == FUSION_TRAITEE) continue;
+    // Chaîne des transitions '-' qui suivent e, jusqu'à une transition
+    // déjà traitée ou qui n'est suivie d'aucune autre
+    long n = 0, suite = -1;
+    int boucle = 0;
+    for(long i = e; ; ) {
+      struct regle_optim_s *rg = &o->regles[i];
+      etats[i] = FUSION_EN_COURS;
+      chaine[n++] = i;
+      if(rg->cible < 0 || rg->mouvement != AUCUN || rg->cible == t->etat_fin)
+        break;
+      long j = (long) rg->cible * o->k + t->code_symbole[rg->ecrit];
+      if(o->regles[j].cible < 0) break;
+      if(etats[j] == FUSION_EN_COURS) {
+        boucle = 1;
+        break;
+      }
+      if(etats[j] == FUSION_TRAITEE) {
+        suite = j;
+        break;
+      }
+      i = j;
+    }
+    // Chaque transition de la chaîne est remplacée par la composition 
+    // des suivantes, de la dernière à la première
+    while(n > 0) {
+      struct regle_optim_s *rg = &o->regles[chaine[--n]];
+      etats[chaine[n]] = FUSION_TRAITEE;
+      if(!boucle && suite >= 0) {
+        struct regle_optim_s *s = &o->regles[suite];
+        rg->economie = 1 + s->economie;
+        rg->cible = s->cible;
+        rg->ecrit = s->ecrit;
+        rg->mouvement = s->mouvement;
+      }
+      suite = chaine[n];
+    }
+  }
+  free(etats);
+  free(chaine);
+  return 1;
+}
+
+/**
+* Marque les états qui peuvent atteindre l'état final (parcours en
+* largeur des prédécesseurs depuis l'état final)
+* @param vivant : 1 pour les états qui peuvent atteindre l'état final
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int marquer_vivants(optimisation o, char *vivant) {
+  long nb = (long) o->n * o->k;
+  uint32_t *debuts = (uint32_t*) calloc(o->n + 1, sizeof(uint32_t));
+  uint32_t *positions = (uint32_t*) malloc(sizeof(uint32_t) * (o->n + 1));
+  int32_t *predecesseurs = (int32_t*) malloc(sizeof(int32_t) * (nb + 1));
+  int32_t *file = (int32_t*) malloc(sizeof(int32_t) * o->n);
+  if(!debuts || !positions || !predecesseurs || !file) {
+    free(debuts);
+    free(positions);
+    free(predecesseurs);
+    free(file);
+    return 0;
+  }
+  // Prédécesseurs de chaque état, rangés par état cible
+  for(long e = 0; e < nb; e++)
+    if(o->regles[e].cible >= 0) debuts[o->regles[e].cible + 1]++;
+  for(int q = 0; q < o->n; q++) debuts[q + 1] += debuts[q];
+  memcpy(positions, debuts, sizeof(uint32_t) * (o->n + 1));
+  for(long e = 0; e < nb; e++)
+    if(o->regles[e].cible >= 0)
+      predecesseurs[positions[o->regles[e].cible]++] = (int32_t) (e / o->k);
+
+  int debut = 0, fin = 0;
+  memset(vivant, 0, o->n);
+  vivant[o->t->etat_fin] = 1;
+  file[fin++] = o->t->etat_fin;
+  while(debut < fin) {
+    int q = file[debut++];
+    for(uint32_t i = debuts[q]; i < debuts[q + 1]; i++) {
+      int p = predecesseurs[i];
+      if(!vivant[p]) {
+        vivant[p] = 1;
+        file[fin++] = p;
+      }
+    }
+  }
+  free(debuts);
+  free(positions);
+  free(predecesseurs);
+  free(file);
+  return 1;
+}
+
+/**
+* Retire les transitions vers les états sans issue et marque les états
+* accessibles depuis l'état initial par les transitions restantes
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int elaguer(optimisation o, rapport_optimisation r) {
+  char *vivant = (char*) malloc(o->n);
+  int32_t *file = (int32_t*) malloc(sizeof(int32_t) * o->n);
+  if(!vivant || !file || !marquer_vivants(o, vivant)) {
+    free(vivant);
+    free(file);
+    return 0;
+  }
+  int debut = 0, fin = 0;
+  memset(o->garde, 0, o->n);
+  o->garde[o->t->etat_in] = 1;
+  file[fin++] = o->t->etat_in;
+  while(debut < fin) {
+    int q = file[debut++];
+    for(int a = 0; a < o->k; a++) {
+      struct regle_optim_s *rg = &o->regles[q * o->k + a];
+      if(rg->cible < 0) continue;
+      if(!vivant[rg->cible]) {
+        rg->cible = -1;
+        r->regles_sans_issue++;
+      } else if(!o->garde[rg->cible]) {
+        o->garde[rg->cible] = 1;
+        file[fin++] = rg->cible;
+      }
+    }
+  }
+  for(int q = 0; q < o->n; q++) {
+    if(o->garde[q]) continue;
+    if(vivant[q]) r->inaccessibles++;
+    else r->sans_issue++;
+  }
+  free(vivant);
+  free(file);
+  return 1;
+}
+
+/**
+* Partition initiale des états conservés : deux états sont dans la même
+* classe s'ils sont tous deux finaux ou non, et si pour chaque symbole lu
+* ils écrivent le même symbole et font le même déplacement (ou n'ont
+* tous deux pas de transition)
+* @return le nombre de classes, -1 en cas d'erreur d'allocation
+*/
+static int partition_initiale(optimisation o, int nb_gardes) {
+  int L = 1 + 2 * o->k, taille = 1, nb_classes = 0;
+  while(taille < 2 * nb_gardes) taille *= 2;
+  int32_t *signatures = (int32_t*) malloc(sizeof(int32_t) * L * o->n);
+  int32_t *index = (int32_t*) malloc(sizeof(int32_t) * taille);
+  if(!signatures || !index) {
+    free(signatures);
+    free(index);
+    return -1;
+  }
+  memset(index, -1, sizeof(int32_t) * taille);
+  for(int q = 0; q < o->n; q++) {
+    o->classe[q] = -1;
+    if(!o->garde[q]) continue;
+    int32_t *s = signatures + (long) q * L;
+    s[0] = q == o->t->etat_fin;
+    for(int a = 0; a < o->k; a++) {
+      struct regle_optim_s *rg = &o->regles[q * o->k + a];
+      s[1 + 2*a] = rg->cible < 0 ? -1 : rg->ecrit;
+      s[2 + 2*a] = rg->cible < 0 ? -1 : rg->mouvement;
+    }
+    int i = (int) (hachage_fnv1a(FNV1A_BASE, s, sizeof(int32_t) * L)
+                   & (taille - 1));
+    while(index[i] >= 0
+          && memcmp(signatures + (long) index[i] * L, s, sizeof(int32_t) * L))
+      i = (i + 1) & (taille - 1);
+    if(index[i] < 0) {
+      index[i] = q;
+      o->classe[q] = nb_classes++;
+    } else {
+      o->classe[q] = o->classe[index[i]];
+    }
+  }
+  free(signatures);
+  free(index);
+  return nb_classes;
+}
+
+/**
+* Fusionne les états équivalents (algorithme de Hopcroft) : les classes
+* de la partition initiale sont séparées jusqu'à ce que, dans chaque
+* classe, les états aillent pour chaque symbole lu dans la même classe.
+* Un couple (classe, symbole) en attente sépare les classes de ses
+* prédécesseurs ; lorsqu'une classe est séparée, seule la plus petite
+* partie est mise en attente, pour tous les symboles, ce qui borne le
+* travail à O(k n log n). Toutes les classes initiales sont en attente
+* au départ, les transitions pouvant être absentes.
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int minimiser(optimisation o) {
+  int n = o->n, k = o->k, m = 0;
+  for(int q = 0; q < n; q++) m += o->garde[q];
+  int nb_classes = partition_initiale(o, m);
+  if(nb_classes < 0) return 0;
+
+  // Les états de chaque classe sont contigus dans elements, de 
+  // debuts[c] à fins[c] - 1 ; les prédécesseurs de (état, symbole) 
+  // sont rangés de debuts_pred[e] à debuts_pred[e+1] - 1
+  long nb = (long) n * k, nb_aretes = 0;
+  int32_t *elements = (int32_t*) malloc(sizeof(int32_t) * m);
+  int32_t *positions = (int32_t*) malloc(sizeof(int32_t) * n);
+  int32_t *debuts = (int32_t*) calloc(m + 1, sizeof(int32_t));
+  int32_t *fins = (int32_t*) malloc(sizeof(int32_t) * (m + 1));
+  int32_t *marques = (int32_t*) calloc(m, sizeof(int32_t));
+  int32_t *touchees = (int32_t*) malloc(sizeof(int32_t) * m);
+  uint32_t *debuts_pred = (uint32_t*) calloc(nb + 1, sizeof(uint32_t));
+  int32_t *attente = (int32_t*) malloc(sizeof(int32_t) * ((long) m * k + 1));
+  for(long e = 0; debuts_pred && e < nb; e++)
+    if(o->garde[e / k] && o->regles[e].cible >= 0) nb_aretes++;
+  int32_t *predecesseurs = (int32_t*) malloc(sizeof(int32_t) 
+                                             * (nb_aretes + 1));
+  int32_t *separateurs = (int32_t*) malloc(sizeof(int32_t) 
+                                           * (nb_aretes + 1));
+  int ok = elements && positions && debuts && fins && marques && touchees
+           && debuts_pred && attente && predecesseurs && separateurs;
+  if(ok) {
+    for(int q = 0; q < n; q++)
+      if(o->garde[q]) debuts[o->classe[q] + 1]++;
+    for(int c = 0; c < nb_classes; c++) debuts[c + 1] += debuts[c];
+    memcpy(fins, debuts, sizeof(int32_t) * (nb_classes + 1));
+    for(int q = 0; q < n; q++) {
+      if(!o->garde[q]) continue;
+      positions[q] = fins[o->classe[q]]++;
+      elements[positions[q]] = q;
+    }
+    for(long e = 0; e < nb; e++) {
+      struct regle_optim_s *rg = &o->regles[e];
+      if(o->garde[e / k] && rg->cible >= 0) 
+        debuts_pred[(long) rg->cible * k + e % k + 1]++;
+    }
+    for(long e = 0; e < nb; e++) debuts_pred[e + 1] += debuts_pred[e];
+    for(long e = 0; e < nb; e++) {
+      struct regle_optim_s *rg = &o->regles[e];
+      if(o->garde[e / k] && rg->cible >= 0) 
+        predecesseurs[debuts_pred[(long) rg->cible * k + e % k]++] = 
+          (int32_t) (e / k);
+    }
+    // Le remplissage a décalé chaque début sur le début suivant
+    for(long e = nb; e > 0; e--) debuts_pred[e] = debuts_pred[e - 1];
+    debuts_pred[0] = 0;
+
+    long nb_attente = 0;
+    for(int c = 0; c < nb_classes; c++)
+      for(int a = 0; a < k; a++) attente[nb_attente++] = c * k + a;
+    while(nb_attente > 0) {
+      int32_t paire = attente[--nb_attente];
+      int b = paire / k, a = paire % k;
+      // Etats qui vont dans la classe b en lisant a : chacun n'a qu'une
+      // transition pour a, il n'apparaît qu'une fois
+      long nb_separateurs = 0;
+      for(int i = debuts[b]; i < fins[b]; i++) {
+        long e = (long) elements[i] * k + a;
+        for(uint32_t j = debuts_pred[e]; j < debuts_pred[e + 1]; j++)
+          separateurs[nb_separateurs++] = predecesseurs[j];
+      }
+      // Les états marqués sont rangés en tête de leur classe
+      int nb_touchees = 0;
+      for(long i = 0; i < nb_separateurs; i++) {
+        int p = separateurs[i], c = o->classe[p];
+        if(!marques[c]) touchees[nb_touchees++] = c;
+        int j = debuts[c] + marques[c]++, q = elements[j];
+        elements[j] = p;
+        elements[positions[p]] = q;
+        positions[q] = positions[p];
+        positions[p] = j;
+      }
+      for(int i = 0; i < nb_touchees; i++) {
+        int c = touchees[i], milieu = debuts[c] + marques[c];
+        marques[c] = 0;
+        if(milieu == fins[c]) continue;
+        // La plus petite partie devient la nouvelle classe
+        int nouvelle = nb_classes++;
+        if(milieu - debuts[c] <= fins[c] - milieu) {
+          debuts[nouvelle] = debuts[c];
+          fins[nouvelle] = milieu;
+          debuts[c] = milieu;
+        } else {
+          debuts[nouvelle] = milieu;
+          fins[nouvelle] = fins[c];
+          fins[c] = milieu;
+        }
+        for(int j = debuts[nouvelle]; j < fins[nouvelle]; j++)
+          o->classe[elements[j]] = nouvelle;
+        for(int a2 = 0; a2 < k; a2++) 
+          attente[nb_attente++] = nouvelle * k + a2;
+      }
+    }
+  }
+  free(elements);
+  free(positions);
+  free(debuts);
+  free(fins);
+  free(marques);
+  free(touchees);
+  free(debuts_pred);
+  free(attente);
+  free(predecesseurs);
+  free(separateurs);
+  if(!ok) return 0;
+
+  o->nb_classes = nb_classes;
+  o->representant = (int32_t*) malloc(sizeof(int32_t) * nb_classes);
+  if(!o->representant) return 0;
+  for(int c = 0; c < nb_classes; c++) o->representant[c] = -1;
+  for(int q = 0; q < n; q++)
+    if(o->garde[q] && o->representant[o->classe[q]] < 0)
+      o->representant[o->classe[q]] = q;
+  // La classe de l'état initial garde son nom
+  o->representant[o->classe[o->t->etat_in]] = o->t->etat_in;
+  return 1;
+}
+
+/**
+* Compare deux lignes du fichier écrit selon le rang de leur transition
+* d'origine
+*/
+static int comparer_lignes(const void *a, const void *b) {
+  const struct ligne_optim_s *x = (const struct ligne_optim_s*) a;
+  const struct ligne_optim_s *y = (const struct ligne_optim_s*) b;
+  if(x->rang != y->rang) return x->rang < y->rang ? -1 : 1;
+  if(x->etat != y->etat) return x->etat < y->etat ? -1 : 1;
+  return x->code - y->code;
+}
+
+/**
+* Ecrit la machine optimisée au format texte : les transitions des
+* représentants des classes, dans l'ordre des transitions d'origine. Les
+* transitions fusionnées sont comptées parmi celles écrites.
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int ecrire_optimisation(optimisation o, const char *sortie,
+                               rapport_optimisation r) {
+  table_transitions t = o->t;
+  struct ligne_optim_s *lignes = (struct ligne_optim_s*)
+    malloc(sizeof(struct ligne_optim_s) * ((long) o->nb_classes * o->k + 1));
+  if(!lignes) {
+    perror("Erreur d'allocation de la mémoire de l'optimisation.\n");
+    return 0;
+  }
+  int nb = 0;
+  for(int c = 0; c < o->nb_classes; c++) {
+    int q = o->representant[c];
+    for(int a = 0; a < o->k; a++) {
+      if(o->regles[q * o->k + a].cible < 0) continue;
+      lignes[nb].rang = o->regles[q * o->k + a].rang;
+      lignes[nb].etat = q;
+      lignes[nb++].code = a;
+    }
+  }
+  qsort(lignes, nb, sizeof(*lignes), comparer_lignes);
+
+  FILE *F;
+  if((F = fopen(sortie, "w")) == NULL) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", sortie);
+    perror("\n\n");
+    free(lignes);
+    return 0;
+  }
+  fprintf(F, "init: %s\n", table_nom_etat(t, t->etat_in));
+  fprintf(F, "accept: %s\n\n", table_nom_etat(t, t->etat_fin));
+  for(int i = 0; i < nb; i++) {
+    struct regle_optim_s *rg =
+      &o->regles[lignes[i].etat * o->k + lignes[i].code];
+    fprintf(F, "%s,%c,%s,%c,%c\n", table_nom_etat(t, lignes[i].etat),
+            t->symboles[lignes[i].code],
+            table_nom_etat(t, o->representant[o->classe[rg->cible]]),
+            rg->ecrit, rg->mouvement);
+    if(rg->economie) {
+      r->transitions_fusionnees++;
+      r->etapes_fusionnees += rg->economie;
+    }
+  }
+  free(lignes);
+  if(fclose(F) != 0) {
+    fprintf(stderr, "\n[ERR]: Echec de l'écriture du fichier %s", sortie);
+    perror("\n\n");
+    return 0;
+  }
+  r->regles_apres = nb;
+  return 1;
+}
+
+int optimiser_machine(MT mt, const char *sortie, rapport_optimisation r) {
+  table_transitions t = mt->table;
+  if(t->nb_conflits) {
+    fprintf(stderr, "\n[ERR]: L'optimisation ne s'applique qu'aux "
+            "machines déterministes (%d couples (état, symbole) ont "
+            "plusieurs transitions)\n\n", t->nb_conflits);
+    return 0;
+  }
+  memset(r, 0, sizeof(*r));
+  r->etats_avant = t->nb_etats;
+  r->regles_avant = t->nb_regles;
+
+  struct optimisation_s o;
+  memset(&o, 0, sizeof(o));
+  o.t = t;
+  o.n = t->nb_etats;
+  o.k = t->nb_symboles;
+  o.regles = (struct regle_optim_s*) malloc(sizeof(struct regle_optim_s)
+                                             * ((long) o.n * o.k + 1));
+  o.garde = (char*) malloc(o.n);
+  o.classe = (int32_t*) malloc(sizeof(int32_t) * o.n);
+  int ok = o.regles && o.garde && o.classe;
+  if(ok) {
+    lire_regles(&o);
+    ok = fusionner_immobiles(&o) && elaguer(&o, r) && minimiser(&o);
+  }
+  if(!ok) perror("Erreur d'allocation de la mémoire de l'optimisation.\n");
+  else ok = ecrire_optimisation(&o, sortie, r);
+  if(ok) {
+    r->etats_apres = o.nb_classes;
+    r->fusionnes = o.n - r->inaccessibles - r->sans_issue - o.nb_classes;
+  }
+  free(o.regles);
+  free(o.garde);
+  free(o.classe);
+  free(o.representant);
+  return ok;
+}
+
+void afficher_rapport_optimisation(rapport_optimisation r, FILE *sortie) {
+  fprintf(sortie, "[OPTIM]: états : %d -> %d (%d inaccessibles, %d sans "
+          "issue, %d équivalents à un autre état)\n", r->etats_avant,
+          r->etats_apres, r->inaccessibles, r->sans_issue, r->fusionnes);
+  fprintf(sortie, "[OPTIM]: transitions : %d -> %d (%d vers un état sans "
+          "issue, %d transitions '-' fusionnées, %ld étapes en moins à "
+          "leurs passages)\n", r->regles_avant, r->regles_apres,
+          r->regles_sans_issue, r->transitions_fusionnees,
+          r->etapes_fusionnees);
+}
+
+int comparer_machines(MT origine, MT optimisee, FILE *mots, limites l,
+                      FILE *sortie) {
+  configuration c[2] = { NULL, NULL };
+  MT machines[2] = { origine, optimisee };
+  long etapes[2] = { 0, 0 }, nb_mots = 0, differents = 0;
+  char *mot = NULL;
+  size_t taille = 0;
+  ssize_t lu;
+  int ok = 1;
+  while(ok && (lu = getline(&mot, &taille, mots)) != -1) {
+    while(lu > 0 && (mot[lu-1] == '\n' || mot[lu-1] == '\r'))
+      mot[--lu] = '\0';
+    int res[2];
+    for(int i = 0; i < 2 && ok; i++) {
+      // La configuration (et son ruban) est réutilisée d'un mot à l'autre
+      if(!c[i]) ok = (c[i] = init_configuration(machines[i], mot)) != NULL;
+      else ok = reinitialiser_configuration(c[i], mot);
+      if(!ok) break;
+      res[i] = executer(c[i], l);
+      etapes[i] += c[i]->nb_etapes;
+    }
+    if(!ok) break;
+    nb_mots++;
+    if(res[0] != res[1]) {
+      differents++;
+      fprintf(sortie, "[OPTIM]: '%s' : %s en %ld étapes -> %s en %ld "
+              "étapes\n", mot, libelle_resultat(res[0]), c[0]->nb_etapes,
+              libelle_resultat(res[1]), c[1]->nb_etapes);
+    }
+  }
+  if(ok)
+    fprintf(sortie, "[OPTIM]: %ld mots : %ld étapes -> %ld étapes (%.1f %%),"
+            " %ld résultats différents\n", nb_mots, etapes[0], etapes[1],
+            etapes[0] ? 100.0 * (etapes[1] - etapes[0]) / etapes[0] : 0.0,
+            differents);
+  free(mot);
+  free_configuration(c[0]);
+  free_configuration(c[1]);
+  return ok;
+}
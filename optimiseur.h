@@ -0,0 +1,84 @@
+#ifndef _optimiseur_h_
+#define _optimiseur_h_
+
+#include <stdio.h>
+
+#include "machineturing.h"
+
+/**
+* Réductions obtenues par l'optimisation d'une machine.
+* etats_avant / etats_apres -> le nombre d'états de la machine d'origine
+*                              et de la machine optimisée
+* regles_avant / regles_apres -> le nombre de transitions
+* inaccessibles -> les états retirés car inaccessibles depuis l'état
+*                  initial
+* sans_issue -> les états retirés car ils ne peuvent pas atteindre l'état
+*               final
+* regles_sans_issue -> les transitions retirées car elles mènent à un
+*                      état sans issue (la machine refuse alors un pas
+*                      plus tôt)
+* fusionnes -> les états retirés car équivalents à un autre état
+* transitions_fusionnees -> les transitions '-' remplacées par la
+*                           transition qui les suit
+* etapes_fusionnees -> le nombre total d'étapes retirées par ces
+*                      fusions, à chaque passage par les transitions
+*/
+struct rapport_optimisation_s {
+  int etats_avant;
+  int etats_apres;
+  int regles_avant;
+  int regles_apres;
+  int inaccessibles;
+  int sans_issue;
+  int regles_sans_issue;
+  int fusionnes;
+  int transitions_fusionnees;
+  long etapes_fusionnees;
+};
+typedef struct rapport_optimisation_s* rapport_optimisation;
+
+/**
+* Optimise une machine déterministe à partir de sa table compilée et
+* écrit la machine optimisée au format texte. Les passes sont, dans
+* l'ordre :
+* - la fusion des transitions '-' : une transition qui ne déplace pas la
+*   tête est suivie d'une transition connue (celle du nouvel état pour
+*   le symbole écrit), elle est remplacée par leur composition ;
+* - le retrait des transitions vers les états qui ne peuvent pas
+*   atteindre l'état final : la machine refuse dès qu'elle les prendrait
+*   au lieu de continuer (ou de ne jamais s'arrêter) ;
+* - le retrait des états inaccessibles depuis l'état initial ;
+* - la fusion des états équivalents (même comportement sur tout ruban),
+*   par l'algorithme de Hopcroft.
+* Les résultats ACCEPTE sont conservés, avec au plus autant d'étapes ;
+* une exécution qui ne peut plus accepter est refusée plus tôt.
+* @param mt : la machine, non modifiée
+* @param sortie : le fichier de la machine optimisée
+* @param r : les réductions obtenues
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int optimiser_machine(MT mt, const char *sortie, rapport_optimisation r);
+
+/**
+* Affiche les réductions obtenues par l'optimisation d'une machine
+* @param r : les réductions
+* @param sortie : le flux où les afficher
+*/
+void afficher_rapport_optimisation(rapport_optimisation r, FILE *sortie);
+
+/**
+* Exécute une machine et sa version optimisée sur les mots d'un fichier
+* (un mot par ligne) et affiche le nombre total d'étapes de chacune,
+* ainsi que les mots dont le résultat diffère
+* @param origine : la machine d'origine
+* @param optimisee : la machine optimisée
+* @param mots : le fichier des mots
+* @param l : les limites de chaque exécution
+* @param sortie : le flux où afficher la comparaison
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int comparer_machines(MT origine, MT optimisee, FILE *mots, limites l,
+                      FILE *sortie);
+
+
+#endif
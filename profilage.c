@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "profilage.h"
+
+profilage init_profil(configuration c, FILE *sortie) {
+  table_transitions t = c->mt->table;
+  profilage p = (profilage) calloc(1, sizeof(struct profilage_s));
+  if(!p
+     || !(p->passages_regles = (uint64_t*) calloc(t->nb_regles + 1,
+                                                  sizeof(uint64_t)))
+     || !(p->etapes_etats = (uint64_t*) calloc(t->nb_etats,
+                                               sizeof(uint64_t)))) {
+    perror("Erreur d'allocation de la mémoire du profil.\n");
+    free_profil(p);
+    return NULL;
+  }
+  p->table = t;
+  p->tete_depart = p->tete_min = p->tete_max = c->tete_lecture;
+  p->cases_allouees = c->ruban_courant->capacite;
+  p->sortie = sortie;
+  return p;
+}
+
+/**
+* Ecrit une chaine entre guillemets en échappant les caractères
+* spéciaux du JSON
+* @param f : le flux de sortie
+* @param s : la chaine à écrire
+* @param n : la longueur de la chaine
+*/
+static void ecrire_chaine(FILE *f, const char *s, size_t n) {
+  fputc('"', f);
+  for(size_t i = 0; i < n; i++) {
+    unsigned char u = (unsigned char) s[i];
+    if(u == '"' || u == '\\') fprintf(f, "\\%c", u);
+    else if(u < 0x20) fprintf(f, "\\u%04x", u);
+    else fputc(u, f);
+  }
+  fputc('"', f);
+}
+
+/**
+* Ecrit le nom d'un état entre guillemets
+*/
+static void ecrire_etat(FILE *f, table_transitions t, int etat) {
+  const char *nom = table_nom_etat(t, etat);
+  ecrire_chaine(f, nom, strlen(nom));
+}
+
+int ecrire_profil(profilage p, configuration c, int resultat) {
+  table_transitions t = p->table;
+  FILE *f = p->sortie;
+  ruban r = c->ruban_courant;
+  long cases = r->capacite > p->cases_allouees ? r->capacite
+                                               : p->cases_allouees;
+
+  fprintf(f, "{\"resultat\":\"%s\",\"etapes\":%ld,",
+          libelle_resultat(resultat), c->nb_etapes);
+  fprintf(f, "\"tete\":{\"min\":%ld,\"max\":%ld,\"retournements\":%ld},",
+          p->tete_min - p->tete_depart, p->tete_max - p->tete_depart,
+          p->retournements);
+  fprintf(f, "\"ruban\":{\"longueur\":%ld,\"cases_allouees\":%ld},",
+          r->max - r->min + 1, cases);
+
+  // Carte des états : nombre d'étapes et part des étapes de chaque état
+  fprintf(f, "\"etats\":[");
+  for(int e = 0; e < t->nb_etats; e++) {
+    fprintf(f, "%s{\"etat\":", e ? "," : "");
+    ecrire_etat(f, t, e);
+    fprintf(f, ",\"etapes\":%llu,\"part\":%.6f}",
+            (unsigned long long) p->etapes_etats[e], c->nb_etapes > 0
+            ? (double) p->etapes_etats[e] / c->nb_etapes : 0.0);
+  }
+
+  // Transitions groupées par état puis par symbole lu, comme dans
+  // afficher_table_transitions()
+  fprintf(f, "],\"transitions\":[");
+  int premiere = 1;
+  for(int e = 0; e < t->nb_etats; e++) {
+    for(int code = 0; code < t->nb_symboles; code++) {
+      int32_t i = table_chercher(t, e, t->symboles[code]);
+      if(i < 0) continue;
+      for(int j = i; j < i + t->regles[i].nb_alternatives; j++) {
+        regle rg = &t->regles[j];
+        char lu = (char) t->symboles[code], ecrit = (char) rg->symbole_ecrit;
+        fprintf(f, "%s{\"etat\":", premiere ? "" : ",");
+        ecrire_etat(f, t, e);
+        fprintf(f, ",\"lu\":");
+        ecrire_chaine(f, &lu, 1);
+        fprintf(f, ",\"ecrit\":");
+        ecrire_chaine(f, &ecrit, 1);
+        fprintf(f, ",\"mouvement\":\"%c\",\"nouvel_etat\":", rg->mouvement);
+        ecrire_etat(f, t, rg->nouvel_etat);
+        fprintf(f, ",\"rang\":%d,\"passages\":%llu}", rg->rang,
+                (unsigned long long) p->passages_regles[rg->rang]);
+        premiere = 0;
+      }
+    }
+  }
+  fprintf(f, "]}\n");
+  if(fflush(f) == EOF || ferror(f)) {
+    perror("\n[ERR]: Echec de l'écriture du profil");
+    return 0;
+  }
+  return 1;
+}
+
+void free_profil(profilage p) {
+  if(!p) return;
+  free(p->passages_regles);
+  free(p->etapes_etats);
+  free(p);
+}
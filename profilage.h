@@ -0,0 +1,95 @@
+#ifndef _profilage_h_
+#define _profilage_h_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "machineturing.h"
+
+/**
+* Profil d'une exécution avec la table des transitions : compteurs
+* relevés à chaque étape par simuler_turing() lorsqu'un profil lui est
+* passé. Sans profil, la boucle d'exécution n'est pas modifiée.
+* table -> la table des transitions de la machine profilée
+* passages_regles -> rang d'une transition (position dans la liste des
+*                    transitions, cf. struct regle_s) -> nombre de fois
+*                    où elle a été appliquée
+* etapes_etats -> identifiant d'un état -> nombre d'étapes exécutées
+*                 dans cet état
+* tete_depart -> la position de la tête au début de l'exécution
+* tete_min / tete_max -> les positions extrêmes atteintes par la tête
+* retournements -> le nombre de changements de direction de la tête
+*                  (les transitions '-' ne changent pas la direction)
+* dernier_deplacement -> le dernier déplacement non nul de la tête
+* cases_allouees -> le nombre maximal de cases allouées du ruban
+* sortie -> le flux où écrire le profil en JSON (ecrire_profil())
+*/
+struct profilage_s {
+  table_transitions table;
+  uint64_t *passages_regles;
+  uint64_t *etapes_etats;
+  long tete_depart;
+  long tete_min;
+  long tete_max;
+  long retournements;
+  int dernier_deplacement;
+  long cases_allouees;
+  FILE *sortie;
+};
+typedef struct profilage_s* profilage;
+
+/**
+* Crée un profil vide pour l'exécution d'une configuration
+* @param c : la configuration de départ de l'exécution
+* @param sortie : le flux où écrire le profil en fin d'exécution
+* @return le profil, NULL en cas d'erreur d'allocation
+*/
+profilage init_profil(configuration c, FILE *sortie);
+
+/**
+* Relève l'étape qu'une configuration va exécuter : la transition
+* appliquée, l'état courant et le déplacement de la tête. Appelée avant
+* simuler_etape(), rien n'est compté si la machine ne peut pas avancer.
+* @param p : le profil
+* @param c : la configuration, avant l'étape
+*/
+static inline void profil_etape(profilage p, configuration c) {
+  ruban r = c->ruban_courant;
+  int32_t i = table_chercher(p->table, c->etat_courant,
+                             *ruban_case(r, c->tete_lecture));
+  if(i < 0) return;
+  regle rg = &p->table->regles[i];
+  p->passages_regles[rg->rang]++;
+  p->etapes_etats[c->etat_courant]++;
+  if(rg->deplacement) {
+    if(p->dernier_deplacement && rg->deplacement != p->dernier_deplacement)
+      p->retournements++;
+    p->dernier_deplacement = rg->deplacement;
+    long tete = c->tete_lecture + rg->deplacement;
+    if(tete < p->tete_min) p->tete_min = tete;
+    if(tete > p->tete_max) p->tete_max = tete;
+  }
+  if(r->capacite > p->cases_allouees) p->cases_allouees = r->capacite;
+}
+
+/**
+* Ecrit un profil en JSON dans son flux de sortie : résultat et nombre
+* d'étapes de l'exécution, positions extrêmes de la tête (relatives à sa
+* position de départ) et retournements, taille du ruban, nombre d'étapes
+* par état et nombre de passages par transition
+* @param p : le profil
+* @param c : la configuration finale de l'exécution
+* @param resultat : le résultat de l'exécution (enum resultat)
+* @return 1 en cas de succès, 0 en cas d'erreur d'écriture
+*/
+int ecrire_profil(profilage p, configuration c, int resultat);
+
+/**
+* Libère l'espace mémoire alloué pour un profil (le flux de sortie n'est
+* pas fermé)
+* @param p : le profil à désallouer
+*/
+void free_profil(profilage p);
+
+
+#endif
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "rle.h"
+
+// Nombre de plages allouées initialement pour une pile
+#define CAPACITE_PILE_MIN 64
+
+/**
+* Structure de données du moteur rle.
+* table -> la table des transitions de la machine
+* gauche -> les plages à gauche de la tête (cases min à tete-1)
+* droite -> les plages à droite de la tête (cases tete+1 à max)
+* courant -> le symbole de la case de la tête
+* symbole_blanc -> le symbole des cases au delà des piles
+* min / max -> les positions extrêmes visitées par la tête de lecture
+* nb_sauts -> le nombre de plages entières traversées en une fois
+* etapes_sauts -> le nombre d'étapes faites par ces traversées
+*/
+struct moteur_rle_s {
+  table_transitions table;
+  struct pile_plages_s gauche;
+  struct pile_plages_s droite;
+  cellule courant;
+  cellule symbole_blanc;
+  long min;
+  long max;
+  long nb_sauts;
+  long etapes_sauts;
+};
+typedef struct moteur_rle_s* moteur_rle;
+
+/**
+* Empile longueur cases d'un symbole, en les fusionnant avec la plage
+* du sommet si elle contient le même symbole
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int empiler(pile_plages p, cellule symbole, long longueur) {
+  if(p->nb > 0 && p->plages[p->nb - 1].symbole == symbole) {
+    p->plages[p->nb - 1].longueur += longueur;
+    return 1;
+  }
+  if(p->nb == p->capacite) {
+    long capacite = p->capacite ? p->capacite * 2 : CAPACITE_PILE_MIN;
+    struct plage_s *plages = (struct plage_s*) realloc(p->plages,
+                                        capacite * sizeof(struct plage_s));
+    if(!plages) return 0;
+    p->plages = plages;
+    p->capacite = capacite;
+  }
+  p->plages[p->nb].symbole = symbole;
+  p->plages[p->nb].longueur = longueur;
+  p->nb++;
+  return 1;
+}
+
+/**
+* Retire les k cases les plus proches de la tête d'une pile, les cases
+* au delà de la pile étant blanches
+* @param p : la pile
+* @param k : le nombre de cases à retirer (au moins 1)
+* @param blanc : le symbole blanc
+* @return le symbole de la k-ième case retirée
+*/
+static cellule retirer(pile_plages p, long k, cellule blanc) {
+  while(p->nb > 0) {
+    struct plage_s *sommet = &p->plages[p->nb - 1];
+    cellule symbole = sommet->symbole;
+    if(sommet->longueur > k) {
+      sommet->longueur -= k;
+      return symbole;
+    }
+    k -= sommet->longueur;
+    p->nb--;
+    if(k == 0) return symbole;
+  }
+  return blanc;
+}
+
+static void free_moteur_rle(moteur_rle m) {
+  if(!m) return;
+  free(m->gauche.plages);
+  free(m->droite.plages);
+  free(m);
+}
+
+/**
+* Crée le moteur rle d'une configuration en compressant son ruban
+* @return le moteur, NULL en cas d'erreur d'allocation
+*/
+static moteur_rle init_moteur_rle(configuration c) {
+  ruban r = c->ruban_courant;
+  long tete = c->tete_lecture;
+  moteur_rle m = (moteur_rle) calloc(1, sizeof(struct moteur_rle_s));
+  if(!m) return NULL;
+  m->table = c->mt->table;
+  m->symbole_blanc = r->symbole_blanc;
+  m->min = r->min;
+  m->max = r->max;
+  m->courant = *ruban_case(r, tete);
+  // Les sommets des piles sont les cases voisines de la tête
+  for(long p = r->min; p < tete; p++) {
+    if(!empiler(&m->gauche, *ruban_case(r, p), 1)) {
+      free_moteur_rle(m);
+      return NULL;
+    }
+  }
+  for(long p = r->max; p > tete; p--) {
+    if(!empiler(&m->droite, *ruban_case(r, p), 1)) {
+      free_moteur_rle(m);
+      return NULL;
+    }
+  }
+  return m;
+}
+
+/**
+* Recopie le ruban compressé dans le ruban d'une configuration
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static int recopier_ruban(moteur_rle m, ruban r, long tete) {
+  if(!ruban_etendre(r, m->min) || !ruban_etendre(r, m->max)) return 0;
+  long p = m->min;
+  for(long i = 0; i < m->gauche.nb; i++)
+    for(long j = 0; j < m->gauche.plages[i].longueur; j++)
+      *ruban_case(r, p++) = m->gauche.plages[i].symbole;
+  *ruban_case(r, tete) = m->courant;
+  p = tete + 1;
+  for(long i = m->droite.nb - 1; i >= 0; i--)
+    for(long j = 0; j < m->droite.plages[i].longueur; j++)
+      *ruban_case(r, p++) = m->droite.plages[i].symbole;
+  // Cases visitées au delà des plages : blanches
+  for(; p <= m->max; p++) *ruban_case(r, p) = m->symbole_blanc;
+  r->min = m->min;
+  r->max = m->max;
+  return 1;
+}
+
+/**
+* Nombre de cases consécutives du symbole x qui suivent la tête dans une
+* pile, LONG_MAX si elles vont jusqu'au bout du ruban (x blanc)
+*/
+static long longueur_plage(moteur_rle m, pile_plages p, cellule x) {
+  long longueur = 0;
+  if(p->nb > 0) {
+    if(p->plages[p->nb - 1].symbole != x) return 0;
+    longueur = p->plages[p->nb - 1].longueur;
+    if(p->nb > 1) return longueur;
+  }
+  return x == m->symbole_blanc ? LONG_MAX : longueur;
+}
+
+/**
+* Exécute la machine jusqu'à son arrêt ou jusqu'à une étape donnée
+* (tranche_moteur)
+* @param c : la configuration (état, position de la tête et nombre
+*            d'étapes), mise à jour
+* @param fin_tranche : l'étape à laquelle interrompre l'exécution
+* @param contexte : le moteur
+* @return 1 si la machine s'est arrêtée, 0 si fin_tranche est atteinte,
+*         -1 en cas d'erreur d'allocation
+*/
+static int executer_tranche(configuration c, long fin_tranche, 
+                            void *contexte) {
+  moteur_rle m = (moteur_rle) contexte;
+  table_transitions t = m->table;
+  int etat = c->etat_courant, fin = t->etat_fin, erreur = 0;
+  long tete = c->tete_lecture, n = c->nb_etapes;
+
+  while(etat != fin && n < fin_tranche) {
+    int32_t i = table_chercher(t, etat, m->courant);
+    if(i < 0) break;
+    regle rg = &t->regles[i];
+    int d = rg->deplacement;
+
+    if(rg->nouvel_etat == etat) {
+      // Boucle sur place sans changement : la machine n'avance plus
+      if(d == 0 && rg->symbole_ecrit == m->courant) {
+        n = fin_tranche;
+        break;
+      }
+      pile_plages devant = d > 0 ? &m->droite : &m->gauche;
+      pile_plages derriere = d > 0 ? &m->gauche : &m->droite;
+      long longueur = d ? longueur_plage(m, devant, m->courant) : 0;
+      if(longueur > 0) {
+        // La transition s'applique à la case de la tête puis à chaque
+        // case de la plage : k étapes, k cases écrites, la tête avance
+        // de k cases
+        long reste = fin_tranche - n;
+        long k = longueur >= reste ? reste : longueur + 1;
+        if(!empiler(derriere, rg->symbole_ecrit, k)) {
+          erreur = 1;
+          break;
+        }
+        m->courant = retirer(devant, k, m->symbole_blanc);
+        n += k;
+        tete += d * k;
+        if(tete > m->max) m->max = tete;
+        if(tete < m->min) m->min = tete;
+        m->nb_sauts++;
+        m->etapes_sauts += k;
+        continue;
+      }
+    }
+
+    // Etape simple
+    etat = rg->nouvel_etat;
+    n++;
+    if(d == 0) {
+      m->courant = rg->symbole_ecrit;
+      continue;
+    }
+    if(!empiler(d > 0 ? &m->gauche : &m->droite, rg->symbole_ecrit, 1)) {
+      erreur = 1;
+      break;
+    }
+    m->courant = retirer(d > 0 ? &m->droite : &m->gauche, 1,
+                         m->symbole_blanc);
+    tete += d;
+    if(tete > m->max) m->max = tete;
+    if(tete < m->min) m->min = tete;
+  }
+
+  c->etat_courant = etat;
+  c->tete_lecture = tete;
+  c->nb_etapes = n;
+  if(erreur) return -1;
+  return etat == fin || n < fin_tranche;
+}
+
+/**
+* Résultat de l'exécution (même calcul que resultat_configuration(),
+* le symbole sous la tête étant celui du ruban compressé ;
+* resultat_moteur)
+* @param limite_atteinte : 1 si l'exécution a été interrompue par une
+*                          limite, 0 si la machine s'est arrêtée
+* @param contexte : le moteur
+*/
+static int resultat_rle(configuration c, int limite_atteinte, 
+                        void *contexte) {
+  moteur_rle m = (moteur_rle) contexte;
+  if(c->etat_courant == m->table->etat_fin) return RESULTAT_ACCEPTE;
+  // La machine n'est limitée que si elle pouvait encore avancer
+  if(limite_atteinte
+     && table_chercher(m->table, c->etat_courant, m->courant) >= 0)
+    return RESULTAT_TIMEOUT;
+  return RESULTAT_REFUSE;
+}
+
+int executer_rle(configuration c, limites l, int recopier,
+                 FILE *statistiques) {
+  moteur_rle m = init_moteur_rle(c);
+  if(!m) {
+    perror("Erreur d'allocation de la mémoire du moteur rle.\n");
+    return -1;
+  }
+  int res = executer_tranches(c, l, executer_tranche, resultat_rle, m);
+  if(res < 0) {
+    perror("Erreur d'allocation de la mémoire du moteur rle.\n");
+    free_moteur_rle(m);
+    return -1;
+  }
+
+  if(statistiques)
+    fprintf(statistiques, "[RLE]: %ld plages, %ld cases visitées ; %ld "
+            "étapes sur %ld faites en %ld traversées de plages\n",
+            m->gauche.nb + m->droite.nb + 1, m->max - m->min + 1,
+            m->etapes_sauts, c->nb_etapes, m->nb_sauts);
+  if(recopier && !recopier_ruban(m, c->ruban_courant, c->tete_lecture)) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    res = -1;
+  }
+  free_moteur_rle(m);
+  return res;
+}
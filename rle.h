@@ -0,0 +1,59 @@
+#ifndef _rle_h_
+#define _rle_h_
+
+#include <stdio.h>
+
+#include "machineturing.h"
+
+/**
+* Plage du ruban compressé : longueur cases consécutives contenant le
+* même symbole
+*/
+struct plage_s {
+  long longueur;
+  cellule symbole;
+};
+
+/**
+* Pile de plages d'un côté de la tête de lecture ; le sommet est la
+* plage la plus proche de la tête.
+* plages -> les plages, de la plus éloignée à la plus proche de la tête
+* nb -> le nombre de plages
+* capacite -> le nombre de plages allouées
+*/
+struct pile_plages_s {
+  struct plage_s *plages;
+  long nb;
+  long capacite;
+};
+typedef struct pile_plages_s* pile_plages;
+
+/**
+* Exécute une machine avec le moteur rle : le ruban est compressé en
+* plages (symbole, longueur), rangées dans deux piles de part et
+* d'autre de la case de la tête. Lorsque la machine lit un symbole x
+* avec une transition qui boucle sur son état (q,x -> q,y,d), la
+* transition est appliquée en une seule fois à toute la plage de x qui
+* suit dans la direction d, et le nombre d'étapes augmente de la
+* longueur de la plage. Le nombre d'étapes, le résultat et le ruban
+* final sont les mêmes qu'avec executer(). Une boucle sans fin sur des
+* cases blanches (ou sur place) atteint directement la limite d'étapes.
+* @param c : la configuration de départ, mise à jour (état, position de
+*            la tête, nombre d'étapes et, si recopier, ruban)
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite par ce moteur), NULL pour ne pas
+*            limiter
+* @param recopier : 1 pour recopier le ruban compressé dans
+*                   c->ruban_courant à la fin de l'exécution, 0 pour ne
+*                   pas le faire (c->ruban_courant garde alors le ruban
+*                   de départ)
+* @param statistiques : flux où afficher le nombre de plages et
+*                       d'étapes faites par plage entière, NULL pour ne
+*                       rien afficher
+* @return le résultat de l'exécution (enum resultat), -1 en cas d'erreur
+*/
+int executer_rle(configuration c, limites l, int recopier,
+                 FILE *statistiques);
+
+
+#endif
@@ -4,69 +4,114 @@
 
 #include "ruban.h"
 
+// Nombre minimal de cases allouées pour un ruban
+#define CAPACITE_MINIMALE 64
 
-ruban init_case_ruban(char symbole) {
+
+ruban init_ruban(char *mot, char symbole_blanc) {
+  ruban r = (ruban) malloc(sizeof(struct ruban_s));
+  if(r == NULL) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    return NULL;
+  }
+  long longueur = strlen(mot);
+  // On laisse autant de place à gauche qu'à droite du mot d'entrée
+  r->capacite = CAPACITE_MINIMALE;
+  while(r->capacite < 2 * longueur) r->capacite *= 2;
+  r->origine = (r->capacite - longueur) / 2;
+  r->cases = (cellule*) malloc(r->capacite);
+  if(r->cases == NULL) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    free(r);
+    return NULL;
+  }
+  r->symbole_blanc = (cellule) symbole_blanc;
+  memset(r->cases, r->symbole_blanc, r->capacite);
+  memcpy(r->cases + r->origine, mot, longueur);
+  r->min = 0;
+  r->max = longueur > 0 ? longueur - 1 : 0;
+  return r;
+}
+
+int ruban_reinitialiser(ruban r, char *mot) {
+  // Seules les cases visitées ont pu être écrites
+  memset(ruban_case(r, r->min), r->symbole_blanc, r->max - r->min + 1);
+  long longueur = strlen(mot);
+  r->min = 0;
+  r->max = longueur > 0 ? longueur - 1 : 0;
+  if(!ruban_etendre(r, r->max)) return 0;
+  memcpy(ruban_case(r, 0), mot, longueur);
+  return 1;
+}
+
+ruban copier_ruban(ruban r) {
   ruban res = (ruban) malloc(sizeof(struct ruban_s));
   if(res == NULL) {
-    perror("Erreur d'allocation de la mémoire d'une case du ruban.\n");
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    return NULL;
+  }
+  *res = *r;
+  res->cases = (cellule*) malloc(r->capacite);
+  if(res->cases == NULL) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    free(res);
     return NULL;
   }
-  res->symbole = symbole;
-  res->droite = NULL;
-  res->gauche = NULL;
+  memcpy(res->cases, r->cases, r->capacite);
   return res;
 }
 
-ruban ruban_ajouter_gauche(ruban case_courante, char symbole) {
-  ruban c = init_case_ruban(symbole);
-  if(c == NULL) return NULL;
-  if(case_courante == NULL) case_courante = c;
-  else{
-    c->gauche = case_courante->gauche;
-    c->droite = case_courante;
-    if(case_courante->gauche != NULL) case_courante->gauche->droite = c;
-    case_courante->gauche = c;
-  }
-  return c;
+/**
+* Renvoie le symbole d'une position quelconque d'un ruban
+*/
+static cellule lire_case(ruban r, long position) {
+  if(position < r->min || position > r->max) return r->symbole_blanc;
+  return *ruban_case(r, position);
 }
 
-ruban ruban_ajouter_droite(ruban case_courante, char symbole) {
-  ruban c = init_case_ruban(symbole);
-  if(c == NULL) return NULL;
-  if(case_courante == NULL) case_courante = c;
-  else{
-    c->gauche = case_courante;
-    c->droite = case_courante->droite;
-    if(case_courante->droite != NULL) case_courante->droite->gauche = c;
-    case_courante->droite = c;
-  }
-  return c;
+int rubans_egaux(ruban a, ruban b) {
+  long debut = a->min < b->min ? a->min : b->min;
+  long fin = a->max > b->max ? a->max : b->max;
+  for(long p = debut; p <= fin; p++) 
+    if(lire_case(a, p) != lire_case(b, p)) return 0;
+  return 1;
 }
 
-ruban init_ruban(char *mot) {
-  if(strlen(mot) < 1) return NULL;
-  ruban r = init_case_ruban(mot[0]);
-  ruban cur = r;
-  for(int i = 1; i<strlen(mot); i++) {
-    cur = ruban_ajouter_droite(cur, mot[i]);
+int ruban_etendre(ruban r, long position) {
+  long indice = position + r->origine;
+  if(indice >= 0 && indice < r->capacite) return 1;
+  // On double la capacité du côté où le ruban doit être agrandi (au 
+  // moins de quoi atteindre la position), ce qui garantit un coût 
+  // amorti constant par case ajoutée
+  long ajout = r->capacite;
+  if(indice < 0 && -indice > ajout) ajout = -indice;
+  if(indice >= r->capacite && indice - r->capacite + 1 > ajout) 
+    ajout = indice - r->capacite + 1;
+  long capacite = r->capacite + ajout;
+  cellule *cases = (cellule*) malloc(capacite);
+  if(cases == NULL) {
+    perror("Erreur d'allocation de la mémoire du ruban.\n");
+    return 0;
   }
-  return r;
+  long decalage = indice < 0 ? ajout : 0;
+  memset(cases, r->symbole_blanc, capacite);
+  memcpy(cases + decalage, r->cases, r->capacite);
+  free(r->cases);
+  r->cases = cases;
+  r->capacite = capacite;
+  r->origine += decalage;
+  return 1;
 }
 
 void afficher_ruban(ruban r) {
-  // Affiche les symboles de chaque case du ruban
-  while(r != NULL) {
-    printf("| %c ", r->symbole);
-    r = r->droite;
-  }
+  // Affiche les symboles de chaque case visitée du ruban
+  for(long p = r->min; p <= r->max; p++)
+    printf("| %c ", *ruban_case(r, p));
   printf("|\n");
 }
 
 void free_ruban(ruban r) {
-  ruban next;
-  while(r != NULL) {
-    next = r->droite;
-    free(r);
-    r = next;
-  }
+  if(r == NULL) return;
+  free(r->cases);
+  free(r);
 }
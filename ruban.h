@@ -2,58 +2,111 @@
 #define _ruban_h_
 
 /**
-* Structure de données permettant de stcoker le ruban d'une machine de 
-* Turing. Le ruban de la machine est une liste doublement chainée de 
-* cases permettant l'écriture des symboles.
-* symbole -> le symbole contenu dans la case courante du ruban
-* gauche -> pointeur vers la case gauche de la case courante
-* droite -> pointeur vers la case droite de la case courante
+* Type d'une case du ruban : un symbole sur un octet
+*/
+typedef unsigned char cellule;
+
+/**
+* Structure de données permettant de stocker le ruban d'une machine de 
+* Turing. Le ruban est infini des deux côtés : il est stocké dans un 
+* tableau contigu de cases qui est agrandi (en doublant sa taille) du 
+* côté où la tête de lecture en sort. Une case est repérée par sa 
+* position, la position 0 étant la première case du mot d'entrée ; les 
+* positions peuvent être négatives.
+* cases -> le tableau des cases du ruban
+* capacite -> le nombre de cases allouées
+* origine -> l'indice dans cases de la position 0
+* min -> la position la plus à gauche visitée par la tête de lecture
+* max -> la position la plus à droite visitée par la tête de lecture
+* symbole_blanc -> le symbole des cases jamais écrites
 */
 struct ruban_s {
-  char symbole;
-  struct ruban_s* droite;
-  struct ruban_s* gauche;
+  cellule *cases;
+  long capacite;
+  long origine;
+  long min;
+  long max;
+  cellule symbole_blanc;
 };
 typedef struct ruban_s* ruban;
 
 
 /**
-* Initialise une case du ruban
-* @param symbole : le symbole contenu dans la case
-* @return la case créée et Initialisée
+* Initialise un ruban à partir d'un mot d'entrée. Le mot est écrit à 
+* partir de la position 0 ; un mot vide donne un ruban contenant 
+* une case blanche.
+* @param mot : le mot d'entrée
+* @param symbole_blanc : le symbole blanc (vide) du ruban
+* @return le ruban Initialisé, NULL en cas d'erreur
 */
-ruban init_case_ruban(char symbole);
+ruban init_ruban(char *mot, char symbole_blanc);
 
+/**
+* Remet un ruban à blanc et y écrit un nouveau mot d'entrée, en 
+* réutilisant le tableau des cases déjà alloué
+* @param r : le ruban à réinitialiser
+* @param mot : le nouveau mot d'entrée
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+int ruban_reinitialiser(ruban r, char *mot);
 
 /**
-* Ajoute une case à la gauche de la case courante du ruban
-* @param r : liste doublement chainée représentant le ruban
-* @param s : le symbole à ajouter au ruban
-* @return un pointeur vers la case du ruban ajoutée, NULL en cas d'erreur
+* Renvoie une copie d'un ruban
+* @param r : le ruban à copier
+* @return la copie, NULL en cas d'erreur
 */
-ruban ruban_ajouter_gauche(ruban case_courante, char symbole);
+ruban copier_ruban(ruban r);
 
 /**
-* Ajoute une case à la droite de la case courante du ruban
-* @param r : liste doublement chainée représentant le ruban
-* @param s : le symbole à ajouter au ruban
-* @return un pointeur vers la case du ruban ajoutée, NULL en cas 
-* d'erreur
+* Compare le contenu de deux rubans, les cases non visitées étant 
+* considérées comme blanches
+* @return 1 si les rubans ont le même contenu, 0 sinon
 */
-ruban ruban_ajouter_droite(ruban case_courante, char symbole);
+int rubans_egaux(ruban a, ruban b);
 
 /**
-* Initialise un ruban à partir d'un mot d'entrée
-* @param mot : le mot d'entrée
-* @return le ruban Initialisé
+* Agrandit le tableau des cases d'un ruban pour qu'il contienne une 
+* position donnée. Les nouvelles cases contiennent le symbole blanc.
+* @param r : le ruban à agrandir
+* @param position : la position qui doit être allouée
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
 */
-ruban init_ruban(char *mot);
+int ruban_etendre(ruban r, long position);
 
 /**
-* Affiche la configuration courante d'un ruban d'une machine de Turing
+* Renvoie un pointeur vers la case d'une position du ruban. La position
+* est supposée allouée (i.e. comprise entre r->min et r->max).
+*/
+static inline cellule* ruban_case(ruban r, long position) {
+  return r->cases + r->origine + position;
+}
+
+/**
+* Déplace la tête de lecture d'un ruban en l'agrandissant si nécessaire
+* @param r : le ruban
+* @param tete : la position de la tête de lecture, mise à jour
+* @param deplacement : le déplacement de la tête (+1, -1 ou 0)
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+static inline int ruban_deplacer(ruban r, long *tete, int deplacement) {
+  long position = *tete + deplacement;
+  if(position < r->min || position > r->max) {
+    if((position + r->origine < 0 || position + r->origine >= r->capacite)
+       && !ruban_etendre(r, position))
+      return 0;
+    if(position < r->min) r->min = position;
+    else r->max = position;
+  }
+  *tete = position;
+  return 1;
+}
+
+/**
+* Affiche les cases d'un ruban d'une machine de Turing, de la position
+* la plus à gauche à la position la plus à droite visitées
 * @param r : le ruban à afficher
 */
-void afficher_ruban(ruban case_courante);
+void afficher_ruban(ruban r);
 
 /**
 * Libère l'espace mémoire allouée pour un ruban
@@ -63,4 +116,3 @@ void free_ruban(ruban r);
 
 
 #endif
-
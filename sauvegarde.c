@@ -0,0 +1,428 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "hachage.h"
+#include "sauvegarde.h"
+
+// Taille des blocs lus pour hacher le fichier d'une machine
+#define TAILLE_BLOC_HACHAGE 65536
+// Nombre maximal d'octets d'une longueur de plage (64 bits, 7 par octet)
+#define MAX_OCTETS_LONGUEUR 10
+
+/**
+* Structure de données d'une sauvegarde. L'instantané à écrire est une
+* copie des cases visitées du ruban, faite par le thread de l'exécution
+* puis compressée et écrite par le thread de la sauvegarde.
+* fichier / temporaire -> le fichier des instantanés et le fichier où
+*                         chaque instantané est écrit avant d'être renommé
+* hachage_machine -> le hachage de la machine exécutée
+* intervalle -> le nombre de secondes entre deux instantanés
+* verrou / signal -> protègent l'instantané et réveillent les threads
+* thread -> le thread qui écrit les instantanés
+* pret -> 1 lorsqu'un instantané est copié et pas encore écrit
+* termine -> 1 lorsque le thread de la sauvegarde doit s'arrêter
+* cases / capacite -> la copie des cases du ruban et sa taille allouée
+* entete -> l'entête de l'instantané (nb_plages et hachage_plages sont
+*           calculés à l'écriture)
+* nb_ecrits -> le nombre d'instantanés écrits
+* taille_ecrite -> la taille du dernier instantané écrit
+* erreur -> 1 si l'écriture d'un instantané a échoué
+*/
+struct sauvegarde_s {
+  char *fichier;
+  char *temporaire;
+  uint64_t hachage_machine;
+  double intervalle;
+  pthread_mutex_t verrou;
+  pthread_cond_t signal;
+  pthread_t thread;
+  int pret;
+  int termine;
+  cellule *cases;
+  long capacite;
+  struct entete_sauvegarde_s entete;
+  long nb_ecrits;
+  long taille_ecrite;
+  int erreur;
+};
+
+// Signaux reçus pendant l'exécution, consultés entre deux tranches
+static volatile sig_atomic_t instantane_demande = 0;
+static volatile sig_atomic_t arret_demande = 0;
+
+static void recevoir_signal(int sig) {
+  if(sig == SIGUSR1) instantane_demande = 1;
+  else arret_demande = 1;
+}
+
+int hacher_machine(const char *path, const char *alphabets,
+                   char symbole_blanc, uint64_t *hachage) {
+  FILE *f = fopen(path, "rb");
+  if(!f) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture du fichier %s", path);
+    perror("\n\n");
+    return 0;
+  }
+  unsigned char *bloc = (unsigned char*) malloc(TAILLE_BLOC_HACHAGE);
+  if(!bloc) {
+    perror("Erreur d'allocation de la mémoire du hachage.\n");
+    fclose(f);
+    return 0;
+  }
+  uint64_t h = FNV1A_BASE;
+  size_t lu;
+  while((lu = fread(bloc, 1, TAILLE_BLOC_HACHAGE, f)) > 0)
+    h = hachage_fnv1a(h, bloc, lu);
+  int ok = !ferror(f);
+  free(bloc);
+  fclose(f);
+  h = hachage_fnv1a(h, alphabets, strlen(alphabets));
+  *hachage = hachage_fnv1a(h, &symbole_blanc, 1);
+  if(!ok) fprintf(stderr, "\n[ERR]: Echec de la lecture de %s\n\n", path);
+  return ok;
+}
+
+/**
+* Ecrit une plage (symbole puis longueur en entier de taille variable)
+* en mettant à jour le hachage des plages
+* @return 1 en cas de succès, 0 en cas d'erreur d'écriture
+*/
+static int ecrire_plage(FILE *f, cellule symbole, uint64_t longueur,
+                        uint64_t *h) {
+  unsigned char octets[1 + MAX_OCTETS_LONGUEUR];
+  int n = 0;
+  octets[n++] = symbole;
+  do {
+    octets[n] = longueur & 0x7F;
+    longueur >>= 7;
+    if(longueur) octets[n] |= 0x80;
+    n++;
+  } while(longueur);
+  *h = hachage_fnv1a(*h, octets, n);
+  return fwrite(octets, 1, n, f) == (size_t) n;
+}
+
+/**
+* Compresse et écrit l'instantané copié dans un fichier temporaire, qui
+* remplace ensuite le fichier des instantanés
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+static int ecrire_instantane(sauvegarde s) {
+  FILE *f = fopen(s->temporaire, "wb");
+  if(!f) {
+    fprintf(stderr, "\n[ERR]: Echec de la création de %s", s->temporaire);
+    perror("\n\n");
+    return 0;
+  }
+  struct entete_sauvegarde_s *e = &s->entete;
+  e->nb_plages = 0;
+  e->hachage_plages = FNV1A_BASE;
+  int ok = fwrite(e, sizeof(*e), 1, f) == 1;
+  long n = e->max - e->min + 1;
+  for(long i = 0; ok && i < n;) {
+    long j = i + 1;
+    while(j < n && s->cases[j] == s->cases[i]) j++;
+    ok = ecrire_plage(f, s->cases[i], j - i, &e->hachage_plages);
+    e->nb_plages++;
+    i = j;
+  }
+  // L'entête est réécrite avec le nombre et le hachage des plages
+  ok = ok && fflush(f) == 0;
+  s->taille_ecrite = ftell(f);
+  ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(e, sizeof(*e), 1, f) == 1
+       && fflush(f) == 0 && fsync(fileno(f)) == 0;
+  ok = fclose(f) == 0 && ok;
+  if(ok && rename(s->temporaire, s->fichier) == 0) return 1;
+  fprintf(stderr, "\n[ERR]: Echec de l'écriture de l'instantané %s",
+          s->fichier);
+  perror("\n\n");
+  remove(s->temporaire);
+  return 0;
+}
+
+/**
+* Fonction du thread de la sauvegarde : écrit chaque instantané copié,
+* jusqu'à l'arrêt de la sauvegarde
+*/
+static void* ecrivain(void *arg) {
+  sauvegarde s = (sauvegarde) arg;
+  pthread_mutex_lock(&s->verrou);
+  for(;;) {
+    while(!s->pret && !s->termine) pthread_cond_wait(&s->signal, &s->verrou);
+    if(!s->pret) break;
+    // La copie n'est pas modifiée tant que pret vaut 1 : elle est écrite
+    // sans garder le verrou
+    pthread_mutex_unlock(&s->verrou);
+    int ok = ecrire_instantane(s);
+    pthread_mutex_lock(&s->verrou);
+    if(ok) s->nb_ecrits++;
+    else s->erreur = 1;
+    s->pret = 0;
+    pthread_cond_broadcast(&s->signal);
+  }
+  pthread_mutex_unlock(&s->verrou);
+  return NULL;
+}
+
+sauvegarde init_sauvegarde(const char *fichier, uint64_t hachage_machine,
+                           double intervalle) {
+  sauvegarde s = (sauvegarde) calloc(1, sizeof(struct sauvegarde_s));
+  if(!s) {
+    perror("Erreur d'allocation de la mémoire de la sauvegarde.\n");
+    return NULL;
+  }
+  s->fichier = strdup(fichier);
+  s->temporaire = (char*) malloc(strlen(fichier) + 5);
+  if(!s->fichier || !s->temporaire) {
+    perror("Erreur d'allocation de la mémoire de la sauvegarde.\n");
+    free(s->fichier);
+    free(s->temporaire);
+    free(s);
+    return NULL;
+  }
+  sprintf(s->temporaire, "%s.tmp", fichier);
+  s->hachage_machine = hachage_machine;
+  s->intervalle = intervalle;
+  pthread_mutex_init(&s->verrou, NULL);
+  pthread_cond_init(&s->signal, NULL);
+
+  // Les signaux de la sauvegarde sont reçus par le thread de l'exécution
+  sigset_t signaux, anciens;
+  sigemptyset(&signaux);
+  sigaddset(&signaux, SIGUSR1);
+  sigaddset(&signaux, SIGTERM);
+  sigaddset(&signaux, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &signaux, &anciens);
+  int erreur = pthread_create(&s->thread, NULL, ecrivain, s);
+  pthread_sigmask(SIG_SETMASK, &anciens, NULL);
+  if(erreur) {
+    fprintf(stderr, "\n[ERR]: Echec de la création du thread de la "
+            "sauvegarde\n\n");
+    pthread_mutex_destroy(&s->verrou);
+    pthread_cond_destroy(&s->signal);
+    free(s->fichier);
+    free(s->temporaire);
+    free(s);
+    return NULL;
+  }
+  return s;
+}
+
+/**
+* Copie la configuration pour qu'elle soit écrite par le thread de la
+* sauvegarde
+* @param s : la sauvegarde
+* @param c : la configuration
+* @param attendre : 1 pour attendre la fin de l'écriture de l'instantané
+*                   précédent, 0 pour ne pas prendre d'instantané s'il
+*                   est encore en cours d'écriture
+* @return 1 si l'instantané est pris, 0 sinon
+*/
+static int prendre_instantane(sauvegarde s, configuration c, int attendre) {
+  ruban r = c->ruban_courant;
+  long n = r->max - r->min + 1;
+  pthread_mutex_lock(&s->verrou);
+  if(s->pret && !attendre) {
+    pthread_mutex_unlock(&s->verrou);
+    return 0;
+  }
+  while(s->pret) pthread_cond_wait(&s->signal, &s->verrou);
+  if(n > s->capacite) {
+    cellule *cases = (cellule*) realloc(s->cases, n);
+    if(!cases) {
+      perror("Erreur d'allocation de la mémoire de l'instantané.\n");
+      s->erreur = 1;
+      pthread_mutex_unlock(&s->verrou);
+      return 0;
+    }
+    s->cases = cases;
+    s->capacite = n;
+  }
+  memcpy(s->cases, ruban_case(r, r->min), n);
+  struct entete_sauvegarde_s *e = &s->entete;
+  memset(e, 0, sizeof(*e));
+  memcpy(e->magie, MAGIE_SAUVEGARDE, sizeof(e->magie));
+  e->version = VERSION_SAUVEGARDE;
+  e->ordre_octets = 0x01020304;
+  e->hachage_machine = s->hachage_machine;
+  e->etat = c->etat_courant;
+  e->symbole_blanc = r->symbole_blanc;
+  e->tete = c->tete_lecture;
+  e->nb_etapes = c->nb_etapes;
+  e->min = r->min;
+  e->max = r->max;
+  s->pret = 1;
+  pthread_cond_signal(&s->signal);
+  pthread_mutex_unlock(&s->verrou);
+  return 1;
+}
+
+int executer_sauvegarde(configuration c, limites l, sauvegarde s) {
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  double debut = horloge_secondes(), dernier = debut;
+  struct sigaction action, anciennes[3];
+  int signaux[3] = { SIGUSR1, SIGTERM, SIGINT };
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = recevoir_signal;
+  sigemptyset(&action.sa_mask);
+  instantane_demande = arret_demande = 0;
+  for(int i = 0; i < 3; i++) sigaction(signaux[i], &action, &anciennes[i]);
+
+  int res;
+  for(;;) {
+    // Les tranches sont exécutées par executer(), qui s'arrête à la
+    // limite d'étapes de la tranche
+    struct limites_s tranche = { limite, 0, 0 };
+    if(limite - c->nb_etapes > TRANCHE_ETAPES)
+      tranche.max_etapes = c->nb_etapes + TRANCHE_ETAPES;
+    res = executer(c, &tranche);
+    if(res != RESULTAT_TIMEOUT || c->nb_etapes >= limite
+       || delai_depasse(l, debut))
+      break;
+    if(arret_demande) {
+      fprintf(stderr, "\n[SAUVEGARDE]: Exécution interrompue à l'étape "
+              "%ld, reprise avec --resume %s\n", c->nb_etapes, s->fichier);
+      break;
+    }
+    double maintenant = horloge_secondes();
+    if(instantane_demande || maintenant - dernier >= s->intervalle) {
+      // Si l'instantané précédent est encore en cours d'écriture,
+      // celui-ci est pris à la tranche suivante
+      if(prendre_instantane(s, c, 0)) {
+        instantane_demande = 0;
+        dernier = maintenant;
+      }
+    }
+  }
+  // Dernier instantané : la configuration finale, qui peut être reprise
+  // avec une limite plus grande
+  prendre_instantane(s, c, 1);
+
+  for(int i = 0; i < 3; i++) sigaction(signaux[i], &anciennes[i], NULL);
+  return res;
+}
+
+/**
+* Lit la longueur d'une plage
+* @return 1 en cas de succès, 0 si le fichier est tronqué ou invalide
+*/
+static int lire_longueur(FILE *f, uint64_t *longueur, uint64_t *h) {
+  *longueur = 0;
+  for(int i = 0; i < MAX_OCTETS_LONGUEUR; i++) {
+    int octet = fgetc(f);
+    if(octet == EOF) return 0;
+    unsigned char o = octet;
+    *h = hachage_fnv1a(*h, &o, 1);
+    *longueur |= (uint64_t) (o & 0x7F) << (7 * i);
+    if(!(o & 0x80)) return 1;
+  }
+  return 0;
+}
+
+/**
+* Lit les plages d'un instantané et vérifie que leurs longueurs 
+* couvrent exactement les cases min à max de l'entête, et leur hachage
+* @param f : le fichier, positionné au début des plages
+* @param e : l'entête de l'instantané
+* @param r : le ruban où décompresser les plages, étendu aux cases min à
+*            max ; NULL pour seulement vérifier les plages
+* @return 1 si les plages sont valides, 0 si le fichier est tronqué ou 
+*         altéré
+*/
+static int lire_plages(FILE *f, struct entete_sauvegarde_s *e, ruban r) {
+  uint64_t h = FNV1A_BASE, longueur;
+  uint64_t restant = (uint64_t) e->max - (uint64_t) e->min + 1;
+  long p = e->min;
+  for(uint64_t i = 0; i < e->nb_plages; i++) {
+    int symbole = fgetc(f);
+    unsigned char s = symbole;
+    if(symbole == EOF) return 0;
+    h = hachage_fnv1a(h, &s, 1);
+    if(!lire_longueur(f, &longueur, &h) || longueur == 0 
+       || longueur > restant)
+      return 0;
+    if(r) memset(ruban_case(r, p), s, longueur);
+    p += longueur;
+    restant -= longueur;
+  }
+  return restant == 0 && h == e->hachage_plages;
+}
+
+int reprendre_sauvegarde(const char *fichier, uint64_t hachage_machine,
+                         configuration c) {
+  FILE *f = fopen(fichier, "rb");
+  if(!f) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture de l'instantané %s",
+            fichier);
+    perror("\n\n");
+    return 0;
+  }
+  struct entete_sauvegarde_s e;
+  ruban r = c->ruban_courant;
+  const char *erreur = NULL;
+  if(fread(&e, sizeof(e), 1, f) != 1
+     || memcmp(e.magie, MAGIE_SAUVEGARDE, sizeof(e.magie)))
+    erreur = "n'est pas un instantané";
+  else if(e.version != VERSION_SAUVEGARDE || e.ordre_octets != 0x01020304)
+    erreur = "a été écrit par une autre version du simulateur";
+  else if(e.hachage_machine != hachage_machine)
+    erreur = "a été pris sur une autre machine (fichier, alphabets ou "
+             "symbole blanc différents)";
+  else if(e.symbole_blanc != r->symbole_blanc || e.etat < 0
+          || e.etat >= c->mt->table->nb_etats || e.min > e.max
+          || e.tete < e.min || e.tete > e.max || e.nb_etapes < 0)
+    erreur = "est incohérent";
+  // Les plages sont vérifiées avant d'étendre le ruban : les cases min
+  // à max ne sont allouées que si les plages les couvrent exactement
+  long debut_plages = erreur ? -1 : ftell(f);
+  if(!erreur && (debut_plages < 0 || !lire_plages(f, &e, NULL)))
+    erreur = "est tronqué ou altéré";
+  else if(!erreur && (!ruban_etendre(r, e.min) || !ruban_etendre(r, e.max)))
+    erreur = "ne tient pas en mémoire";
+  // Décompression des plages dans le ruban
+  else if(!erreur && (fseek(f, debut_plages, SEEK_SET) != 0 
+                      || !lire_plages(f, &e, r)))
+    erreur = "est tronqué ou altéré";
+  fclose(f);
+  if(erreur) {
+    fprintf(stderr, "\n[ERR]: L'instantané %s %s\n\n", fichier, erreur);
+    return 0;
+  }
+  r->min = e.min;
+  r->max = e.max;
+  c->etat_courant = e.etat;
+  c->tete_lecture = e.tete;
+  c->nb_etapes = e.nb_etapes;
+  fprintf(stderr, "[SAUVEGARDE]: Reprise de %s à l'étape %ld (%lu "
+          "plages, %ld cases)\n", fichier, c->nb_etapes,
+          (unsigned long) e.nb_plages, (long) (e.max - e.min + 1));
+  return 1;
+}
+
+int free_sauvegarde(sauvegarde s) {
+  if(!s) return 1;
+  pthread_mutex_lock(&s->verrou);
+  s->termine = 1;
+  pthread_cond_broadcast(&s->signal);
+  pthread_mutex_unlock(&s->verrou);
+  pthread_join(s->thread, NULL);
+  int ok = !s->erreur;
+  if(s->nb_ecrits)
+    fprintf(stderr, "[SAUVEGARDE]: %ld instantanés écrits dans %s (dernier "
+            "à l'étape %ld : %lu plages, %ld octets)\n", s->nb_ecrits,
+            s->fichier, (long) s->entete.nb_etapes,
+            (unsigned long) s->entete.nb_plages, s->taille_ecrite);
+  pthread_mutex_destroy(&s->verrou);
+  pthread_cond_destroy(&s->signal);
+  free(s->cases);
+  free(s->fichier);
+  free(s->temporaire);
+  free(s);
+  return ok;
+}
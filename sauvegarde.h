@@ -0,0 +1,126 @@
+#ifndef _sauvegarde_h_
+#define _sauvegarde_h_
+
+#include <stdint.h>
+
+#include "machineturing.h"
+
+/**
+* Format des instantanés d'une exécution : une entête (struct
+* entete_sauvegarde_s) suivie des cases visitées du ruban (positions min
+* à max) compressées en plages de cases identiques. Chaque plage est
+* écrite comme le symbole (1 octet) suivi de la longueur de la plage en
+* entier de taille variable (7 bits par octet, poids faibles en tête, le
+* bit de poids fort indiquant qu'un octet suit).
+*/
+
+// Début de tout fichier d'instantané
+#define MAGIE_SAUVEGARDE "MTSAV\r\n\032"
+// Version du format, à incrémenter à chaque changement de structure
+#define VERSION_SAUVEGARDE 1
+// Intervalle par défaut entre deux instantanés, en secondes
+#define INTERVALLE_SAUVEGARDE_DEFAUT 60
+
+/**
+* Entête d'un instantané.
+* magie -> MAGIE_SAUVEGARDE
+* version -> VERSION_SAUVEGARDE
+* ordre_octets -> 0x01020304 écrit dans l'ordre des octets de la machine
+*                 qui a écrit le fichier
+* hachage_machine -> le hachage du fichier de la machine, de ses
+*                    alphabets et de son symbole blanc (cf.
+*                    hacher_machine())
+* hachage_plages -> le hachage FNV-1a des plages, pour détecter un
+*                   fichier tronqué ou altéré
+* etat -> l'identifiant de l'état courant dans la table de la machine
+* symbole_blanc -> le symbole blanc du ruban
+* tete / nb_etapes -> la position de la tête et le nombre d'étapes
+* min / max -> les positions extrêmes visitées du ruban
+* nb_plages -> le nombre de plages qui suivent l'entête
+*/
+struct entete_sauvegarde_s {
+  char magie[8];
+  uint32_t version;
+  uint32_t ordre_octets;
+  uint64_t hachage_machine;
+  uint64_t hachage_plages;
+  int32_t etat;
+  uint32_t symbole_blanc;
+  int64_t tete;
+  int64_t nb_etapes;
+  int64_t min;
+  int64_t max;
+  uint64_t nb_plages;
+};
+
+/**
+* Sauvegarde d'une exécution : le fichier des instantanés, l'intervalle
+* entre deux instantanés et le thread qui les écrit (structure définie
+* dans sauvegarde.c)
+*/
+typedef struct sauvegarde_s* sauvegarde;
+
+/**
+* Calcule le hachage d'une machine : hachage FNV-1a du contenu de son
+* fichier, de ses alphabets et de son symbole blanc
+* @param path : le fichier de la machine
+* @param alphabets : les alphabets de la machine
+* @param symbole_blanc : le symbole blanc
+* @param hachage : le hachage calculé
+* @return 1 en cas de succès, 0 si le fichier ne peut pas être lu
+*/
+int hacher_machine(const char *path, const char *alphabets,
+                   char symbole_blanc, uint64_t *hachage);
+
+/**
+* Prépare la sauvegarde d'une exécution et démarre le thread qui écrit
+* les instantanés
+* @param fichier : le fichier des instantanés ; chaque instantané est
+*                  écrit dans 'fichier.tmp' puis renommé, le fichier
+*                  contient donc toujours un instantané complet
+* @param hachage_machine : le hachage de la machine exécutée
+* @param intervalle : le nombre de secondes entre deux instantanés
+* @return la sauvegarde, NULL en cas d'erreur
+*/
+sauvegarde init_sauvegarde(const char *fichier, uint64_t hachage_machine,
+                           double intervalle);
+
+/**
+* Restaure dans une configuration l'exécution enregistrée dans un
+* instantané, après avoir vérifié que l'instantané a été pris sur la
+* même machine (hachage, symbole blanc et nombre d'états)
+* @param fichier : le fichier de l'instantané
+* @param hachage_machine : le hachage de la machine de la configuration
+* @param c : la configuration, remplacée par celle de l'instantané
+* @return 1 en cas de succès, 0 en cas d'erreur
+*/
+int reprendre_sauvegarde(const char *fichier, uint64_t hachage_machine,
+                         configuration c);
+
+/**
+* Exécute une machine comme executer() (sans détection des cycles), en
+* prenant un instantané de la configuration toutes les 'intervalle'
+* secondes, à la réception de SIGUSR1 et à la fin de l'exécution.
+* SIGTERM et SIGINT prennent un dernier instantané et interrompent
+* l'exécution (résultat TIMEOUT). L'horloge et les signaux sont
+* consultés entre deux tranches d'étapes ; un instantané ne coûte à
+* l'exécution qu'une copie du ruban, la compression et l'écriture étant
+* faites par le thread de la sauvegarde.
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée), NULL pour ne
+*            pas limiter
+* @param s : la sauvegarde
+* @return le résultat de l'exécution (enum resultat)
+*/
+int executer_sauvegarde(configuration c, limites l, sauvegarde s);
+
+/**
+* Attend l'écriture du dernier instantané, arrête le thread de la
+* sauvegarde et libère la mémoire allouée
+* @param s : la sauvegarde
+* @return 1 si tous les instantanés ont été écrits, 0 sinon
+*/
+int free_sauvegarde(sauvegarde s);
+
+
+#endif
@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dictionnaire.h"
+#include "machineturing.h"
+#include "table_transitions.h"
+
+// Nombre maximal de conflits détaillés sur la sortie d'erreur
+#define MAX_CONFLITS_AFFICHES 10
+
+/**
+* Transition en cours de compilation : sert au tri des transitions par
+* couple (etat, symbole) en conservant l'ordre de déclaration.
+*/
+struct transition_compilee_s {
+  int32_t etat;
+  int32_t code;
+  int32_t rang;
+  transition tr;
+  int32_t nouvel_etat;
+};
+
+static int comparer_transitions(const void *a, const void *b) {
+  const struct transition_compilee_s *x = a, *y = b;
+  if(x->etat != y->etat) return x->etat < y->etat ? -1 : 1;
+  if(x->code != y->code) return x->code < y->code ? -1 : 1;
+  return x->rang < y->rang ? -1 : x->rang > y->rang;
+}
+
+/**
+* Attribue un code au symbole s'il n'en a pas encore
+*/
+static void ajouter_symbole(table_transitions t, unsigned char symbole) {
+  if(t->code_symbole[symbole] >= 0) return;
+  t->code_symbole[symbole] = t->nb_symboles;
+  t->symboles[t->nb_symboles++] = symbole;
+}
+
+/**
+* Copie les noms des états du dictionnaire dans la table
+*/
+static int copier_noms(table_transitions t, dictionnaire d) {
+  size_t taille = 0;
+  for(int i = 0; i < d->nb; i++) taille += d->longueurs[i] + 1;
+  t->noms = (char*) malloc(taille);
+  t->offsets_noms = (uint32_t*) malloc(sizeof(uint32_t) * (d->nb + 1));
+  if(!t->noms || !t->offsets_noms) return 0;
+  uint32_t offset = 0;
+  for(int i = 0; i < d->nb; i++) {
+    t->offsets_noms[i] = offset;
+    memcpy(t->noms + offset, d->chaines[i], d->longueurs[i] + 1);
+    offset += d->longueurs[i] + 1;
+  }
+  t->nb_etats = d->nb;
+  return 1;
+}
+
+/**
+* Construit l'index (etat, symbole) -> première règle du groupe, sous
+* forme dense ou creuse selon la taille de l'alphabet et le remplissage
+* de la table.
+*/
+static int indexer_regles(table_transitions t, 
+                          struct transition_compilee_s *trs, int n) {
+  int nb_groupes = 0;
+  for(int i = 0; i < n; i++) 
+    if(t->regles[i].nb_alternatives) nb_groupes++;
+
+  long taille_dense = (long) t->nb_etats * t->nb_symboles;
+  t->dense = t->nb_symboles <= SEUIL_TABLE_DENSE 
+             || taille_dense <= 4L * nb_groupes;
+
+  if(t->dense) {
+    t->cases = (int32_t*) malloc(sizeof(int32_t) * (taille_dense + 1));
+    if(!t->cases) return 0;
+    for(long i = 0; i < taille_dense; i++) t->cases[i] = -1;
+    for(int i = 0; i < n; i++) 
+      if(t->regles[i].nb_alternatives)
+        t->cases[(long) trs[i].etat * t->nb_symboles + trs[i].code] = i;
+    return 1;
+  }
+
+  // Table creuse : les règles étant triées par (etat, symbole), les 
+  // groupes de chaque état sont déjà contigus et triés par symbole
+  t->debuts = (uint32_t*) calloc(t->nb_etats + 1, sizeof(uint32_t));
+  t->cles = (unsigned char*) malloc(nb_groupes + 1);
+  t->cibles = (int32_t*) malloc(sizeof(int32_t) * (nb_groupes + 1));
+  if(!t->debuts || !t->cles || !t->cibles) return 0;
+  int g = 0;
+  for(int i = 0; i < n; i++) {
+    if(!t->regles[i].nb_alternatives) continue;
+    t->debuts[trs[i].etat + 1]++;
+    t->cles[g] = (unsigned char) trs[i].code;
+    t->cibles[g++] = i;
+  }
+  for(int e = 0; e < t->nb_etats; e++) t->debuts[e+1] += t->debuts[e];
+  return 1;
+}
+
+/**
+* Signale les couples (etat, symbole) ayant plusieurs transitions 
+* différentes (les doublons exacts ne sont pas des conflits).
+*/
+static void signaler_conflits(table_transitions t, 
+                              struct transition_compilee_s *trs, int n) {
+  for(int i = 0; i < n; i++) {
+    int nb = t->regles[i].nb_alternatives;
+    if(nb < 2) continue;
+    transition premiere = trs[i].tr;
+    for(int j = i + 1; j < i + nb; j++) {
+      if(trs[j].tr->symbole_ecrit != premiere->symbole_ecrit 
+         || trs[j].tr->mouvement != premiere->mouvement 
+         || trs[j].nouvel_etat != trs[i].nouvel_etat) {
+        if(t->nb_conflits < MAX_CONFLITS_AFFICHES)
+          fprintf(stderr, "[ATTENTION]: Machine non déterministe : "
+                  "%d transitions pour (%s, %c). Seule la première "
+                  "déclarée (%s,%c,%s,%c,%c) est appliquée, sauf par le "
+                  "moteur 'ntm'\n", nb,
+                  premiere->etat, premiere->symbole_lu, premiere->etat,
+                  premiere->symbole_lu, premiere->nouvel_etat,
+                  premiere->symbole_ecrit, premiere->mouvement);
+        t->nb_conflits++;
+        break;
+      }
+    }
+  }
+  if(t->nb_conflits > MAX_CONFLITS_AFFICHES)
+    fprintf(stderr, "[ATTENTION]: %d couples (etat, symbole) non "
+            "déterministes au total\n", t->nb_conflits);
+}
+
+/**
+* Internalise un état d'une transition dans le dictionnaire de la table
+* @param d : le dictionnaire de la table
+* @param noms : le dictionnaire des noms de la machine, NULL si absent
+* @param ids : identifiant dans noms -> identifiant dans d (-1 si pas 
+*              encore internalisé)
+* @param nom : le nom de l'état
+* @param id_nom : l'identifiant de l'état dans noms, -1 s'il est inconnu
+* @return l'identifiant de l'état dans d, -1 en cas d'erreur
+*/
+static int32_t interner_etat(dictionnaire d, dictionnaire noms, 
+                             int32_t *ids, char *nom, int32_t id_nom) {
+  if(!ids || id_nom < 0) return dictionnaire_ajouter(d, nom, strlen(nom));
+  if(ids[id_nom] < 0) 
+    ids[id_nom] = dictionnaire_ajouter(d, nom, noms->longueurs[id_nom]);
+  return ids[id_nom];
+}
+
+table_transitions compiler_transitions(transition transitions,
+  dictionnaire noms, char *etat_in, char *etat_fin, 
+  char *alphabet_entree, char *alphabet_travail, char symbole_blanc) {
+  table_transitions t = (table_transitions) calloc(1, sizeof(struct table_s));
+  dictionnaire d = init_dictionnaire();
+  struct transition_compilee_s *trs = NULL;
+  int32_t *ids = NULL;
+  if(!t || !d) goto erreur;
+  if(noms) {
+    ids = (int32_t*) malloc(sizeof(int32_t) * (noms->nb + 1));
+    if(!ids) goto erreur;
+    memset(ids, -1, sizeof(int32_t) * (noms->nb + 1));
+  }
+
+  // Codage des symboles : alphabets, symbole blanc, puis les éventuels
+  // autres symboles présents dans les transitions
+  for(int i = 0; i < 256; i++) t->code_symbole[i] = -1;
+  for(char *s = alphabet_entree; s && *s; s++) 
+    ajouter_symbole(t, (unsigned char) *s);
+  for(char *s = alphabet_travail; s && *s; s++) 
+    ajouter_symbole(t, (unsigned char) *s);
+  ajouter_symbole(t, (unsigned char) symbole_blanc);
+
+  // Internalisation des états : l'état initial reçoit l'identifiant 0
+  t->etat_in = dictionnaire_ajouter(d, etat_in, strlen(etat_in));
+  t->etat_fin = dictionnaire_ajouter(d, etat_fin, strlen(etat_fin));
+  int n = 0;
+  for(transition tr = transitions; tr; tr = tr->suivant) n++;
+  trs = (struct transition_compilee_s*) malloc(sizeof(*trs) * (n + 1));
+  if(!trs) goto erreur;
+  n = 0;
+  for(transition tr = transitions; tr; tr = tr->suivant, n++) {
+    trs[n].etat = interner_etat(d, noms, ids, tr->etat, tr->id_etat);
+    trs[n].nouvel_etat = interner_etat(d, noms, ids, tr->nouvel_etat, 
+                                       tr->id_nouvel_etat);
+    if(trs[n].etat < 0 || trs[n].nouvel_etat < 0) goto erreur;
+    ajouter_symbole(t, (unsigned char) tr->symbole_lu);
+    ajouter_symbole(t, (unsigned char) tr->symbole_ecrit);
+    trs[n].code = t->code_symbole[(unsigned char) tr->symbole_lu];
+    trs[n].rang = n;
+    trs[n].tr = tr;
+  }
+  if(!copier_noms(t, d)) goto erreur;
+
+  // Tri des transitions par couple (etat, symbole)
+  qsort(trs, n, sizeof(*trs), comparer_transitions);
+  t->nb_regles = n;
+  t->regles = (struct regle_s*) malloc(sizeof(struct regle_s) * (n + 1));
+  if(!t->regles) goto erreur;
+  for(int i = 0; i < n; i++) {
+    regle r = &t->regles[i];
+    r->nouvel_etat = trs[i].nouvel_etat;
+    r->rang = trs[i].rang;
+    r->nb_alternatives = 0;
+    r->symbole_ecrit = (unsigned char) trs[i].tr->symbole_ecrit;
+    r->mouvement = trs[i].tr->mouvement;
+    r->deplacement = r->mouvement == DROITE ? 1 
+                     : r->mouvement == GAUCHE ? -1 : 0;
+  }
+  // Taille de chaque groupe, renseignée sur sa première règle
+  for(int i = 0, debut = 0; i <= n; i++) {
+    if(i == n || trs[i].etat != trs[debut].etat 
+       || trs[i].code != trs[debut].code) {
+      if(i > debut) t->regles[debut].nb_alternatives = i - debut;
+      debut = i;
+    }
+  }
+
+  signaler_conflits(t, trs, n);
+  if(!indexer_regles(t, trs, n) || !table_preparer_recherches(t)) 
+    goto erreur;
+
+  free(trs);
+  free(ids);
+  free_dictionnaire(d);
+  return t;
+
+erreur:
+  perror("Erreur lors de la compilation des transitions.\n");
+  free(trs);
+  free(ids);
+  free_dictionnaire(d);
+  free_table_transitions(t);
+  return NULL;
+}
+
+int table_preparer_recherches(table_transitions t) {
+  t->recherches = (struct recherche_s*) calloc(t->nb_etats + 1, 
+                                               sizeof(struct recherche_s));
+  if(!t->recherches) return 0;
+  for(int e = 0; e < t->nb_etats; e++) {
+    // L'état final arrête la machine avant toute lecture
+    if(e == t->etat_fin) continue;
+    recherche rech = &t->recherches[e];
+    for(int code = 0; code < t->nb_symboles; code++) {
+      unsigned char symbole = t->symboles[code];
+      int32_t i = table_chercher(t, e, symbole);
+      if(i < 0) continue;
+      regle r = &t->regles[i];
+      if(r->nouvel_etat != e || r->symbole_ecrit != symbole 
+         || r->deplacement == 0) 
+        continue;
+      // Les symboles traversés doivent l'être dans la même direction
+      if((rech->nb && r->deplacement != rech->deplacement) 
+         || rech->nb == MAX_SYMBOLES_RECHERCHE) {
+        rech->nb = 0;
+        break;
+      }
+      rech->deplacement = r->deplacement;
+      rech->symboles[rech->nb++] = symbole;
+    }
+    if(!rech->nb) rech->deplacement = 0;
+  }
+  return 1;
+}
+
+void afficher_table_transitions(table_transitions t, 
+                                const uint64_t *passages) {
+  printf("> TRANSITIONS DE LA MACHINE :\n");
+  printf("Etat  |  Symbole lu  |  Symbole ecrit  |  Mouvement  |  Nouvel etat%s\n",
+         passages ? "  |  Passages" : "");
+  for(int e = 0; e < t->nb_etats; e++) {
+    for(int code = 0; code < t->nb_symboles; code++) {
+      int32_t i = table_chercher(t, e, t->symboles[code]);
+      if(i < 0) continue;
+      for(int j = i; j < i + t->regles[i].nb_alternatives; j++) {
+        regle r = &t->regles[j];
+        printf(" %s           %c                %c               %c "
+               "            %s", table_nom_etat(t, e), t->symboles[code],
+               r->symbole_ecrit, r->mouvement, 
+               table_nom_etat(t, r->nouvel_etat));
+        if(passages) 
+          printf("           %llu", (unsigned long long) passages[r->rang]);
+        printf("\n");
+      }
+    }
+  }
+  printf("\n");
+}
+
+void free_table_transitions(table_transitions t) {
+  if(!t) return;
+  free(t->noms);
+  free(t->offsets_noms);
+  free(t->regles);
+  free(t->cases);
+  free(t->debuts);
+  free(t->cles);
+  free(t->cibles);
+  free(t->recherches);
+  free(t);
+}
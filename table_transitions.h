@@ -0,0 +1,189 @@
+#ifndef _table_transitions_h_
+#define _table_transitions_h_
+
+#include <stdint.h>
+
+#include "dictionnaire.h"
+
+struct transition_s;
+
+/**
+* Nombre maximal de symboles pour lequel la table est toujours dense.
+* Au delà, la table n'est dense que si elle est suffisamment remplie.
+*/
+#define SEUIL_TABLE_DENSE 32
+
+/**
+* Structure de données représentant une transition compilée, i.e dont
+* les états sont remplacés par leurs identifiants entiers.
+* nouvel_etat -> l'identifiant du nouvel état
+* rang -> la position de la transition d'origine dans la liste chainée 
+*         des transitions de la machine
+* nb_alternatives -> le nombre de transitions déclarées pour le même 
+*                    couple (etat, symbole). Seule la première règle
+*                    d'un groupe renseigne ce champ (0 pour les autres).
+* symbole_ecrit -> le symbole à écrire
+* mouvement -> le déplacement ('>', '<' ou '-')
+* deplacement -> le déplacement de la tête (+1, -1 ou 0)
+*/
+struct regle_s {
+  int32_t nouvel_etat;
+  int32_t rang;
+  int32_t nb_alternatives;
+  unsigned char symbole_ecrit;
+  char mouvement;
+  signed char deplacement;
+};
+typedef struct regle_s* regle;
+
+/**
+* Nombre maximal de symboles traversés par un état de recherche
+*/
+#define MAX_SYMBOLES_RECHERCHE 8
+
+/**
+* Etat de recherche : état qui, pour un ensemble de symboles, les 
+* réécrit tels quels et se déplace toujours dans la même direction sans
+* changer d'état (ex : C,0,C,0,> et C,1,C,1,>). La machine y traverse 
+* donc toutes les cases de ces symboles jusqu'à la première case d'un 
+* autre symbole.
+* deplacement -> la direction de la recherche (+1 ou -1), 0 si l'état 
+*                n'est pas un état de recherche
+* nb -> le nombre de symboles traversés
+* symboles -> les symboles traversés
+*/
+struct recherche_s {
+  signed char deplacement;
+  unsigned char nb;
+  unsigned char symboles[MAX_SYMBOLES_RECHERCHE];
+};
+typedef struct recherche_s* recherche;
+
+/**
+* Structure de données stockant la table des transitions compilée d'une
+* machine de Turing. Chaque nom d'état est internalisé en un 
+* identifiant entier dense, et chaque symbole en un code dense. 
+* nb_etats -> le nombre d'états de la machine
+* noms -> les noms des états, les uns à la suite des autres, chacun 
+*         terminé par '\0'
+* offsets_noms -> identifiant d'un état -> position de son nom dans noms
+* etat_in -> l'identifiant de l'état initial
+* etat_fin -> l'identifiant de l'état final
+* nb_symboles -> le nombre de symboles de la machine (alphabets et
+*                symbole blanc)
+* code_symbole -> symbole -> code du symbole, -1 si le symbole est inconnu
+* symboles -> code -> symbole
+* nb_regles -> le nombre de règles
+* regles -> les règles, groupées par couple (etat, symbole) et dans 
+*           l'ordre de déclaration à l'intérieur d'un groupe
+* dense -> 1 si la table est dense, 0 si elle est creuse
+* cases -> table dense [etat][code symbole] : indice de la première 
+*          règle du groupe, -1 s'il n'y a pas de transition
+* debuts -> table creuse : les groupes de l'état e sont aux positions
+*           debuts[e] à debuts[e+1]-1 de cles et cibles
+* cles -> table creuse : codes des symboles, triés pour chaque état
+* cibles -> table creuse : indice de la première règle du groupe
+* nb_conflits -> le nombre de couples (etat, symbole) non déterministes
+* recherches -> identifiant d'un état -> ses symboles traversés s'il est
+*               un état de recherche (cf. struct recherche_s)
+*/
+struct table_s {
+  int32_t nb_etats;
+  char *noms;
+  uint32_t *offsets_noms;
+  int32_t etat_in;
+  int32_t etat_fin;
+  int32_t nb_symboles;
+  int16_t code_symbole[256];
+  unsigned char symboles[256];
+  int32_t nb_regles;
+  struct regle_s *regles;
+  int32_t dense;
+  int32_t *cases;
+  uint32_t *debuts;
+  unsigned char *cles;
+  int32_t *cibles;
+  int32_t nb_conflits;
+  struct recherche_s *recherches;
+};
+typedef struct table_s* table_transitions;
+
+/**
+* Compile la liste des transitions d'une machine de Turing en une table
+* indexée par (etat, symbole). Les couples (etat, symbole) ayant 
+* plusieurs transitions différentes sont signalés sur la sortie 
+* d'erreur ; la première transition déclarée reste celle appliquée.
+* @param transitions : la liste chainée des transitions
+* @param noms : le dictionnaire des noms d'états auquel renvoient les 
+*               identifiants id_etat / id_nouvel_etat des transitions 
+*               (NULL si les transitions n'en ont pas) : chaque nom n'est
+*               alors internalisé qu'une fois
+* @param etat_in : le nom de l'état initial
+* @param etat_fin : le nom de l'état final
+* @param alphabet_entree : l'alphabet d'entrée de la machine
+* @param alphabet_travail : l'alphabet de travail de la machine
+* @param symbole_blanc : le symbole blanc du ruban
+* @return la table compilée, NULL en cas d'erreur
+*/
+table_transitions compiler_transitions(struct transition_s *transitions,
+  dictionnaire noms, char *etat_in, char *etat_fin, 
+  char *alphabet_entree, char *alphabet_travail, char symbole_blanc);
+
+/**
+* Renvoie le nom d'un état à partir de son identifiant
+*/
+static inline const char* table_nom_etat(table_transitions t, int etat) {
+  return t->noms + t->offsets_noms[etat];
+}
+
+/**
+* Recherche la règle à appliquer dans un état donné pour un symbole lu
+* @param t : la table des transitions
+* @param etat : l'identifiant de l'état courant
+* @param symbole : le symbole lu sur le ruban
+* @return l'indice de la règle dans t->regles, -1 s'il n'y en a pas
+*/
+static inline int32_t table_chercher(table_transitions t, int etat, 
+                                     unsigned char symbole) {
+  int code = t->code_symbole[symbole];
+  if(code < 0) return -1;
+  if(t->dense) return t->cases[etat * t->nb_symboles + code];
+  // Recherche dichotomique parmi les symboles de l'état
+  uint32_t debut = t->debuts[etat], fin = t->debuts[etat+1];
+  while(debut < fin) {
+    uint32_t milieu = (debut + fin) / 2;
+    if(t->cles[milieu] < code) debut = milieu + 1;
+    else fin = milieu;
+  }
+  if(debut < t->debuts[etat+1] && t->cles[debut] == code) 
+    return t->cibles[debut];
+  return -1;
+}
+
+/**
+* Détecte les états de recherche d'une table (cf. struct recherche_s) 
+* et remplit t->recherches. Appelée à la compilation et au chargement
+* de la table.
+* @param t : la table des transitions
+* @return 1 en cas de succès, 0 en cas d'erreur d'allocation
+*/
+int table_preparer_recherches(table_transitions t);
+
+/**
+* Affiche les règles d'une table de transitions, groupées par état puis
+* par symbole lu (même présentation que afficher_transitions())
+* @param t : la table à afficher
+* @param passages : le nombre de passages de chaque règle (indexé par 
+*                   son rang), NULL pour ne pas l'afficher
+*/
+void afficher_table_transitions(table_transitions t, 
+                                const uint64_t *passages);
+
+/**
+* Libère l'espace mémoire alloué pour une table de transitions
+* @param t : la table à désallouer
+*/
+void free_table_transitions(table_transitions t);
+
+
+#endif
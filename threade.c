@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "threade.h"
+
+/**
+* Opérations du code threadé
+*/
+enum operation {
+  OP_GAUCHE,
+  OP_DROITE,
+  OP_RESTER,
+  OP_ARRET
+};
+
+programme compiler_programme(table_transitions t) {
+  programme p = (programme) malloc(sizeof(struct programme_s));
+  if(!p) {
+    perror("Erreur d'allocation du programme threadé.\n");
+    return NULL;
+  }
+  p->table = t;
+  p->nb_colonnes = t->nb_symboles + 1;
+  p->instructions = (instruction) malloc(sizeof(struct instruction_s) 
+                          * (size_t) t->nb_etats * p->nb_colonnes);
+  if(!p->instructions) {
+    perror("Erreur d'allocation du programme threadé.\n");
+    free(p);
+    return NULL;
+  }
+  for(int s = 0; s < 256; s++) 
+    p->code_symbole[s] = t->code_symbole[s] < 0 ? t->nb_symboles 
+                                                : t->code_symbole[s];
+
+  for(int e = 0; e < t->nb_etats; e++) {
+    instruction ligne = p->instructions + (size_t) e * p->nb_colonnes;
+    for(int code = 0; code < p->nb_colonnes; code++) {
+      instruction in = &ligne[code];
+      // L'état final arrête la machine avant toute lecture
+      int32_t i = code < t->nb_symboles && e != t->etat_fin 
+                  ? table_chercher(t, e, t->symboles[code]) : -1;
+      if(i < 0) {
+        in->op = OP_ARRET;
+        in->nouvel_etat = e;
+        in->suivante = 0;
+        in->symbole_ecrit = 0;
+        continue;
+      }
+      regle rg = &t->regles[i];
+      in->op = rg->deplacement < 0 ? OP_GAUCHE 
+               : rg->deplacement > 0 ? OP_DROITE : OP_RESTER;
+      in->nouvel_etat = rg->nouvel_etat;
+      in->suivante = rg->nouvel_etat * p->nb_colonnes;
+      in->symbole_ecrit = rg->symbole_ecrit;
+    }
+  }
+  return p;
+}
+
+/**
+* Exécute un programme jusqu'à l'arrêt de la machine ou jusqu'à une 
+* étape donnée (tranche_moteur, le contexte étant le programme)
+* @param c : la configuration de départ, mise à jour
+* @param fin_tranche : l'étape à laquelle interrompre l'exécution
+* @param contexte : le programme
+* @return 1 si la machine s'est arrêtée, 0 si fin_tranche est atteinte
+*/
+static int executer_tranche(configuration c, long fin_tranche, 
+                            void *contexte) {
+  programme p = (programme) contexte;
+  static void *etiquettes[] = { &&gauche, &&droite, &&rester, &&fin };
+  const instruction instructions = p->instructions;
+  const int32_t *code = p->code_symbole;
+  ruban r = c->ruban_courant;
+  long tete = c->tete_lecture, n = c->nb_etapes;
+  cellule *s = ruban_case(r, tete);
+  instruction in = &instructions[c->etat_courant * p->nb_colonnes 
+                                 + code[*s]];
+  int termine = 1;
+
+  // Étape limite déjà atteinte : la configuration n'est pas modifiée
+  if(n >= fin_tranche && in->op != OP_ARRET) return 0;
+
+// Passe à l'instruction du nouvel état pour le symbole sous la tête
+#define SUIVANTE() \
+  do { \
+    if(++n >= fin_tranche) { termine = 0; goto fin; } \
+    s = ruban_case(r, tete); \
+    in = &instructions[in->suivante + code[*s]]; \
+    goto *etiquettes[in->op]; \
+  } while(0)
+
+  goto *etiquettes[in->op];
+
+gauche:
+  *s = in->symbole_ecrit;
+  if(!ruban_deplacer(r, &tete, -1)) { n++; goto fin; }
+  SUIVANTE();
+droite:
+  *s = in->symbole_ecrit;
+  if(!ruban_deplacer(r, &tete, 1)) { n++; goto fin; }
+  SUIVANTE();
+rester:
+  *s = in->symbole_ecrit;
+  SUIVANTE();
+fin:
+#undef SUIVANTE
+  // in est la dernière instruction exécutée (ou l'arrêt, dont le nouvel
+  // état est l'état courant)
+  c->etat_courant = in->nouvel_etat;
+  c->tete_lecture = tete;
+  c->nb_etapes = n;
+  return termine;
+}
+
+int executer_threade(programme p, configuration c, limites l) {
+  return executer_tranches(c, l, executer_tranche, NULL, p);
+}
+
+void free_programme(programme p) {
+  if(!p) return;
+  free(p->instructions);
+  free(p);
+}
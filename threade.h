@@ -0,0 +1,71 @@
+#ifndef _threade_h_
+#define _threade_h_
+
+#include "machineturing.h"
+
+/**
+* Instruction du code threadé : action à effectuer dans un état donné
+* pour un symbole lu donné.
+* op -> l'opération (enum operation de threade.c) : déplacement à 
+*       gauche, à droite, sur place, ou arrêt de la machine
+* symbole_ecrit -> le symbole à écrire
+* nouvel_etat -> le nouvel état (l'état courant pour un arrêt)
+* suivante -> l'indice de la première instruction du nouvel état
+*/
+struct instruction_s {
+  int32_t op;
+  int32_t nouvel_etat;
+  int32_t suivante;
+  unsigned char symbole_ecrit;
+};
+typedef struct instruction_s* instruction;
+
+/**
+* Programme threadé d'une machine : la table des transitions traduite 
+* en un tableau d'instructions, une ligne de (nb_symboles + 1) 
+* instructions par état (la dernière colonne, pour les symboles hors des
+* alphabets, arrête la machine).
+* nb_colonnes -> le nombre d'instructions par état
+* code_symbole -> la colonne de chaque caractère lu
+* instructions -> les instructions, ligne par ligne
+* table -> la table des transitions traduite
+*/
+struct programme_s {
+  int32_t nb_colonnes;
+  int32_t code_symbole[256];
+  instruction instructions;
+  table_transitions table;
+};
+typedef struct programme_s* programme;
+
+/**
+* Traduit la table des transitions d'une machine en programme threadé.
+* Le programme n'est pas modifié par les exécutions : il peut être 
+* partagé par plusieurs threads.
+* @param t : la table des transitions
+* @return le programme, NULL en cas d'erreur
+*/
+programme compiler_programme(table_transitions t);
+
+/**
+* Exécute un programme threadé : chaque instruction se termine par un
+* saut direct (goto calculé) vers l'opération de l'instruction 
+* suivante, sans repasser par une boucle centrale. Le nombre d'étapes
+* et le résultat sont les mêmes qu'avec executer().
+* @param p : le programme de la machine de la configuration
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée ; la détection
+*            des cycles n'est pas faite par ce moteur), NULL pour ne pas
+*            limiter
+* @return le résultat de l'exécution (enum resultat)
+*/
+int executer_threade(programme p, configuration c, limites l);
+
+/**
+* Libère l'espace mémoire alloué pour un programme threadé
+* @param p : le programme à désallouer
+*/
+void free_programme(programme p);
+
+
+#endif
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+// Taille initiale du tampon d'affichage d'une configuration
+#define TAILLE_TAMPON 4096
+// Place réservée à l'entête d'une configuration (hors nom d'état)
+#define TAILLE_ENTETE 128
+
+
+trace init_trace(int niveau, long periode, long fenetre) {
+  trace t = (trace) malloc(sizeof(struct trace_s));
+  if(t == NULL) {
+    perror("Erreur d'allocation de la mémoire de la trace.\n");
+    return NULL;
+  }
+  t->niveau = niveau;
+  t->periode = periode > 0 ? periode : 1;
+  t->fenetre = fenetre > 0 ? fenetre : 0;
+  t->capacite = TAILLE_TAMPON;
+  t->tampon = (char*) malloc(t->capacite);
+  t->sortie = stdout;
+  if(t->tampon == NULL) {
+    perror("Erreur d'allocation de la mémoire de la trace.\n");
+    free(t);
+    return NULL;
+  }
+  return t;
+}
+
+/**
+* Agrandit le tampon de la trace pour qu'il puisse contenir taille octets
+*/
+static int reserver_tampon(trace t, size_t taille) {
+  if(taille <= t->capacite) return 1;
+  size_t capacite = t->capacite;
+  while(capacite < taille) capacite *= 2;
+  char *tampon = (char*) realloc(t->tampon, capacite);
+  if(tampon == NULL) return 0;
+  t->tampon = tampon;
+  t->capacite = capacite;
+  return 1;
+}
+
+void trace_afficher(trace t, const char *etat, ruban r, long tete, 
+                    long etape) {
+  // Cases affichées : toutes les cases visitées, ou seulement celles de
+  // la fenêtre autour de la tête de lecture
+  long debut = r->min, fin = r->max;
+  if(t->fenetre > 0) {
+    if(tete - t->fenetre > debut) debut = tete - t->fenetre;
+    if(tete + t->fenetre < fin) fin = tete + t->fenetre;
+  }
+  int coupe_gauche = debut > r->min, coupe_droite = fin < r->max;
+
+  // Chaque case occupe 4 caractères sur la ligne du ruban et sur celle
+  // de la tête de lecture
+  size_t taille = TAILLE_ENTETE + strlen(etat) + 8 * (fin - debut + 3);
+  if(!reserver_tampon(t, taille)) {
+    perror("Erreur d'allocation du tampon de la trace.\n");
+    return;
+  }
+
+  char *p = t->tampon;
+  p += sprintf(p, "\n> CONFIGURATION ACTUELLE DU RUBAN :\n"
+                  "            ETAT : %s\n"
+                  "           ETAPE : %ld\n ", etat, etape);
+  if(coupe_gauche) { memcpy(p, "...", 3); p += 3; }
+  for(long pos = debut; pos <= fin; pos++) {
+    p[0] = '|'; p[1] = ' '; p[2] = *ruban_case(r, pos); p[3] = ' ';
+    p += 4;
+  }
+  *p++ = '|';
+  if(coupe_droite) { memcpy(p, "...", 3); p += 3; }
+  *p++ = '\n';
+
+  // Ligne de la tête de lecture
+  long decalage = 4 * (tete - debut) + 3 + (coupe_gauche ? 3 : 0);
+  memset(p, ' ', decalage);
+  p += decalage;
+  *p++ = '^';
+  *p++ = '\n';
+
+  fwrite(t->tampon, 1, p - t->tampon, t->sortie);
+}
+
+void free_trace(trace t) {
+  if(!t) return;
+  free(t->tampon);
+  free(t);
+}
@@ -0,0 +1,83 @@
+#ifndef _trace_h_
+#define _trace_h_
+
+#include <stdio.h>
+
+#include "ruban.h"
+
+/**
+* Niveaux de verbosité de la trace d'exécution d'une machine :
+* TRACE_SILENCIEUSE -> seuls le résultat et le nombre d'étapes sont 
+*                      affichés
+* TRACE_PERIODIQUE -> la configuration est affichée toutes les 
+*                     'periode' étapes, ainsi que la configuration finale
+* TRACE_COMPLETE -> la configuration est affichée après chaque étape
+*/
+enum niveau_trace {
+  TRACE_SILENCIEUSE,
+  TRACE_PERIODIQUE,
+  TRACE_COMPLETE
+};
+
+/**
+* Structure de données décrivant la trace d'exécution d'une machine.
+* niveau -> le niveau de verbosité (enum niveau_trace)
+* periode -> le nombre d'étapes entre deux affichages (TRACE_PERIODIQUE)
+* fenetre -> le nombre de cases affichées de part et d'autre de la tête 
+*            de lecture, 0 pour afficher toutes les cases visitées
+* tampon -> le tampon dans lequel est construit l'affichage d'une 
+*           configuration, écrit en une seule fois sur la sortie
+* capacite -> la taille allouée du tampon
+* sortie -> le flux où écrire la trace
+*/
+struct trace_s {
+  int niveau;
+  long periode;
+  long fenetre;
+  char *tampon;
+  size_t capacite;
+  FILE *sortie;
+};
+typedef struct trace_s* trace;
+
+/**
+* Crée une trace d'exécution écrivant sur la sortie standard
+* @param niveau : le niveau de verbosité
+* @param periode : le nombre d'étapes entre deux affichages
+* @param fenetre : le nombre de cases affichées de chaque côté de la 
+*                  tête de lecture, 0 pour tout le ruban
+* @return la trace créée, NULL en cas d'erreur
+*/
+trace init_trace(int niveau, long periode, long fenetre);
+
+/**
+* Indique si la configuration atteinte après une étape doit être 
+* affichée selon le niveau de verbosité de la trace
+*/
+static inline int trace_a_afficher(trace t, long etape) {
+  return t->niveau == TRACE_COMPLETE 
+         || (t->niveau == TRACE_PERIODIQUE && etape % t->periode == 0);
+}
+
+/**
+* Affiche une configuration d'une machine : son état, le numéro de
+* l'étape, les cases du ruban (celles de la fenêtre autour de la tête de
+* lecture) et la position de la tête. L'affichage est construit dans le
+* tampon de la trace puis écrit en une seule fois.
+* @param t : la trace
+* @param etat : le nom de l'état courant
+* @param r : le ruban de la machine
+* @param tete : la position de la tête de lecture
+* @param etape : le numéro de l'étape
+*/
+void trace_afficher(trace t, const char *etat, ruban r, long tete, 
+                    long etape);
+
+/**
+* Libère l'espace mémoire alloué pour une trace
+* @param t : la trace à désallouer
+*/
+void free_trace(trace t);
+
+
+#endif
@@ -0,0 +1,519 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "trace_binaire.h"
+
+// Nombre d'étapes d'un tampon (et d'un bloc de la trace)
+#define TAILLE_TAMPON_TRACE (1 << 20)
+// Nombre de tampons : la boucle remplit l'un pendant que les autres sont
+// écrits
+#define NB_TAMPONS_TRACE 4
+// Nombre maximal d'octets d'un entier de taille variable (32 bits)
+#define MAX_OCTETS_ENTIER 5
+
+/**
+* Structure de données d'une trace binaire en cours d'écriture.
+* fichier / f -> le nom et le flux du fichier de la trace
+* compresser -> 1 pour compresser les blocs en plages
+* largeur -> le nombre d'octets d'un indice de règle dans un bloc brut
+* tampons -> les indices des règles appliquées, TAILLE_TAMPON_TRACE par
+*            tampon
+* nb -> le nombre d'étapes rangées dans chaque tampon
+* pleins -> 1 pour un tampon confié au thread et pas encore écrit
+* courant -> le tampon rempli par la boucle d'exécution
+* donnees -> les données d'un bloc codé par le thread
+* verrou / signal -> protègent les tampons et réveillent les threads
+* thread -> le thread qui écrit les blocs
+* termine -> 1 lorsque le thread doit s'arrêter, une fois les tampons
+*            pleins écrits
+* erreur -> le code d'erreur (errno) de l'écriture d'un bloc qui a
+*           échoué, 0 sinon
+* attentes -> le nombre de fois où la boucle a attendu un tampon libre
+* nb_blocs / blocs_compresses -> le nombre de blocs écrits et de blocs
+*                                compressés en plages
+* octets -> le nombre d'octets écrits dans le fichier
+*/
+struct trace_binaire_s {
+  char *fichier;
+  FILE *f;
+  int compresser;
+  int largeur;
+  uint32_t *tampons[NB_TAMPONS_TRACE];
+  uint32_t nb[NB_TAMPONS_TRACE];
+  int pleins[NB_TAMPONS_TRACE];
+  int courant;
+  unsigned char *donnees;
+  pthread_mutex_t verrou;
+  pthread_cond_t signal;
+  pthread_t thread;
+  int termine;
+  int erreur;
+  long attentes;
+  long nb_blocs;
+  long blocs_compresses;
+  uint64_t octets;
+};
+
+/**
+* Ecrit un entier en taille variable
+* @return le nombre d'octets écrits
+*/
+static inline int ecrire_entier(unsigned char *p, uint32_t x) {
+  int n = 0;
+  while(x >= 0x80) {
+    p[n++] = (unsigned char) (x | 0x80);
+    x >>= 7;
+  }
+  p[n++] = (unsigned char) x;
+  return n;
+}
+
+/**
+* Lit un entier en taille variable
+* @return le nombre d'octets lus, 0 si l'entier dépasse la fin des
+*         données ou 32 bits
+*/
+static inline int lire_entier(const unsigned char *p, const unsigned char *fin,
+                              uint32_t *x) {
+  *x = 0;
+  for(int n = 0; n < MAX_OCTETS_ENTIER && p + n < fin; n++) {
+    *x |= (uint32_t) (p[n] & 0x7F) << (7 * n);
+    if(!(p[n] & 0x80)) return n + 1;
+  }
+  return 0;
+}
+
+/**
+* Code et écrit un bloc d'étapes : en plages si la trace est compressée
+* et que les plages sont plus courtes, sinon brut
+* @return 1 en cas de succès, 0 en cas d'erreur d'écriture
+*/
+static int ecrire_bloc(trace_binaire tb, const uint32_t *regles,
+                       uint32_t n) {
+  struct bloc_trace_s b = { CODAGE_BRUT, n, (uint64_t) n * tb->largeur };
+  unsigned char *p = tb->donnees;
+  if(tb->compresser) {
+    size_t taille = 0;
+    for(uint32_t i = 0; i < n && taille < b.taille;) {
+      uint32_t j = i + 1;
+      while(j < n && regles[j] == regles[i]) j++;
+      taille += ecrire_entier(p + taille, regles[i]);
+      taille += ecrire_entier(p + taille, j - i);
+      i = j;
+    }
+    if(taille < b.taille) {
+      b.codage = CODAGE_PLAGES;
+      b.taille = taille;
+      tb->blocs_compresses++;
+    }
+  }
+  if(b.codage == CODAGE_BRUT) {
+    if(tb->largeur == 1)
+      for(uint32_t i = 0; i < n; i++) p[i] = (uint8_t) regles[i];
+    else if(tb->largeur == 2)
+      for(uint32_t i = 0; i < n; i++) ((uint16_t*) p)[i] = (uint16_t) regles[i];
+    else
+      memcpy(p, regles, (size_t) n * sizeof(uint32_t));
+  }
+  tb->nb_blocs++;
+  tb->octets += sizeof(b) + b.taille;
+  return fwrite(&b, sizeof(b), 1, tb->f) == 1
+         && fwrite(p, 1, b.taille, tb->f) == b.taille;
+}
+
+/**
+* Fonction du thread de la trace : écrit les tampons pleins dans
+* l'ordre, jusqu'à l'arrêt de la trace
+*/
+static void* ecrivain(void *arg) {
+  trace_binaire tb = (trace_binaire) arg;
+  int prochain = 0;
+  pthread_mutex_lock(&tb->verrou);
+  for(;;) {
+    while(!tb->pleins[prochain] && !tb->termine)
+      pthread_cond_wait(&tb->signal, &tb->verrou);
+    if(!tb->pleins[prochain]) break;
+    // Le tampon n'est pas modifié tant qu'il est plein : il est écrit
+    // sans garder le verrou. Après une erreur, les tampons sont encore
+    // libérés pour ne pas bloquer l'exécution.
+    int erreur = tb->erreur;
+    pthread_mutex_unlock(&tb->verrou);
+    int ok = erreur || ecrire_bloc(tb, tb->tampons[prochain],
+                                   tb->nb[prochain]);
+    pthread_mutex_lock(&tb->verrou);
+    // errno est propre au thread : il est transmis par la trace
+    if(!ok) tb->erreur = errno ? errno : EIO;
+    tb->pleins[prochain] = 0;
+    prochain = (prochain + 1) % NB_TAMPONS_TRACE;
+    pthread_cond_broadcast(&tb->signal);
+  }
+  pthread_mutex_unlock(&tb->verrou);
+  return NULL;
+}
+
+/**
+* Ecrit l'entête d'une trace, la table de la machine et le ruban de
+* départ
+* @return 1 en cas de succès, 0 en cas d'erreur d'écriture
+*/
+static int ecrire_entete(trace_binaire tb, configuration c) {
+  table_transitions t = c->mt->table;
+  ruban r = c->ruban_courant;
+  struct entete_trace_s e;
+  memset(&e, 0, sizeof(e));
+  memcpy(e.magie, MAGIE_TRACE_BINAIRE, sizeof(e.magie));
+  e.version = VERSION_TRACE_BINAIRE;
+  e.ordre_octets = 0x01020304;
+  e.nb_etats = t->nb_etats;
+  e.nb_regles = t->nb_regles;
+  e.etat_depart = c->etat_courant;
+  e.etat_fin = t->etat_fin;
+  // Les noms sont rangés dans l'ordre des identifiants
+  const char *dernier = table_nom_etat(t, t->nb_etats - 1);
+  e.taille_noms = t->offsets_noms[t->nb_etats - 1] + strlen(dernier) + 1;
+  e.symbole_blanc = r->symbole_blanc;
+  e.largeur = tb->largeur;
+  e.tete = c->tete_lecture;
+  e.etape_depart = c->nb_etapes;
+  e.min = r->min;
+  e.max = r->max;
+  int ok = fwrite(&e, sizeof(e), 1, tb->f) == 1
+    && fwrite(t->offsets_noms, sizeof(uint32_t), t->nb_etats, tb->f)
+       == (size_t) t->nb_etats
+    && fwrite(t->noms, 1, e.taille_noms, tb->f) == e.taille_noms;
+  for(int i = 0; ok && i < t->nb_regles; i++) {
+    struct regle_trace_s rt = { t->regles[i].nouvel_etat,
+                                t->regles[i].symbole_ecrit,
+                                t->regles[i].deplacement, { 0, 0 } };
+    ok = fwrite(&rt, sizeof(rt), 1, tb->f) == 1;
+  }
+  long n = r->max - r->min + 1;
+  ok = ok && fwrite(ruban_case(r, r->min), 1, n, tb->f) == (size_t) n;
+  tb->octets = ftell(tb->f);
+  return ok;
+}
+
+/**
+* Libère une trace dont le thread n'a pas été démarré ou a été arrêté
+*/
+static void liberer_trace_binaire(trace_binaire tb) {
+  for(int i = 0; i < NB_TAMPONS_TRACE; i++) free(tb->tampons[i]);
+  free(tb->donnees);
+  free(tb->fichier);
+  free(tb);
+}
+
+trace_binaire init_trace_binaire(const char *fichier, configuration c,
+                                 int compresser) {
+  trace_binaire tb = (trace_binaire) calloc(1,
+                                            sizeof(struct trace_binaire_s));
+  if(!tb) {
+    perror("Erreur d'allocation de la mémoire de la trace.\n");
+    return NULL;
+  }
+  int nb_regles = c->mt->table->nb_regles;
+  tb->largeur = nb_regles <= 256 ? 1 : nb_regles <= 65536 ? 2 : 4;
+  tb->compresser = compresser;
+  tb->fichier = strdup(fichier);
+  // Des plages d'une étape coûtent au plus 2 entiers par étape
+  size_t taille_donnees = (size_t) TAILLE_TAMPON_TRACE
+                          * (compresser ? 2 * MAX_OCTETS_ENTIER : 4);
+  tb->donnees = (unsigned char*) malloc(taille_donnees);
+  int ok = tb->fichier && tb->donnees;
+  for(int i = 0; ok && i < NB_TAMPONS_TRACE; i++)
+    ok = (tb->tampons[i] = (uint32_t*) malloc(sizeof(uint32_t)
+                                              * TAILLE_TAMPON_TRACE)) != NULL;
+  if(!ok) {
+    perror("Erreur d'allocation de la mémoire de la trace.\n");
+    liberer_trace_binaire(tb);
+    return NULL;
+  }
+  if(!(tb->f = fopen(fichier, "wb")) || !ecrire_entete(tb, c)) {
+    fprintf(stderr, "\n[ERR]: Echec de l'écriture de la trace %s",
+            fichier);
+    perror("\n\n");
+    if(tb->f) fclose(tb->f);
+    liberer_trace_binaire(tb);
+    return NULL;
+  }
+  pthread_mutex_init(&tb->verrou, NULL);
+  pthread_cond_init(&tb->signal, NULL);
+  if(pthread_create(&tb->thread, NULL, ecrivain, tb)) {
+    fprintf(stderr, "\n[ERR]: Echec de la création du thread de la "
+            "trace\n\n");
+    pthread_mutex_destroy(&tb->verrou);
+    pthread_cond_destroy(&tb->signal);
+    fclose(tb->f);
+    liberer_trace_binaire(tb);
+    return NULL;
+  }
+  return tb;
+}
+
+/**
+* Confie le tampon courant au thread de la trace et passe au tampon
+* suivant, en attendant qu'il soit écrit s'il est encore plein
+*/
+static void changer_tampon(trace_binaire tb) {
+  pthread_mutex_lock(&tb->verrou);
+  tb->pleins[tb->courant] = 1;
+  pthread_cond_broadcast(&tb->signal);
+  tb->courant = (tb->courant + 1) % NB_TAMPONS_TRACE;
+  if(tb->pleins[tb->courant]) tb->attentes++;
+  while(tb->pleins[tb->courant]) pthread_cond_wait(&tb->signal, &tb->verrou);
+  tb->nb[tb->courant] = 0;
+  pthread_mutex_unlock(&tb->verrou);
+}
+
+int executer_trace_binaire(configuration c, limites l, trace_binaire tb) {
+  table_transitions table = c->mt->table;
+  ruban r = c->ruban_courant;
+  int etat = c->etat_courant, fin = table->etat_fin, delai = 0;
+  long tete = c->tete_lecture, n = c->nb_etapes;
+  long limite = l && l->max_etapes > 0 ? l->max_etapes : LONG_MAX;
+  double debut = horloge_secondes();
+  uint32_t *tampon = tb->tampons[tb->courant];
+  uint32_t k = tb->nb[tb->courant];
+
+  // Même calcul que simuler_etape, l'indice de chaque règle appliquée
+  // étant rangé dans le tampon ; l'horloge est consultée à chaque
+  // changement de tampon
+  while(etat != fin && n < limite) {
+    if(k == TAILLE_TAMPON_TRACE) {
+      tb->nb[tb->courant] = k;
+      changer_tampon(tb);
+      tampon = tb->tampons[tb->courant];
+      k = 0;
+      if((delai = delai_depasse(l, debut))) break;
+    }
+    cellule *s = ruban_case(r, tete);
+    int32_t i = table_chercher(table, etat, *s);
+    if(i < 0) break;
+    regle rg = &table->regles[i];
+    tampon[k++] = (uint32_t) i;
+    etat = rg->nouvel_etat;
+    *s = rg->symbole_ecrit;
+    n++;
+    if(!ruban_deplacer(r, &tete, rg->deplacement)) break;
+  }
+  tb->nb[tb->courant] = k;
+
+  c->etat_courant = etat;
+  c->tete_lecture = tete;
+  c->nb_etapes = n;
+  return resultat_configuration(c, delai || n >= limite);
+}
+
+int fermer_trace_binaire(trace_binaire tb, configuration c, int resultat,
+                         FILE *statistiques) {
+  // Le dernier tampon, même partiel, est écrit avant l'arrêt du thread
+  pthread_mutex_lock(&tb->verrou);
+  if(tb->nb[tb->courant]) tb->pleins[tb->courant] = 1;
+  tb->termine = 1;
+  pthread_cond_broadcast(&tb->signal);
+  pthread_mutex_unlock(&tb->verrou);
+  pthread_join(tb->thread, NULL);
+
+  struct bloc_trace_s b = { CODAGE_BRUT, 0, 0 };
+  struct fin_trace_s f = { resultat, 0, c->nb_etapes };
+  int ok = !tb->erreur && fwrite(&b, sizeof(b), 1, tb->f) == 1
+           && fwrite(&f, sizeof(f), 1, tb->f) == 1;
+  ok = fclose(tb->f) == 0 && ok;
+  if(tb->erreur) errno = tb->erreur;
+  tb->octets += sizeof(b) + sizeof(f);
+  if(!ok) {
+    fprintf(stderr, "\n[ERR]: Echec de l'écriture de la trace %s",
+            tb->fichier);
+    perror("\n\n");
+  } else if(statistiques) {
+    fprintf(statistiques, "[TRACE]: %ld étapes dans %s : %lu octets, %ld "
+            "blocs dont %ld compressés, %ld attentes de l'écriture\n",
+            c->nb_etapes, tb->fichier, (unsigned long) tb->octets,
+            tb->nb_blocs, tb->blocs_compresses, tb->attentes);
+  }
+  pthread_mutex_destroy(&tb->verrou);
+  pthread_cond_destroy(&tb->signal);
+  liberer_trace_binaire(tb);
+  return ok;
+}
+
+/**
+* Données d'une trace binaire relues par le décodeur
+*/
+struct lecture_trace_s {
+  struct entete_trace_s e;
+  uint32_t *offsets;
+  char *noms;
+  struct regle_trace_s *regles;
+  unsigned char *donnees;
+  uint32_t *indices;
+};
+
+/**
+* Lit l'entête d'une trace et construit le ruban de départ
+* @return le message d'erreur, NULL en cas de succès
+*/
+static const char* lire_entete(FILE *f, struct lecture_trace_s *lt,
+                               ruban *r) {
+  struct entete_trace_s *e = &lt->e;
+  if(fread(e, sizeof(*e), 1, f) != 1
+     || memcmp(e->magie, MAGIE_TRACE_BINAIRE, sizeof(e->magie)))
+    return "n'est pas une trace binaire";
+  if(e->version != VERSION_TRACE_BINAIRE || e->ordre_octets != 0x01020304)
+    return "a été écrite par une autre version du simulateur";
+  if(e->nb_etats <= 0 || e->nb_regles < 0 || e->etat_depart < 0
+     || e->etat_depart >= e->nb_etats || e->taille_noms == 0
+     || (e->largeur != 1 && e->largeur != 2 && e->largeur != 4)
+     || e->min > e->max || e->tete < e->min || e->tete > e->max
+     || e->symbole_blanc > 255)
+    return "est incohérente";
+  lt->offsets = (uint32_t*) malloc(sizeof(uint32_t) * e->nb_etats);
+  lt->noms = (char*) malloc(e->taille_noms);
+  lt->regles = (struct regle_trace_s*) malloc(sizeof(struct regle_trace_s)
+                                              * (e->nb_regles + 1));
+  if(!lt->offsets || !lt->noms || !lt->regles
+     || !(*r = init_ruban("", (char) e->symbole_blanc))
+     || !ruban_etendre(*r, e->min) || !ruban_etendre(*r, e->max))
+    return "ne tient pas en mémoire";
+  long n = e->max - e->min + 1;
+  if(fread(lt->offsets, sizeof(uint32_t), e->nb_etats, f)
+       != (size_t) e->nb_etats
+     || fread(lt->noms, 1, e->taille_noms, f) != e->taille_noms
+     || fread(lt->regles, sizeof(struct regle_trace_s), e->nb_regles, f)
+       != (size_t) e->nb_regles
+     || fread(ruban_case(*r, e->min), 1, n, f) != (size_t) n)
+    return "est tronquée";
+  lt->noms[e->taille_noms - 1] = '\0';
+  for(int i = 0; i < e->nb_etats; i++)
+    if(lt->offsets[i] >= e->taille_noms) return "est incohérente";
+  for(int i = 0; i < e->nb_regles; i++)
+    if(lt->regles[i].nouvel_etat < 0
+       || lt->regles[i].nouvel_etat >= e->nb_etats
+       || lt->regles[i].deplacement < -1 || lt->regles[i].deplacement > 1)
+      return "est incohérente";
+  (*r)->min = e->min;
+  (*r)->max = e->max;
+  return NULL;
+}
+
+/**
+* Décode les données d'un bloc en indices de règles
+* @return 1 en cas de succès, 0 si le bloc est invalide
+*/
+static int decoder_bloc(struct lecture_trace_s *lt, struct bloc_trace_s *b) {
+  const unsigned char *p = lt->donnees, *fin = p + b->taille;
+  uint32_t *indices = lt->indices;
+  if(b->codage == CODAGE_BRUT) {
+    if(b->taille != (uint64_t) b->nb_etapes * lt->e.largeur) return 0;
+    for(uint32_t i = 0; i < b->nb_etapes; i++)
+      indices[i] = lt->e.largeur == 1 ? p[i]
+                   : lt->e.largeur == 2 ? ((const uint16_t*) p)[i]
+                   : ((const uint32_t*) p)[i];
+  } else if(b->codage == CODAGE_PLAGES) {
+    uint32_t k = 0, indice, longueur;
+    int lus;
+    while(p < fin) {
+      if(!(lus = lire_entier(p, fin, &indice))) return 0;
+      p += lus;
+      if(!(lus = lire_entier(p, fin, &longueur)) || longueur == 0
+         || longueur > b->nb_etapes - k)
+        return 0;
+      p += lus;
+      while(longueur--) indices[k++] = indice;
+    }
+    if(k != b->nb_etapes) return 0;
+  } else {
+    return 0;
+  }
+  for(uint32_t i = 0; i < b->nb_etapes; i++)
+    if(indices[i] >= (uint32_t) lt->e.nb_regles) return 0;
+  return 1;
+}
+
+int decoder_trace_binaire(const char *fichier, trace t, long debut,
+                          long fin) {
+  FILE *f = fopen(fichier, "rb");
+  if(!f) {
+    fprintf(stderr, "\n[ERR]: Echec de l'ouverture de la trace %s",
+            fichier);
+    perror("\n\n");
+    return 0;
+  }
+  struct lecture_trace_s lt;
+  memset(&lt, 0, sizeof(lt));
+  ruban r = NULL;
+  const char *erreur = lire_entete(f, &lt, &r);
+  lt.donnees = (unsigned char*) malloc((size_t) TAILLE_TAMPON_TRACE
+                                       * 2 * MAX_OCTETS_ENTIER);
+  lt.indices = (uint32_t*) malloc(sizeof(uint32_t) * TAILLE_TAMPON_TRACE);
+  if(!erreur && (!lt.donnees || !lt.indices))
+    erreur = "ne tient pas en mémoire";
+
+  int etat = lt.e.etat_depart, complete = 0;
+  long tete = lt.e.tete, n = lt.e.etape_depart;
+  struct fin_trace_s fin_trace = { 0, 0, 0 };
+  // Affichage de la configuration atteinte à l'étape n si elle est
+  // demandée
+  #define AFFICHER_SI_DEMANDE() \
+    if(debut >= 0 && n >= debut && n <= fin \
+       && (t->niveau != TRACE_PERIODIQUE || n % t->periode == 0)) \
+      trace_afficher(t, lt.noms + lt.offsets[etat], r, tete, n)
+  if(!erreur) AFFICHER_SI_DEMANDE();
+  // Le bloc qui suit l'étape fin est lu pour savoir si elle est la
+  // dernière de l'exécution
+  while(!erreur && (debut < 0 || n <= fin)) {
+    struct bloc_trace_s b;
+    if(fread(&b, sizeof(b), 1, f) != 1) break;
+    if(b.nb_etapes == 0) {
+      complete = fread(&fin_trace, sizeof(fin_trace), 1, f) == 1;
+      break;
+    }
+    if(b.nb_etapes > TAILLE_TAMPON_TRACE
+       || b.taille > (uint64_t) TAILLE_TAMPON_TRACE * 2 * MAX_OCTETS_ENTIER)
+      erreur = "est incohérente";
+    else if(fread(lt.donnees, 1, b.taille, f) != b.taille)
+      break;
+    else if(!decoder_bloc(&lt, &b))
+      erreur = "est incohérente";
+    for(uint32_t i = 0; !erreur && i < b.nb_etapes; i++) {
+      struct regle_trace_s *rt = &lt.regles[lt.indices[i]];
+      *ruban_case(r, tete) = rt->symbole_ecrit;
+      etat = rt->nouvel_etat;
+      n++;
+      if(!ruban_deplacer(r, &tete, rt->deplacement))
+        erreur = "ne tient pas en mémoire";
+      if(debut >= 0 && n > fin) break;
+      AFFICHER_SI_DEMANDE();
+    }
+  }
+  #undef AFFICHER_SI_DEMANDE
+  fclose(f);
+
+  if(!erreur) {
+    // La configuration finale est affichée même hors de la période
+    if(debut < 0 || (complete && n >= debut && n <= fin 
+                     && t->niveau == TRACE_PERIODIQUE && n % t->periode))
+      trace_afficher(t, lt.noms + lt.offsets[etat], r, tete, n);
+    if(complete)
+      fprintf(stderr, "[TRACE]: %s : %d états, %d règles, étapes %ld à "
+              "%ld, %s\n", fichier, lt.e.nb_etats, lt.e.nb_regles,
+              (long) lt.e.etape_depart, (long) fin_trace.nb_etapes,
+              libelle_resultat(fin_trace.resultat));
+    else if(debut < 0 || n <= fin)
+      fprintf(stderr, "[TRACE]: %s est interrompue : décodée jusqu'à "
+              "l'étape %ld\n", fichier, n);
+  } else {
+    fprintf(stderr, "\n[ERR]: La trace %s %s\n\n", fichier, erreur);
+  }
+  if(r) free_ruban(r);
+  free(lt.offsets);
+  free(lt.noms);
+  free(lt.regles);
+  free(lt.donnees);
+  free(lt.indices);
+  return !erreur;
+}
@@ -0,0 +1,169 @@
+#ifndef _trace_binaire_h_
+#define _trace_binaire_h_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "machineturing.h"
+
+/**
+* Format des traces binaires : une entête (struct entete_trace_s), les
+* positions des noms des états dans le bloc des noms (nb_etats entiers
+* de 32 bits), le bloc des noms (taille_noms octets, chaque nom terminé
+* par '\0'), les règles de la table (struct regle_trace_s, dans l'ordre
+* de la table), les cases visitées du ruban de départ (positions min à
+* max), puis les blocs d'étapes. Chaque étape est enregistrée par
+* l'indice de la règle appliquée, qui donne le nouvel état, le symbole
+* écrit et le déplacement de la tête. Un bloc (struct bloc_trace_s) est
+* suivi de ses données, soit brutes (indices sur 'largeur' octets), soit
+* compressées en plages d'une même règle (indice puis longueur, en
+* entiers de taille variable : 7 bits par octet, poids faibles en tête).
+* La trace se termine par un bloc vide suivi de struct fin_trace_s ; une
+* trace interrompue reste lisible jusqu'à son dernier bloc complet.
+*/
+
+// Début de tout fichier de trace binaire
+#define MAGIE_TRACE_BINAIRE "MTTRC\r\n\032"
+// Version du format, à incrémenter à chaque changement de structure
+#define VERSION_TRACE_BINAIRE 1
+
+/**
+* Codage des données d'un bloc
+* CODAGE_BRUT -> un indice de règle par étape, sur 'largeur' octets
+* CODAGE_PLAGES -> des plages (indice, longueur) d'une même règle
+*/
+enum codage_bloc {
+  CODAGE_BRUT,
+  CODAGE_PLAGES
+};
+
+/**
+* Entête d'une trace binaire.
+* magie -> MAGIE_TRACE_BINAIRE
+* version -> VERSION_TRACE_BINAIRE
+* ordre_octets -> 0x01020304 écrit dans l'ordre des octets de la machine
+*                 qui a écrit la trace
+* nb_etats / nb_regles -> les tailles de la table de la machine
+* etat_depart -> l'identifiant de l'état au début de la trace
+* etat_fin -> l'identifiant de l'état final
+* taille_noms -> la taille du bloc des noms des états
+* symbole_blanc -> le symbole blanc du ruban
+* largeur -> le nombre d'octets d'un indice de règle (1, 2 ou 4)
+* tete -> la position de la tête au début de la trace
+* etape_depart -> le nombre d'étapes au début de la trace
+* min / max -> les positions extrêmes visitées du ruban de départ
+*/
+struct entete_trace_s {
+  char magie[8];
+  uint32_t version;
+  uint32_t ordre_octets;
+  int32_t nb_etats;
+  int32_t nb_regles;
+  int32_t etat_depart;
+  int32_t etat_fin;
+  uint32_t taille_noms;
+  uint32_t symbole_blanc;
+  uint32_t largeur;
+  uint32_t reserve;
+  int64_t tete;
+  int64_t etape_depart;
+  int64_t min;
+  int64_t max;
+};
+
+/**
+* Règle d'une trace : l'effet d'une étape
+*/
+struct regle_trace_s {
+  int32_t nouvel_etat;
+  uint8_t symbole_ecrit;
+  int8_t deplacement;
+  uint8_t reserve[2];
+};
+
+/**
+* Entête d'un bloc d'étapes
+* codage -> le codage des données (enum codage_bloc)
+* nb_etapes -> le nombre d'étapes du bloc, 0 pour le bloc de fin
+* taille -> le nombre d'octets des données qui suivent
+*/
+struct bloc_trace_s {
+  uint32_t codage;
+  uint32_t nb_etapes;
+  uint64_t taille;
+};
+
+/**
+* Fin d'une trace : le résultat (enum resultat) et le nombre d'étapes de
+* l'exécution
+*/
+struct fin_trace_s {
+  int32_t resultat;
+  int32_t reserve;
+  int64_t nb_etapes;
+};
+
+/**
+* Trace binaire en cours d'écriture : les étapes sont rangées dans des
+* tampons, écrits par un thread dédié (structure définie dans
+* trace_binaire.c)
+*/
+typedef struct trace_binaire_s* trace_binaire;
+
+/**
+* Crée une trace binaire, écrit son entête (table de la machine et ruban
+* de départ) et démarre le thread qui écrit les blocs
+* @param fichier : le fichier de la trace
+* @param c : la configuration de départ
+* @param compresser : 1 pour compresser les blocs en plages (un bloc
+*                     n'est compressé que s'il y gagne), 0 sinon
+* @return la trace, NULL en cas d'erreur
+*/
+trace_binaire init_trace_binaire(const char *fichier, configuration c,
+                                 int compresser);
+
+/**
+* Exécute une machine comme executer() (sans détection des cycles) en
+* inscrivant chaque étape dans une trace binaire. La boucle ne fait
+* que ranger l'indice de la règle appliquée dans le tampon courant ; un
+* tampon plein est confié au thread de la trace et la boucle ne
+* s'arrête que si tous les tampons attendent d'être écrits.
+* @param c : la configuration de départ, mise à jour
+* @param l : les limites de l'exécution (étapes et durée), NULL pour ne
+*            pas limiter
+* @param tb : la trace
+* @return le résultat de l'exécution (enum resultat)
+*/
+int executer_trace_binaire(configuration c, limites l, trace_binaire tb);
+
+/**
+* Ecrit les dernières étapes et la fin d'une trace, arrête son thread et
+* libère la mémoire allouée
+* @param tb : la trace
+* @param c : la configuration finale
+* @param resultat : le résultat de l'exécution
+* @param statistiques : flux où afficher la taille de la trace et le
+*                       nombre d'attentes de la boucle, NULL pour ne rien
+*                       afficher
+* @return 1 si la trace a été entièrement écrite, 0 sinon
+*/
+int fermer_trace_binaire(trace_binaire tb, configuration c, int resultat,
+                         FILE *statistiques);
+
+/**
+* Reconstruit les configurations d'une exécution à partir de sa trace
+* binaire et les affiche avec une trace texte : la configuration de
+* chaque étape de debut à fin (toutes les t->periode étapes en mode
+* périodique), ou seulement la configuration finale si debut est
+* négatif. Le résumé de la trace (états, étapes, résultat) est ensuite
+* affiché sur la sortie d'erreur.
+* @param fichier : le fichier de la trace
+* @param t : la trace texte (fenêtre et période d'affichage)
+* @param debut / fin : les étapes à afficher
+* @return 1 en cas de succès, 0 si la trace est invalide ou illisible
+*/
+int decoder_trace_binaire(const char *fichier, trace t, long debut,
+                          long fin);
+
+
+#endif